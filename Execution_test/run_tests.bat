@@ -29,14 +29,14 @@ if exist *.o del *.o
 if exist image_processing.exe del image_processing.exe
 if exist test_images.exe del test_images.exe
 
-gcc -o image_processing main.c bmp8.c bmp24.c filters.c -lm -Wall -Wextra -std=c99
+gcc -o image_processing main.c bmp8.c bmp24.c filters.c bmpview.c bmpstream.c convolution.c integral.c threadpool.c lut.c pipeline.c batch.c instrument.c clahe.c context.c planar.c lazy.c simd.c -lm -Wall -Wextra -std=c99
 if errorlevel 1 (
     echo Erreur : La compilation du programme principal a echoue
     pause
     exit /b 1
 )
 
-gcc -o test_images test.c bmp8.c bmp24.c filters.c -lm -Wall -Wextra -std=c99
+gcc -o test_images test.c bmp8.c bmp24.c filters.c bmpview.c bmpstream.c convolution.c integral.c threadpool.c lut.c pipeline.c batch.c instrument.c clahe.c context.c planar.c lazy.c simd.c -lm -Wall -Wextra -std=c99
 if errorlevel 1 (
     echo Erreur : La compilation du programme de test a echoue
     pause
@@ -0,0 +1,390 @@
+/**
+ * @file batch.c
+ * @author Projet TI202
+ * @brief Implémentation du traitement d'un lot d'images en pipeline
+ * @date 2025
+ */
+
+#ifndef _WIN32
+    #define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "batch.h"
+#include "instrument.h"
+#include <time.h>
+
+#ifndef _WIN32
+    #include <pthread.h>
+#endif
+
+// Une image en cours de traitement
+typedef struct {
+    const char* input;
+    const char* output;
+    int depth;
+    t_bmp8* img8;
+    t_bmp24* img24;
+    int status;      // Résultat du calcul : 0, ou -1 si l'image ne doit pas être écrite
+} t_batchItem;
+
+/**
+ * @brief Horloge en secondes
+ */
+static double batch_now(void) {
+#ifndef _WIN32
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#else
+    return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+/**
+ * @brief Charge une image du lot
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+static int batch_load(t_batchItem* item) {
+    item->depth = pipeline_readColorDepth(item->input);
+    if (item->depth == 8) {
+        item->img8 = bmp8_loadImage(item->input);
+        return item->img8 ? 0 : -1;
+    }
+    if (item->depth == 24) {
+        item->img24 = bmp24_loadImage(item->input);
+        return item->img24 ? 0 : -1;
+    }
+    if (item->depth > 0) {
+        printf("Erreur: Profondeur de couleur non supportée (%d bits) pour %s\n", item->depth, item->input);
+    }
+    return -1;
+}
+
+/**
+ * @brief Applique la chaîne d'opérations à une image chargée
+ */
+static void batch_process(const t_pipeline* pipeline, t_batchItem* item) {
+    item->status = pipeline_apply(pipeline, &item->img8, &item->img24);
+}
+
+/**
+ * @brief Sauvegarde puis libère une image
+ * @param bytes Reçoit la taille des pixels de l'image en octets si elle a été écrite
+ * @return 0 en cas de succès, -1 si l'écriture a échoué
+ */
+static int batch_save(t_batchItem* item, double* bytes) {
+    int status = -1;
+    if (item->img8) {
+        *bytes = item->img8->dataSize;
+        status = bmp8_saveImage(item->output, item->img8);
+        bmp8_free(item->img8);
+    }
+    if (item->img24) {
+        *bytes = (double)item->img24->width * item->img24->height * 3;
+        status = bmp24_saveImage(item->img24, item->output);
+        bmp24_free(item->img24);
+    }
+    item->img8 = NULL;
+    item->img24 = NULL;
+    return status;
+}
+
+/**
+ * @brief Écrit une image traitée et met à jour les compteurs du lot
+ */
+static void batch_finish(t_batchItem* item, int* saved, int* failed, int* writeFailed, double* bytes) {
+    if (item->status != 0) {
+        // Le calcul a échoué : l'image n'est pas écrite
+        printf("Erreur : Échec du traitement de %s\n", item->input);
+        bmp8_free(item->img8);
+        bmp24_free(item->img24);
+        item->img8 = NULL;
+        item->img24 = NULL;
+        (*failed)++;
+        return;
+    }
+
+    double size = 0;
+    if (batch_save(item, &size) == 0) {
+        *bytes += size;
+        (*saved)++;
+    } else {
+        printf("Erreur : Échec de l'écriture de %s\n", item->output);
+        (*writeFailed)++;
+    }
+}
+
+#ifndef _WIN32
+
+// File bornée d'images entre deux étapes
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t notEmpty;
+    pthread_cond_t notFull;
+    t_batchItem* items[BATCH_QUEUE_SIZE];
+    int head;
+    int count;
+    int producers;   // Étapes qui alimentent encore la file
+} t_batchQueue;
+
+/**
+ * @brief Initialise une file vide
+ */
+static void queue_init(t_batchQueue* queue, int producers) {
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->notEmpty, NULL);
+    pthread_cond_init(&queue->notFull, NULL);
+    queue->head = 0;
+    queue->count = 0;
+    queue->producers = producers;
+}
+
+/**
+ * @brief Détruit une file
+ */
+static void queue_destroy(t_batchQueue* queue) {
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->notEmpty);
+    pthread_cond_destroy(&queue->notFull);
+}
+
+/**
+ * @brief Ajoute une image, en attendant une place libre
+ */
+static void queue_push(t_batchQueue* queue, t_batchItem* item) {
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == BATCH_QUEUE_SIZE) {
+        pthread_cond_wait(&queue->notFull, &queue->lock);
+    }
+    queue->items[(queue->head + queue->count) % BATCH_QUEUE_SIZE] = item;
+    queue->count++;
+    pthread_cond_signal(&queue->notEmpty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+/**
+ * @brief Retire une image, en attendant qu'il y en ait une
+ * @return Image, NULL si la file est vide et n'est plus alimentée
+ */
+static t_batchItem* queue_pop(t_batchQueue* queue) {
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0 && queue->producers > 0) {
+        pthread_cond_wait(&queue->notEmpty, &queue->lock);
+    }
+
+    t_batchItem* item = NULL;
+    if (queue->count > 0) {
+        item = queue->items[queue->head];
+        queue->head = (queue->head + 1) % BATCH_QUEUE_SIZE;
+        queue->count--;
+        pthread_cond_signal(&queue->notFull);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return item;
+}
+
+/**
+ * @brief Signale qu'une étape n'alimentera plus la file
+ */
+static void queue_close(t_batchQueue* queue) {
+    pthread_mutex_lock(&queue->lock);
+    queue->producers--;
+    pthread_cond_broadcast(&queue->notEmpty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+// État partagé par les threads d'un lot
+typedef struct {
+    const t_pipeline* pipeline;
+    t_batchItem* items;
+    int count;
+    t_batchQueue loaded;     // Lecture -> calcul
+    t_batchQueue processed;  // Calcul -> écriture
+    int failed;              // Modifié par le thread de lecture uniquement
+    int saved;               // Modifiés par le thread d'écriture uniquement
+    int processFailed;
+    int writeFailed;
+    double bytes;
+} t_batchState;
+
+/**
+ * @brief Thread de lecture : charge les images dans l'ordre du lot
+ */
+static void* batch_reader(void* arg) {
+    t_batchState* state = (t_batchState*)arg;
+    for (int i = 0; i < state->count; i++) {
+        if (batch_load(&state->items[i]) == 0) {
+            queue_push(&state->loaded, &state->items[i]);
+        } else {
+            printf("Erreur : Échec du traitement de %s\n", state->items[i].input);
+            state->failed++;
+        }
+    }
+    queue_close(&state->loaded);
+    return NULL;
+}
+
+/**
+ * @brief Thread de calcul : applique la chaîne aux images chargées
+ */
+static void* batch_worker(void* arg) {
+    t_batchState* state = (t_batchState*)arg;
+    t_batchItem* item;
+    while ((item = queue_pop(&state->loaded)) != NULL) {
+        batch_process(state->pipeline, item);
+        queue_push(&state->processed, item);
+    }
+    queue_close(&state->processed);
+    return NULL;
+}
+
+/**
+ * @brief Étape d'écriture (thread appelant) : sauvegarde les images traitées
+ */
+static void* batch_writer(void* arg) {
+    t_batchState* state = (t_batchState*)arg;
+    t_batchItem* item;
+    while ((item = queue_pop(&state->processed)) != NULL) {
+        batch_finish(item, &state->saved, &state->processFailed, &state->writeFailed, &state->bytes);
+    }
+    return NULL;
+}
+
+#endif
+
+/**
+ * @brief Traite un lot d'images en pipeline
+ *
+ * Les calculs d'une image peuvent eux-mêmes utiliser le pool de threads
+ * (threadpool.h) ; plusieurs threads de calcul permettent en plus de
+ * traiter plusieurs images à la fois.
+ *
+ * @param pipeline Chaîne d'opérations préparée
+ * @param inputs Fichiers sources
+ * @param outputs Fichiers destination (même ordre que inputs)
+ * @param count Nombre d'images
+ * @param workers Nombre de threads de calcul (0 pour BATCH_DEFAULT_WORKERS)
+ * @param stats Bilan du lot (peut être NULL)
+ * @return Nombre d'images en échec, -1 en cas d'erreur
+ */
+int batch_run(const t_pipeline* pipeline, const char** inputs, const char** outputs, int count,
+              int workers, t_batchStats* stats) {
+    if (!pipeline || !inputs || !outputs || count <= 0) return -1;
+    if (workers <= 0) workers = BATCH_DEFAULT_WORKERS;
+
+    INSTRUMENT_BEGIN("batch_run");
+
+    t_batchItem* items = (t_batchItem*)calloc(count, sizeof(t_batchItem));
+    if (!items) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        INSTRUMENT_END();
+        return -1;
+    }
+    for (int i = 0; i < count; i++) {
+        items[i].input = inputs[i];
+        items[i].output = outputs[i];
+    }
+
+    double start = batch_now();
+    int failed = 0, saved = 0, writeFailed = 0;
+    double bytes = 0;
+
+#ifndef _WIN32
+    pthread_t* threads = (pthread_t*)malloc((workers + 1) * sizeof(pthread_t));
+    if (!threads) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        free(items);
+        INSTRUMENT_END();
+        return -1;
+    }
+
+    t_batchState state;
+    state.pipeline = pipeline;
+    state.items = items;
+    state.count = count;
+    state.failed = 0;
+    state.saved = 0;
+    state.processFailed = 0;
+    state.writeFailed = 0;
+    state.bytes = 0;
+    queue_init(&state.loaded, 1);
+    queue_init(&state.processed, workers);
+
+    // Threads de calcul : un thread non créé n'alimentera pas la file d'écriture
+    int started = 0;
+    for (int i = 0; i < workers; i++) {
+        if (pthread_create(&threads[started], NULL, batch_worker, &state) == 0) {
+            started++;
+        } else {
+            queue_close(&state.processed);
+        }
+    }
+
+    // Thread de lecture, puis écriture dans le thread appelant
+    int status = 0;
+    if (started > 0 && pthread_create(&threads[started], NULL, batch_reader, &state) == 0) {
+        started++;
+    } else {
+        printf("Erreur: Création de thread échouée\n");
+        queue_close(&state.loaded);
+        status = -1;
+    }
+    batch_writer(&state);
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    queue_destroy(&state.loaded);
+    queue_destroy(&state.processed);
+    free(threads);
+    if (status != 0) {
+        free(items);
+        INSTRUMENT_END();
+        return -1;
+    }
+
+    failed = state.failed + state.processFailed;
+    saved = state.saved;
+    writeFailed = state.writeFailed;
+    bytes = state.bytes;
+#else
+    // Sans pthread : les étapes s'enchaînent image par image
+    for (int i = 0; i < count; i++) {
+        if (batch_load(&items[i]) != 0) {
+            printf("Erreur : Échec du traitement de %s\n", items[i].input);
+            failed++;
+            continue;
+        }
+        batch_process(pipeline, &items[i]);
+        batch_finish(&items[i], &saved, &failed, &writeFailed, &bytes);
+    }
+#endif
+
+    double seconds = batch_now() - start;
+    free(items);
+
+    if (stats) {
+        stats->processed = saved;
+        stats->failed = failed + writeFailed;
+        stats->writeFailed = writeFailed;
+        stats->seconds = seconds;
+        stats->imagesPerSecond = seconds > 0 ? saved / seconds : 0;
+        stats->megabytes = bytes / (1024.0 * 1024.0);
+    }
+    INSTRUMENT_END();
+    return failed + writeFailed;
+}
+
+/**
+ * @brief Affiche le bilan d'un lot
+ * @param stats Bilan renvoyé par batch_run
+ */
+void batch_printStats(const t_batchStats* stats) {
+    if (!stats) return;
+
+    printf("%d image(s) traitée(s), %d échec(s) (dont %d à l'écriture) en %.2f s\n", stats->processed,
+           stats->failed, stats->writeFailed, stats->seconds);
+    printf("Débit : %.2f images/s, %.1f Mo/s\n", stats->imagesPerSecond,
+           stats->seconds > 0 ? stats->megabytes / stats->seconds : 0.0);
+}
@@ -0,0 +1,37 @@
+/**
+ * @file batch.h
+ * @author Projet TI202
+ * @brief Traitement d'un lot d'images en pipeline : lecture, calcul et écriture en parallèle
+ * @date 2025
+ *
+ * Un thread de lecture charge les images à l'avance, des threads de calcul
+ * leur appliquent la chaîne d'opérations et le thread appelant sauvegarde
+ * les résultats. Les étapes communiquent par des files bornées : le nombre
+ * d'images en mémoire reste limité et le disque travaille pendant les
+ * calculs.
+ */
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include "pipeline.h"
+
+// Valeurs par défaut
+#define BATCH_DEFAULT_WORKERS 2
+#define BATCH_QUEUE_SIZE 4
+
+// Bilan d'un lot
+typedef struct {
+    int processed;           // Images traitées et écrites avec succès
+    int failed;              // Images en échec (lecture, format, calcul ou écriture)
+    int writeFailed;         // Dont les images dont l'écriture a échoué
+    double seconds;          // Durée totale
+    double imagesPerSecond;  // Débit global
+    double megabytes;        // Volume de pixels traités (Mo)
+} t_batchStats;
+
+int batch_run(const t_pipeline* pipeline, const char** inputs, const char** outputs, int count,
+              int workers, t_batchStats* stats);
+void batch_printStats(const t_batchStats* stats);
+
+#endif // BATCH_H
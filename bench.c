@@ -0,0 +1,434 @@
+/**
+ * @file bench.c
+ * @author Projet TI202
+ * @brief Mesure des performances des fonctions de bmp8.h, bmp24.h et planar.h sur des images synthétiques
+ * @date 2025
+ *
+ * Pour chaque taille demandée, une image 8 bits et une image 24 bits sont
+ * générées ; chaque fonction est appelée une fois à vide puis mesurée
+ * plusieurs fois, en repartant à chaque mesure des mêmes pixels. Les
+ * résultats (médiane et 95e centile en ns par pixel, débit en Mo/s) sont
+ * écrits au format CSV, dans bench_output.csv par défaut (« --csv - » pour
+ * la sortie standard, mêlée alors aux messages de sauvegarde).
+ *
+ * Utilisation :
+ *     bench_images [--sizes 256,1024,4096] [--runs N] [--warmup N] [--csv fichier]
+ */
+
+#ifndef _WIN32
+    #define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bmp8.h"
+#include "bmp24.h"
+#include "filters.h"
+#include "lut.h"
+#include "clahe.h"
+#include "planar.h"
+#include "pipeline.h"
+
+// Tailles mesurées par défaut (côté de l'image carrée)
+#define BENCH_DEFAULT_SIZES "256,512,1024,2048,4096,8192,16384"
+#define BENCH_DEFAULT_RUNS 5
+#define BENCH_DEFAULT_WARMUP 1
+#define BENCH_MAX_SIZES 16
+#define BENCH_DEFAULT_CSV "bench_output.csv"
+
+// Fichiers temporaires pour la lecture et l'écriture
+#define BENCH_FILE8 "bench_tmp_8bits.bmp"
+#define BENCH_FILE24 "bench_tmp_24bits.bmp"
+
+// Contexte d'une mesure : image de travail et image d'origine
+typedef struct {
+    t_bmp8* img8;
+    t_bmp8* ref8;
+    t_bmp24* img24;
+    t_bmp24* ref24;
+    t_planar* planar;   // Image 24 bits en plans séparés
+    float** kernel;
+    t_separableKernel* separable;
+    t_intKernel* intKernel;
+    t_lut lut;
+    t_pipeline* chain;  // Noyaux 3x3 et tables appliqués en un seul parcours
+} t_benchContext;
+
+// Fonction mesurée
+typedef void (*t_benchFunc)(t_benchContext* ctx);
+
+/**
+ * @brief Horloge en nanosecondes
+ */
+static double bench_now(void) {
+#ifndef _WIN32
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+#else
+    return (double)clock() * (1e9 / CLOCKS_PER_SEC);
+#endif
+}
+
+/**
+ * @brief Générateur pseudo-aléatoire reproductible (xorshift)
+ */
+static uint32_t bench_random(uint32_t* state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/**
+ * @brief Valeur synthétique d'un pixel : dégradé, motif et bruit
+ */
+static unsigned char bench_pixel(int x, int y, int channel, uint32_t* state) {
+    int v = (x * 3 + y * 2 + channel * 85) & 0xFF;
+    v = (v + (((x >> 4) ^ (y >> 4)) & 1) * 64 + (int)(bench_random(state) & 0x1F)) & 0xFF;
+    return (unsigned char)v;
+}
+
+/**
+ * @brief Crée une image 8 bits synthétique de size x size pixels
+ */
+static t_bmp8* bench_createBmp8(int size) {
+    t_bmp8* img = (t_bmp8*)calloc(1, sizeof(t_bmp8));
+    if (!img) return NULL;
+
+    img->width = size;
+    img->height = size;
+    img->colorDepth = 8;
+    img->dataSize = (unsigned int)size * size;
+    img->data = (unsigned char*)malloc(img->dataSize);
+    if (!img->data) {
+        free(img);
+        return NULL;
+    }
+
+    // En-tête et palette de niveaux de gris
+    unsigned char* h = img->header;
+    h[0] = 'B';
+    h[1] = 'M';
+    *(uint32_t*)&h[2] = 54 + 1024 + img->dataSize;
+    *(uint32_t*)&h[10] = 54 + 1024;
+    *(uint32_t*)&h[14] = 40;
+    *(int32_t*)&h[18] = size;
+    *(int32_t*)&h[22] = size;
+    *(uint16_t*)&h[26] = 1;
+    *(uint16_t*)&h[28] = 8;
+    *(uint32_t*)&h[34] = img->dataSize;
+    *(uint32_t*)&h[46] = 256;
+    for (int i = 0; i < 256; i++) {
+        img->colorTable[i * 4] = img->colorTable[i * 4 + 1] = img->colorTable[i * 4 + 2] = (unsigned char)i;
+    }
+
+    uint32_t state = 12345;
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            img->data[(size_t)y * size + x] = bench_pixel(x, y, 0, &state);
+        }
+    }
+    return img;
+}
+
+/**
+ * @brief Crée une image 24 bits synthétique de size x size pixels
+ */
+static t_bmp24* bench_createBmp24(int size) {
+    t_bmp24* img = bmp24_allocate(size, size, 24);
+    if (!img) return NULL;
+
+    uint32_t state = 67890;
+    for (int y = 0; y < size; y++) {
+        for (int x = 0; x < size; x++) {
+            img->data[y][x].red = bench_pixel(x, y, 0, &state);
+            img->data[y][x].green = bench_pixel(x, y, 1, &state);
+            img->data[y][x].blue = bench_pixel(x, y, 2, &state);
+        }
+    }
+    return img;
+}
+
+// Fonctions 8 bits mesurées
+static void b8_load(t_benchContext* c) { (void)c; bmp8_free(bmp8_loadImage(BENCH_FILE8)); }
+static void b8_save(t_benchContext* c) { bmp8_saveImage(BENCH_FILE8, c->img8); }
+static void b8_negative(t_benchContext* c) { bmp8_negative(c->img8); }
+static void b8_brightness(t_benchContext* c) { bmp8_brightness(c->img8, 40); }
+static void b8_threshold(t_benchContext* c) { bmp8_threshold(c->img8, 128); }
+static void b8_applyLUT(t_benchContext* c) { bmp8_applyLUT(c->img8, &c->lut); }
+static void b8_adaptiveThreshold(t_benchContext* c) { bmp8_adaptiveThreshold(c->img8, 15, 5); }
+static void b8_applyFilter(t_benchContext* c) { bmp8_applyFilter(c->img8, c->kernel, 3); }
+static void b8_applyFilterChain(t_benchContext* c) {
+    float** kernels[3] = {c->kernel, c->kernel, c->kernel};
+    bmp8_applyFilterChain(c->img8, kernels, 3);
+}
+static void b8_applyIntFilter(t_benchContext* c) { bmp8_applyIntFilter(c->img8, c->intKernel); }
+static void b8_applySeparableFilter(t_benchContext* c) { bmp8_applySeparableFilter(c->img8, c->separable); }
+static void b8_boxBlurRadius(t_benchContext* c) { bmp8_boxBlurRadius(c->img8, 10); }
+static void b8_medianFilter(t_benchContext* c) { bmp8_medianFilter(c->img8, 10); }
+static void b8_computeHistogram(t_benchContext* c) { free(bmp8_computeHistogram(c->img8)); }
+static void b8_equalize(t_benchContext* c) { bmp8_equalize(c->img8); }
+static void b8_clahe(t_benchContext* c) { bmp8_clahe(c->img8, 8, 8, CLAHE_DEFAULT_CLIP); }
+static void b8_kernelChain(t_benchContext* c) { pipeline_apply8(c->chain, c->img8); }
+
+// Fonctions 24 bits mesurées
+static void b24_load(t_benchContext* c) { (void)c; bmp24_free(bmp24_loadImage(BENCH_FILE24)); }
+static void b24_save(t_benchContext* c) { bmp24_saveImage(c->img24, BENCH_FILE24); }
+static void b24_negative(t_benchContext* c) { bmp24_negative(c->img24); }
+static void b24_grayscale(t_benchContext* c) { bmp24_grayscale(c->img24); }
+static void b24_toBmp8(t_benchContext* c) { bmp8_free(bmp24_toBmp8(c->img24)); }
+static void b24_brightness(t_benchContext* c) { bmp24_brightness(c->img24, 40); }
+static void b24_applyLUT(t_benchContext* c) { bmp24_applyLUT(c->img24, &c->lut); }
+static void b24_boxBlur(t_benchContext* c) { bmp24_boxBlur(c->img24); }
+static void b24_gaussianBlur(t_benchContext* c) { bmp24_gaussianBlur(c->img24); }
+static void b24_outline(t_benchContext* c) { bmp24_outline(c->img24); }
+static void b24_emboss(t_benchContext* c) { bmp24_emboss(c->img24); }
+static void b24_sharpen(t_benchContext* c) { bmp24_sharpen(c->img24); }
+static void b24_applyFilterChain(t_benchContext* c) {
+    float** kernels[3] = {c->kernel, c->kernel, c->kernel};
+    bmp24_applyFilterChain(c->img24, kernels, 3);
+}
+static void b24_applyIntFilter(t_benchContext* c) { bmp24_applyIntFilter(c->img24, c->intKernel); }
+static void b24_applySeparableFilter(t_benchContext* c) { bmp24_applySeparableFilter(c->img24, c->separable); }
+static void b24_boxBlurRadius(t_benchContext* c) { bmp24_boxBlurRadius(c->img24, 10); }
+static void b24_medianFilter(t_benchContext* c) { bmp24_medianFilter(c->img24, 10); }
+static void b24_equalize(t_benchContext* c) { bmp24_equalize(c->img24); }
+static void b24_clahe(t_benchContext* c) { bmp24_clahe(c->img24, 8, 8, CLAHE_DEFAULT_CLIP); }
+static void b24_kernelChain(t_benchContext* c) { pipeline_apply24(c->chain, c->img24); }
+
+// Fonctions en plans séparés mesurées (image 24 bits)
+static void bp_deinterleave(t_benchContext* c) { planar_deinterleave(c->img24, c->planar); }
+static void bp_interleave(t_benchContext* c) { planar_interleave(c->planar, c->img24); }
+static void bp_negative(t_benchContext* c) { planar_negative(c->planar); }
+static void bp_applyLUT(t_benchContext* c) { planar_applyLUT(c->planar, &c->lut); }
+static void bp_applyFilter(t_benchContext* c) { planar_applyFilter(c->planar, c->kernel, 3); }
+static void bp_applySeparableFilter(t_benchContext* c) { planar_applySeparableFilter(c->planar, c->separable); }
+static void bp_boxBlurRadius(t_benchContext* c) { planar_boxBlurRadius(c->planar, 10); }
+static void bp_medianFilter(t_benchContext* c) { planar_medianFilter(c->planar, 10); }
+static void bp_equalize(t_benchContext* c) { planar_equalize(c->planar); }
+
+// Table des mesures
+typedef struct {
+    int depth;
+    const char* name;
+    t_benchFunc func;
+} t_benchEntry;
+
+static const t_benchEntry benchEntries[] = {
+    {8, "bmp8_loadImage", b8_load},
+    {8, "bmp8_saveImage", b8_save},
+    {8, "bmp8_negative", b8_negative},
+    {8, "bmp8_brightness", b8_brightness},
+    {8, "bmp8_threshold", b8_threshold},
+    {8, "bmp8_applyLUT", b8_applyLUT},
+    {8, "bmp8_adaptiveThreshold", b8_adaptiveThreshold},
+    {8, "bmp8_applyFilter", b8_applyFilter},
+    {8, "bmp8_applyFilterChain", b8_applyFilterChain},
+    {8, "bmp8_applyIntFilter", b8_applyIntFilter},
+    {8, "bmp8_applySeparableFilter", b8_applySeparableFilter},
+    {8, "bmp8_boxBlurRadius", b8_boxBlurRadius},
+    {8, "bmp8_medianFilter", b8_medianFilter},
+    {8, "bmp8_computeHistogram", b8_computeHistogram},
+    {8, "bmp8_equalize", b8_equalize},
+    {8, "bmp8_clahe", b8_clahe},
+    {8, "pipeline_apply8", b8_kernelChain},
+    {24, "bmp24_loadImage", b24_load},
+    {24, "bmp24_saveImage", b24_save},
+    {24, "bmp24_negative", b24_negative},
+    {24, "bmp24_grayscale", b24_grayscale},
+    {24, "bmp24_toBmp8", b24_toBmp8},
+    {24, "bmp24_brightness", b24_brightness},
+    {24, "bmp24_applyLUT", b24_applyLUT},
+    {24, "bmp24_boxBlur", b24_boxBlur},
+    {24, "bmp24_gaussianBlur", b24_gaussianBlur},
+    {24, "bmp24_outline", b24_outline},
+    {24, "bmp24_emboss", b24_emboss},
+    {24, "bmp24_sharpen", b24_sharpen},
+    {24, "bmp24_applyFilterChain", b24_applyFilterChain},
+    {24, "bmp24_applyIntFilter", b24_applyIntFilter},
+    {24, "bmp24_applySeparableFilter", b24_applySeparableFilter},
+    {24, "bmp24_boxBlurRadius", b24_boxBlurRadius},
+    {24, "bmp24_medianFilter", b24_medianFilter},
+    {24, "bmp24_equalize", b24_equalize},
+    {24, "bmp24_clahe", b24_clahe},
+    {24, "pipeline_apply24", b24_kernelChain},
+    {24, "planar_deinterleave", bp_deinterleave},
+    {24, "planar_interleave", bp_interleave},
+    {24, "planar_negative", bp_negative},
+    {24, "planar_applyLUT", bp_applyLUT},
+    {24, "planar_applyFilter", bp_applyFilter},
+    {24, "planar_applySeparableFilter", bp_applySeparableFilter},
+    {24, "planar_boxBlurRadius", bp_boxBlurRadius},
+    {24, "planar_medianFilter", bp_medianFilter},
+    {24, "planar_equalize", bp_equalize},
+};
+
+/**
+ * @brief Remet l'image de travail dans son état d'origine (hors mesure)
+ */
+static void bench_reset(t_benchContext* ctx, int depth) {
+    if (depth == 8) {
+        memcpy(ctx->img8->data, ctx->ref8->data, ctx->ref8->dataSize);
+    } else {
+        bmp24_copyPixels(ctx->img24, ctx->ref24);
+        planar_deinterleave(ctx->ref24, ctx->planar);
+    }
+}
+
+static int compareDouble(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Mesure une fonction et écrit une ligne CSV
+ */
+static void bench_measure(FILE* csv, const t_benchEntry* entry, t_benchContext* ctx, int size,
+                          int runs, int warmup, double* times) {
+    for (int i = 0; i < warmup; i++) {
+        bench_reset(ctx, entry->depth);
+        entry->func(ctx);
+    }
+
+    for (int i = 0; i < runs; i++) {
+        bench_reset(ctx, entry->depth);
+        double start = bench_now();
+        entry->func(ctx);
+        times[i] = bench_now() - start;
+    }
+    qsort(times, runs, sizeof(double), compareDouble);
+
+    double pixels = (double)size * size;
+    double bytes = pixels * (entry->depth / 8);
+    double median = times[runs / 2];
+    double p95 = times[(int)((runs - 1) * 0.95 + 0.5)];
+
+    fprintf(csv, "%d,%s,%d,%d,%d,%.3f,%.3f,%.1f\n", entry->depth, entry->name, size, size, runs,
+            median / pixels, p95 / pixels, bytes / (median * 1e-9) / (1024.0 * 1024.0));
+    fflush(csv);
+}
+
+/**
+ * @brief Mesure toutes les fonctions pour une taille d'image
+ * @return 0 en cas de succès, -1 si les images n'ont pas pu être créées
+ */
+static int bench_size(FILE* csv, int size, int runs, int warmup, double* times) {
+    t_benchContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.ref8 = bench_createBmp8(size);
+    ctx.img8 = bench_createBmp8(size);
+    ctx.ref24 = bench_createBmp24(size);
+    ctx.img24 = bench_createBmp24(size);
+    ctx.planar = ctx.img24 ? planar_allocate(size, size) : NULL;
+    ctx.kernel = createGaussianBlurKernel();
+    ctx.separable = createSeparableGaussianKernel(2.0f);
+    ctx.intKernel = createBoxBlurIntKernel();
+    ctx.chain = pipeline_parse("gauss,sharpen,brightness=20,outline,negative");
+
+    int status = 0;
+    if (!ctx.ref8 || !ctx.img8 || !ctx.ref24 || !ctx.img24 || !ctx.planar || !ctx.separable || !ctx.intKernel ||
+        !ctx.chain) {
+        printf("Erreur: Mémoire insuffisante pour une image de %d x %d\n", size, size);
+        status = -1;
+    } else {
+        lut_identity(&ctx.lut);
+        lut_brightness(&ctx.lut, LUT_ALL, 40);
+        lut_negative(&ctx.lut, LUT_ALL);
+        lut_threshold(&ctx.lut, LUT_ALL, 128);
+
+        // Fichiers lus par les mesures de chargement
+        bmp8_saveImage(BENCH_FILE8, ctx.ref8);
+        bmp24_saveImage(ctx.ref24, BENCH_FILE24);
+
+        for (size_t i = 0; i < sizeof(benchEntries) / sizeof(benchEntries[0]); i++) {
+            fprintf(stderr, "%d x %d : %s\n", size, size, benchEntries[i].name);
+            bench_measure(csv, &benchEntries[i], &ctx, size, runs, warmup, times);
+        }
+
+        remove(BENCH_FILE8);
+        remove(BENCH_FILE24);
+    }
+
+    bmp8_free(ctx.ref8);
+    bmp8_free(ctx.img8);
+    bmp24_free(ctx.ref24);
+    bmp24_free(ctx.img24);
+    planar_free(ctx.planar);
+    freeFilterKernel(ctx.kernel, 3);
+    freeSeparableKernel(ctx.separable);
+    freeIntKernel(ctx.intKernel);
+    pipeline_free(ctx.chain);
+    return status;
+}
+
+/**
+ * @brief Fonction principale du programme de mesure
+ */
+int main(int argc, char* argv[]) {
+    const char* sizesArg = BENCH_DEFAULT_SIZES;
+    const char* csvPath = BENCH_DEFAULT_CSV;
+    int runs = BENCH_DEFAULT_RUNS;
+    int warmup = BENCH_DEFAULT_WARMUP;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--sizes") == 0 && i + 1 < argc) {
+            sizesArg = argv[++i];
+        } else if (strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            warmup = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else {
+            printf("Utilisation : %s [--sizes 256,1024,4096] [--runs N] [--warmup N] [--csv fichier]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (runs < 1) runs = 1;
+    if (warmup < 0) warmup = 0;
+
+    // Analyser la liste des tailles
+    int sizes[BENCH_MAX_SIZES];
+    int sizeCount = 0;
+    for (const char* p = sizesArg; *p && sizeCount < BENCH_MAX_SIZES; ) {
+        int size = atoi(p);
+        if (size < 8) {
+            printf("Erreur: Taille invalide dans '%s'\n", sizesArg);
+            return 1;
+        }
+        sizes[sizeCount++] = size;
+        while (*p && *p != ',') p++;
+        if (*p == ',') p++;
+    }
+
+    FILE* csv = stdout;
+    if (strcmp(csvPath, "-") != 0) {
+        csv = fopen(csvPath, "w");
+        if (!csv) {
+            printf("Erreur: Impossible d'ouvrir le fichier %s en écriture\n", csvPath);
+            return 1;
+        }
+    }
+
+    double* times = (double*)malloc(runs * sizeof(double));
+    if (!times) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        if (csv != stdout) fclose(csv);
+        return 1;
+    }
+
+    fprintf(csv, "depth,function,width,height,runs,median_ns_per_pixel,p95_ns_per_pixel,mb_per_s\n");
+    int status = 0;
+    for (int i = 0; i < sizeCount; i++) {
+        if (bench_size(csv, sizes[i], runs, warmup, times) != 0) status = 1;
+    }
+
+    free(times);
+    if (csv != stdout) fclose(csv);
+    return status;
+}
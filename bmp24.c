@@ -6,6 +6,11 @@
  */
 
 #include "bmp24.h"
+#include "simd.h"
+#include "convolution.h"
+#include "threadpool.h"
+#include "clahe.h"
+#include "instrument.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
@@ -21,30 +26,52 @@ void file_rawWrite(uint32_t position, void* buffer, uint32_t size, size_t n, FIL
     fwrite(buffer, size, n, file);
 }
 
+// Paramètres d'un traitement réparti en bandes de lignes entre les threads du pool
+typedef struct {
+    t_bmp24* img;
+    int value;                 // 1 si les trois tables de lut sont identiques
+    t_bmp24* out;              // Destination d'un filtre
+    t_bmp8* gray;              // Destination de la conversion en 8 bits
+    float** kernel;
+    int kernelSize;
+    const unsigned int* map;   // Table d'égalisation de la luminance
+    const t_lut* lut;          // Table de correspondance par canal
+    unsigned int (*hist)[256]; // Un histogramme partiel par bande
+    t_clahe* clahe;            // Tables par tuile de l'égalisation adaptative
+    float clipLimit;
+} t_bmp24Job;
+
 /**
  * @brief Alloue une matrice de pixels
+ *
+ * Les pointeurs de lignes et les pixels sont réservés en une seule allocation :
+ * le tableau de pointeurs est suivi d'un tampon contigu aligné sur
+ * BMP24_ALIGNMENT octets, dont les lignes sont espacées de BMP24_STRIDE(width).
+ * pixels[y] pointe donc directement dans ce tampon et pixels[0] en est le début.
+ *
  * @param width Largeur de l'image
  * @param height Hauteur de l'image
  * @return Matrice de pixels allouée
  */
 t_pixel** bmp24_allocateDataPixels(int width, int height) {
-    t_pixel** pixels = (t_pixel**)malloc(height * sizeof(t_pixel*));
-    if (!pixels) {
+    size_t stride = BMP24_STRIDE(width);
+    size_t rowsSize = height * sizeof(t_pixel*);
+    size_t dataSize = stride * height;
+
+    unsigned char* block = (unsigned char*)instrument_malloc(rowsSize + BMP24_ALIGNMENT + dataSize);
+    if (!block) {
         printf("Erreur: Allocation mémoire échouée\n");
         return NULL;
     }
 
+    // Aligner le début des pixels après le tableau de pointeurs
+    uintptr_t start = (uintptr_t)(block + rowsSize);
+    start = (start + BMP24_ALIGNMENT - 1) & ~(uintptr_t)(BMP24_ALIGNMENT - 1);
+    unsigned char* buffer = (unsigned char*)start;
+
+    t_pixel** pixels = (t_pixel**)block;
     for (int i = 0; i < height; i++) {
-        pixels[i] = (t_pixel*)malloc(width * sizeof(t_pixel));
-        if (!pixels[i]) {
-            printf("Erreur: Allocation mémoire échouée\n");
-            // Libérer la mémoire déjà allouée
-            for (int j = 0; j < i; j++) {
-                free(pixels[j]);
-            }
-            free(pixels);
-            return NULL;
-        }
+        pixels[i] = (t_pixel*)(buffer + i * stride);
     }
 
     return pixels;
@@ -56,14 +83,8 @@ t_pixel** bmp24_allocateDataPixels(int width, int height) {
  * @param height Hauteur de la matrice
  */
 void bmp24_freeDataPixels(t_pixel** pixels, int height) {
-    if (pixels) {
-        for (int i = 0; i < height; i++) {
-            if (pixels[i]) {
-                free(pixels[i]);
-            }
-        }
-        free(pixels);
-    }
+    (void)height; // Pointeurs et pixels partagent la même allocation
+    free(pixels);
 }
 
 /**
@@ -74,7 +95,7 @@ void bmp24_freeDataPixels(t_pixel** pixels, int height) {
  * @return Structure d'image allouée
  */
 t_bmp24* bmp24_allocate(int width, int height, int colorDepth) {
-    t_bmp24* img = (t_bmp24*)malloc(sizeof(t_bmp24));
+    t_bmp24* img = (t_bmp24*)instrument_malloc(sizeof(t_bmp24));
     if (!img) {
         printf("Erreur: Allocation mémoire échouée\n");
         return NULL;
@@ -83,6 +104,7 @@ t_bmp24* bmp24_allocate(int width, int height, int colorDepth) {
     img->width = width;
     img->height = height;
     img->colorDepth = colorDepth;
+    img->stride = BMP24_STRIDE(width);
 
     img->data = bmp24_allocateDataPixels(width, height);
     if (!img->data) {
@@ -107,73 +129,136 @@ void bmp24_free(t_bmp24* img) {
 }
 
 /**
- * @brief Lit la valeur d'un pixel depuis un fichier
- * @param img Structure d'image
- * @param x Coordonnée x du pixel
- * @param y Coordonnée y du pixel
- * @param file Fichier BMP
+ * @brief Copie tous les pixels d'une image dans une autre de même taille
+ * @param dst Image de destination
+ * @param src Image source
  */
-void bmp24_readPixelValue(t_bmp24* img, int x, int y, FILE* file) {
-    // Position du pixel dans le fichier (en tenant compte de l'inversion des lignes)
-    int realY = img->height - 1 - y;
-    long position = img->header.offset + (realY * img->width + x) * 3;
+void bmp24_copyPixels(t_bmp24* dst, t_bmp24* src) {
+    if (!dst || !src || !dst->data || !src->data) return;
+    if (dst->width != src->width || dst->height != src->height) {
+        printf("Erreur: Dimensions incompatibles\n");
+        return;
+    }
+    if (src->height <= 0) return;
 
-    uint8_t bgr[3];
-    fseek(file, position, SEEK_SET);
-    fread(bgr, 1, 3, file);
+    // Les deux tampons sont contigus avec le même pas : une seule copie suffit
+    memcpy(dst->data[0], src->data[0], (size_t)src->stride * src->height);
+}
+
+/**
+ * @brief Échange les pixels de deux images de mêmes dimensions sans les copier
+ *
+ * Seuls les blocs (pointeurs de lignes et tampon) changent de propriétaire :
+ * après l'échange, chaque image libère avec bmp24_free le bloc de l'autre.
+ *
+ * @param a Première image
+ * @param b Seconde image
+ */
+void bmp24_swapPixels(t_bmp24* a, t_bmp24* b) {
+    if (!a || !b) return;
+    if (a->width != b->width || a->height != b->height) {
+        printf("Erreur: Dimensions incompatibles\n");
+        return;
+    }
+
+    t_pixel** data = a->data;
+    a->data = b->data;
+    b->data = data;
+}
 
-    // Convertir BGR en RGB
-    img->data[y][x].blue = bgr[0];
-    img->data[y][x].green = bgr[1];
-    img->data[y][x].red = bgr[2];
+#if SIMD_X86
+// Échange les octets 0 et 2 de chaque triplet sur 15 octets, le 16e est conservé
+SIMD_TARGET("ssse3")
+static int swapRedBlue_ssse3(unsigned char* row, int size) {
+    const __m128i mask = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15);
+    int i = 0;
+    for (; i + 16 <= size; i += 15) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(row + i));
+        _mm_storeu_si128((__m128i*)(row + i), _mm_shuffle_epi8(v, mask));
+    }
+    return i;
 }
+#endif
 
 /**
- * @brief Lit toutes les données de l'image depuis un fichier
- * @param img Structure d'image
- * @param file Fichier BMP
+ * @brief Convertit une ligne de pixels BGR en RGB (ou l'inverse) sur place
+ * @param row Début de la ligne
+ * @param width Nombre de pixels de la ligne
  */
-void bmp24_readPixelData(t_bmp24* img, FILE* file) {
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            bmp24_readPixelValue(img, x, y, file);
-        }
+void bmp24_swapRedBlue(unsigned char* row, int width) {
+    int size = width * 3;
+    int i = 0;
+
+#if SIMD_X86
+    if (simd_level() >= SIMD_LEVEL_SSSE3) i = swapRedBlue_ssse3(row, size);
+#endif
+
+    for (; i < size; i += 3) {
+        unsigned char tmp = row[i];
+        row[i] = row[i + 2];
+        row[i + 2] = tmp;
     }
 }
 
 /**
- * @brief Écrit la valeur d'un pixel dans un fichier
+ * @brief Lit toutes les données de l'image depuis un fichier
+ *
+ * Chaque ligne du fichier, padding compris, est lue en un seul appel directement
+ * dans le tampon de l'image (dont le pas est celui du fichier), puis convertie
+ * de BGR en RGB.
+ *
  * @param img Structure d'image
- * @param x Coordonnée x du pixel
- * @param y Coordonnée y du pixel
  * @param file Fichier BMP
+ * @return 0 en cas de succès, -1 si le fichier est tronqué
  */
-void bmp24_writePixelValue(t_bmp24* img, int x, int y, FILE* file) {
-    // Position du pixel dans le fichier (en tenant compte de l'inversion des lignes)
-    int realY = img->height - 1 - y;
-    long position = img->header.offset + (realY * img->width + x) * 3;
+int bmp24_readPixelData(t_bmp24* img, FILE* file) {
+    fseek(file, img->header.offset, SEEK_SET);
 
-    uint8_t bgr[3];
-    // Convertir RGB en BGR
-    bgr[0] = img->data[y][x].blue;
-    bgr[1] = img->data[y][x].green;
-    bgr[2] = img->data[y][x].red;
-
-    fseek(file, position, SEEK_SET);
-    fwrite(bgr, 1, 3, file);
+    for (int y = img->height - 1; y >= 0; y--) { // Les lignes sont inversées dans BMP
+        unsigned char* row = (unsigned char*)img->data[y];
+        size_t n = fread(row, 1, img->stride, file);
+        instrument_addRead(n);
+        if (n != (size_t)img->stride) {
+            printf("Erreur: Données de l'image incomplètes\n");
+            return -1;
+        }
+        bmp24_swapRedBlue(row, img->width);
+    }
+    return 0;
 }
 
 /**
  * @brief Écrit toutes les données de l'image dans un fichier
+ *
+ * Chaque ligne est copiée dans un tampon BGR déjà paddé puis écrite en un seul
+ * appel ; l'image elle-même n'est pas modifiée.
+ *
  * @param img Structure d'image
- * @param file Fichier BMP
+ * @param file Fichier BMP positionné au début des données
+ * @return 0 en cas de succès, -1 en cas d'erreur
  */
-void bmp24_writePixelData(t_bmp24* img, FILE* file) {
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            bmp24_writePixelValue(img, x, y, file);
+int bmp24_writePixelData(t_bmp24* img, FILE* file) {
+    unsigned char* row = (unsigned char*)instrument_calloc(img->stride, 1);
+    if (!row) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        return -1;
+    }
+
+    int status = 0;
+    for (int y = img->height - 1; y >= 0; y--) { // Les lignes sont inversées dans BMP
+        memcpy(row, img->data[y], img->width * sizeof(t_pixel));
+        bmp24_swapRedBlue(row, img->width);
+        size_t n = fwrite(row, 1, img->stride, file);
+        instrument_addWritten(n);
+        if (n != (size_t)img->stride) {
+            printf("Erreur: Écriture des données échouée\n");
+            status = -1;
+            break;
         }
     }
+
+    free(row);
+    return status;
 }
 
 /**
@@ -182,15 +267,18 @@ void bmp24_writePixelData(t_bmp24* img, FILE* file) {
  * @return Structure d'image chargée
  */
 t_bmp24* bmp24_loadImage(const char* filename) {
+    INSTRUMENT_BEGIN("bmp24_loadImage");
+
     FILE* file = fopen(filename, "rb");
     if (!file) {
         printf("Erreur: Impossible d'ouvrir le fichier %s\n", filename);
+        INSTRUMENT_END();
         return NULL;
     }
 
     // Lire l'en-tête complet du fichier
     unsigned char header[54];
-    fread(header, sizeof(unsigned char), 54, file);
+    instrument_addRead(fread(header, sizeof(unsigned char), 54, file));
 
     // Extraire les informations importantes
     uint16_t type = *(uint16_t*)&header[0];
@@ -203,12 +291,14 @@ t_bmp24* bmp24_loadImage(const char* filename) {
     if (type != 0x4D42) { // "BM" en little-endian
         printf("Erreur: Le fichier n'est pas un BMP valide\n");
         fclose(file);
+        INSTRUMENT_END();
         return NULL;
     }
 
     if (colorDepth != 24) {
         printf("Erreur: L'image n'est pas en 24 bits (profondeur: %d)\n", colorDepth);
         fclose(file);
+        INSTRUMENT_END();
         return NULL;
     }
 
@@ -216,6 +306,7 @@ t_bmp24* bmp24_loadImage(const char* filename) {
     t_bmp24* img = bmp24_allocate(width, height, colorDepth);
     if (!img) {
         fclose(file);
+        INSTRUMENT_END();
         return NULL;
     }
 
@@ -238,28 +329,16 @@ t_bmp24* bmp24_loadImage(const char* filename) {
     img->header_info.ncolors = *(uint32_t*)&header[46];
     img->header_info.importantcolors = *(uint32_t*)&header[50];
 
-    // Se positionner au début des données
-    fseek(file, offset, SEEK_SET);
-
-    // Calculer le padding
-    int padding = (4 - (width * 3) % 4) % 4;
-
-    // Lire les données pixel par pixel
-    for (int y = height - 1; y >= 0; y--) { // Les lignes sont inversées dans BMP
-        for (int x = 0; x < width; x++) {
-            unsigned char bgr[3];
-            fread(bgr, 1, 3, file);
-            img->data[y][x].blue = bgr[0];
-            img->data[y][x].green = bgr[1];
-            img->data[y][x].red = bgr[2];
-        }
-        // Ignorer le padding
-        if (padding > 0) {
-            fseek(file, padding, SEEK_CUR);
-        }
+    // Lire les données ligne par ligne
+    if (bmp24_readPixelData(img, file) != 0) {
+        bmp24_free(img);
+        fclose(file);
+        INSTRUMENT_END();
+        return NULL;
     }
 
     fclose(file);
+    INSTRUMENT_END();
     return img;
 }
 
@@ -267,24 +346,25 @@ t_bmp24* bmp24_loadImage(const char* filename) {
  * @brief Sauvegarde une image BMP 24 bits dans un fichier
  * @param img Structure d'image
  * @param filename Nom du fichier de sortie
+ * @return 0 en cas de succès, -1 si le fichier n'a pas pu être écrit entièrement
  */
-void bmp24_saveImage(t_bmp24* img, const char* filename) {
+int bmp24_saveImage(t_bmp24* img, const char* filename) {
     if (!img) {
         printf("Erreur: Image NULL\n");
-        return;
+        return -1;
     }
 
+    INSTRUMENT_BEGIN("bmp24_saveImage");
+
     FILE* file = fopen(filename, "wb");
     if (!file) {
         printf("Erreur: Impossible d'ouvrir le fichier %s en écriture\n", filename);
-        return;
+        INSTRUMENT_END();
+        return -1;
     }
 
-    // Calculer le padding
-    int padding = (4 - (img->width * 3) % 4) % 4;
-
-    // Calculer la taille réelle des données
-    int rowSize = img->width * 3 + padding;
+    // Calculer la taille réelle des données (lignes paddées sur 4 octets)
+    int rowSize = img->stride;
     int dataSize = rowSize * img->height;
 
     // Mettre à jour les informations dans l'en-tête
@@ -314,28 +394,22 @@ void bmp24_saveImage(t_bmp24* img, const char* filename) {
     *(uint32_t*)&header[46] = 0;
     *(uint32_t*)&header[50] = 0;
 
-    // Écrire l'en-tête
-    fwrite(header, 1, 54, file);
-
-    // Écrire les données pixel par pixel
-    unsigned char paddingBytes[3] = {0, 0, 0};
-
-    for (int y = img->height - 1; y >= 0; y--) { // Les lignes sont inversées dans BMP
-        for (int x = 0; x < img->width; x++) {
-            unsigned char bgr[3];
-            bgr[0] = img->data[y][x].blue;
-            bgr[1] = img->data[y][x].green;
-            bgr[2] = img->data[y][x].red;
-            fwrite(bgr, 1, 3, file);
-        }
-        // Écrire le padding si nécessaire
-        if (padding > 0) {
-            fwrite(paddingBytes, 1, padding, file);
-        }
+    // Écrire l'en-tête puis les données ligne par ligne
+    size_t written = fwrite(header, 1, 54, file);
+    instrument_addWritten(written);
+    int status = (written == 54) ? bmp24_writePixelData(img, file) : -1;
+
+    // fclose vide le tampon : une erreur d'écriture peut n'apparaître qu'ici
+    if (fclose(file) != 0) status = -1;
+    if (status != 0) {
+        printf("Erreur: Écriture du fichier %s échouée\n", filename);
+        INSTRUMENT_END();
+        return -1;
     }
 
-    fclose(file);
     printf("Image sauvegardée avec succès dans %s\n", filename);
+    INSTRUMENT_END();
+    return 0;
 }
 
 /**
@@ -355,6 +429,43 @@ void bmp24_printInfo(t_bmp24* img) {
     printf("Data Size: %u\n", img->header_info.imagesize);
 }
 
+/**
+ * @brief Applique la table aux lignes [start, end)
+ */
+static void applyLUTBand(int start, int end, int band, void* arg) {
+    t_bmp24Job* job = (t_bmp24Job*)arg;
+    t_bmp24* img = job->img;
+    (void)band;
+
+    if (job->value) {
+        // Même table pour les trois canaux : les lignes contiguës sont traitées d'un bloc
+        size_t count = (size_t)(end - start - 1) * img->stride + img->width * 3;
+        lut_applyBytes(job->lut->table[0], (unsigned char*)img->data[start], count);
+    } else {
+        for (int y = start; y < end; y++) {
+            lut_applyPixels(job->lut, (unsigned char*)img->data[y], img->width);
+        }
+    }
+}
+
+/**
+ * @brief Applique une chaîne d'opérations ponctuelles en un seul parcours
+ * @param img Structure d'image
+ * @param lut Table par canal construite avec lut_identity puis les fonctions lut_xxx
+ */
+void bmp24_applyLUT(t_bmp24* img, const t_lut* lut) {
+    if (!img || !img->data || !lut) {
+        printf("Erreur: Paramètres invalides\n");
+        return;
+    }
+
+    INSTRUMENT_BEGIN("bmp24_applyLUT");
+
+    t_bmp24Job job = {.img = img, .lut = lut, .value = lut_isUniform(lut)};
+    threadpool_run(img->height, img->width, applyLUTBand, &job);
+    INSTRUMENT_END();
+}
+
 /**
  * @brief Applique un effet négatif sur l'image
  * @param img Structure d'image
@@ -365,11 +476,28 @@ void bmp24_negative(t_bmp24* img) {
         return;
     }
 
-    for (int y = 0; y < img->height; y++) {
+    INSTRUMENT_BEGIN("bmp24_negative");
+
+    t_lut lut;
+    lut_identity(&lut);
+    lut_negative(&lut, LUT_ALL);
+    bmp24_applyLUT(img, &lut);
+    INSTRUMENT_END();
+}
+
+/**
+ * @brief Niveaux de gris des lignes [start, end)
+ */
+static void grayscaleBand(int start, int end, int band, void* arg) {
+    t_bmp24* img = ((t_bmp24Job*)arg)->img;
+    (void)band;
+    for (int y = start; y < end; y++) {
         for (int x = 0; x < img->width; x++) {
-            img->data[y][x].red = 255 - img->data[y][x].red;
-            img->data[y][x].green = 255 - img->data[y][x].green;
-            img->data[y][x].blue = 255 - img->data[y][x].blue;
+            // Calculer la moyenne des trois canaux
+            uint8_t gray = (img->data[y][x].red + img->data[y][x].green + img->data[y][x].blue) / 3;
+            img->data[y][x].red = gray;
+            img->data[y][x].green = gray;
+            img->data[y][x].blue = gray;
         }
     }
 }
@@ -384,17 +512,196 @@ void bmp24_grayscale(t_bmp24* img) {
         return;
     }
 
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            // Calculer la moyenne des trois canaux
-            uint8_t gray = (img->data[y][x].red + img->data[y][x].green + img->data[y][x].blue) / 3;
-            img->data[y][x].red = gray;
-            img->data[y][x].green = gray;
-            img->data[y][x].blue = gray;
-        }
+    INSTRUMENT_BEGIN("bmp24_grayscale");
+
+    t_bmp24Job job = {.img = img};
+    threadpool_run(img->height, img->width, grayscaleBand, &job);
+    INSTRUMENT_END();
+}
+
+#if SIMD_X86
+/**
+ * @brief Luminance de 4 pixels RGB (12 premiers octets de v) sur 32 bits
+ *
+ * Les sommes pondérées sont exactes en entiers ; la division par
+ * BMP24_LUMA_SCALE se fait en flottant sur (somme + 500,5) : l'erreur
+ * relative (quelques 1e-7) reste loin de l'écart à l'entier le plus proche
+ * (0,0005), le résultat est donc celui de BMP24_LUMA.
+ */
+SIMD_TARGET("ssse3")
+static inline __m128i luma4_ssse3(__m128i v) {
+    const __m128i maskRG = _mm_setr_epi8(0, -1, 1, -1, 3, -1, 4, -1, 6, -1, 7, -1, 9, -1, 10, -1);
+    const __m128i maskB = _mm_setr_epi8(2, -1, -1, -1, 5, -1, -1, -1, 8, -1, -1, -1, 11, -1, -1, -1);
+    const __m128i weightsRG = _mm_setr_epi16(BMP24_LUMA_R, BMP24_LUMA_G, BMP24_LUMA_R, BMP24_LUMA_G,
+                                             BMP24_LUMA_R, BMP24_LUMA_G, BMP24_LUMA_R, BMP24_LUMA_G);
+    const __m128i weightB = _mm_set1_epi32(BMP24_LUMA_B);
+    __m128i sum = _mm_add_epi32(_mm_madd_epi16(_mm_shuffle_epi8(v, maskRG), weightsRG),
+                                _mm_madd_epi16(_mm_shuffle_epi8(v, maskB), weightB));
+    __m128 scaled = _mm_add_ps(_mm_cvtepi32_ps(sum), _mm_set1_ps(BMP24_LUMA_SCALE / 2 + 0.5f));
+    return _mm_cvttps_epi32(_mm_mul_ps(scaled, _mm_set1_ps(1.0f / BMP24_LUMA_SCALE)));
+}
+
+/**
+ * @brief Luminance de 16 pixels à la fois
+ * @return Nombre de pixels traités
+ */
+SIMD_TARGET("ssse3")
+static int lumaRow_ssse3(const unsigned char* row, unsigned char* out, int width) {
+    int x = 0;
+    // Le dernier chargement lit 4 octets au-delà des 16 pixels
+    for (; x + 18 <= width; x += 16) {
+        const unsigned char* p = row + x * 3;
+        __m128i a = luma4_ssse3(_mm_loadu_si128((const __m128i*)p));
+        __m128i b = luma4_ssse3(_mm_loadu_si128((const __m128i*)(p + 12)));
+        __m128i c = luma4_ssse3(_mm_loadu_si128((const __m128i*)(p + 24)));
+        __m128i d = luma4_ssse3(_mm_loadu_si128((const __m128i*)(p + 36)));
+        _mm_storeu_si128((__m128i*)(out + x), _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+    }
+    return x;
+}
+
+/**
+ * @brief Luminance de 8 pixels, 4 par moitié de registre (voir luma4_ssse3)
+ */
+SIMD_TARGET("avx2")
+static inline __m256i luma8_avx2(const unsigned char* p) {
+    const __m256i maskRG = _mm256_setr_epi8(0, -1, 1, -1, 3, -1, 4, -1, 6, -1, 7, -1, 9, -1, 10, -1,
+                                            0, -1, 1, -1, 3, -1, 4, -1, 6, -1, 7, -1, 9, -1, 10, -1);
+    const __m256i maskB = _mm256_setr_epi8(2, -1, -1, -1, 5, -1, -1, -1, 8, -1, -1, -1, 11, -1, -1, -1,
+                                           2, -1, -1, -1, 5, -1, -1, -1, 8, -1, -1, -1, 11, -1, -1, -1);
+    const __m256i weightsRG = _mm256_set1_epi32(BMP24_LUMA_R | (BMP24_LUMA_G << 16));
+    const __m256i weightB = _mm256_set1_epi32(BMP24_LUMA_B);
+    __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)p)),
+                                        _mm_loadu_si128((const __m128i*)(p + 12)), 1);
+    __m256i sum = _mm256_add_epi32(_mm256_madd_epi16(_mm256_shuffle_epi8(v, maskRG), weightsRG),
+                                   _mm256_madd_epi16(_mm256_shuffle_epi8(v, maskB), weightB));
+    __m256 scaled = _mm256_add_ps(_mm256_cvtepi32_ps(sum), _mm256_set1_ps(BMP24_LUMA_SCALE / 2 + 0.5f));
+    return _mm256_cvttps_epi32(_mm256_mul_ps(scaled, _mm256_set1_ps(1.0f / BMP24_LUMA_SCALE)));
+}
+
+/**
+ * @brief Luminance de 32 pixels à la fois
+ * @return Nombre de pixels traités
+ */
+SIMD_TARGET("avx2")
+static int lumaRow_avx2(const unsigned char* row, unsigned char* out, int width) {
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    int x = 0;
+    // Le dernier chargement lit 4 octets au-delà des 32 pixels
+    for (; x + 34 <= width; x += 32) {
+        const unsigned char* p = row + x * 3;
+        __m256i a = luma8_avx2(p);
+        __m256i b = luma8_avx2(p + 24);
+        __m256i c = luma8_avx2(p + 48);
+        __m256i d = luma8_avx2(p + 72);
+        // packs et packus travaillent par moitié : remettre les groupes de 4 dans l'ordre
+        __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+        _mm256_storeu_si256((__m256i*)(out + x), _mm256_permutevar8x32_epi32(packed, order));
+    }
+    return x;
+}
+#endif
+
+/**
+ * @brief Calcule la luminance BT.601 (BMP24_LUMA) d'une ligne de pixels
+ * @param row Ligne de pixels
+ * @param width Nombre de pixels
+ * @param out Destination de width octets
+ */
+void bmp24_lumaRow(const t_pixel* row, int width, unsigned char* out) {
+    int x = 0;
+
+#if SIMD_X86
+    int level = simd_level();
+    if (level >= SIMD_LEVEL_AVX2) {
+        x = lumaRow_avx2((const unsigned char*)row, out, width);
+    } else if (level >= SIMD_LEVEL_SSSE3) {
+        x = lumaRow_ssse3((const unsigned char*)row, out, width);
+    }
+#endif
+
+    for (; x < width; x++) {
+        out[x] = (unsigned char)BMP24_LUMA(row[x].red, row[x].green, row[x].blue);
     }
 }
 
+/**
+ * @brief Calcule la luminance des lignes [start, end) dans l'image 8 bits
+ *
+ * Les lignes de t_bmp8 sont de bas en haut, celles de t_bmp24 de haut en bas.
+ */
+static void toBmp8Band(int start, int end, int band, void* arg) {
+    t_bmp24Job* job = (t_bmp24Job*)arg;
+    t_bmp24* img = job->img;
+    (void)band;
+    for (int y = start; y < end; y++) {
+        bmp24_lumaRow(img->data[y], img->width, job->gray->data + (size_t)(img->height - 1 - y) * img->width);
+    }
+}
+
+/**
+ * @brief Convertit l'image en une image 8 bits en niveaux de gris
+ *
+ * Chaque pixel devient sa luminance BT.601 arrondie au plus proche
+ * (BMP24_LUMA, mi-chemin vers le haut), et l'image reçoit une palette de
+ * gris. Les versions SSE et AVX2 de bmp24_lumaRow donnent exactement
+ * BMP24_LUMA ; bmp24_equalize tranche autrement les valeurs x,5 (voir
+ * bmp24_equalizeIndex), ce qui peut décaler d'un niveau ces seuls pixels.
+ * Les traitements suivants portent alors sur un octet par pixel au lieu de trois.
+ *
+ * @param img Structure d'image
+ * @return Nouvelle image 8 bits (à libérer avec bmp8_free), NULL en cas d'erreur
+ */
+t_bmp8* bmp24_toBmp8(t_bmp24* img) {
+    if (!img || !img->data) {
+        printf("Erreur: Image invalide\n");
+        return NULL;
+    }
+
+    INSTRUMENT_BEGIN("bmp24_toBmp8");
+
+    t_bmp8* gray = (t_bmp8*)instrument_calloc(1, sizeof(t_bmp8));
+    if (!gray) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        INSTRUMENT_END();
+        return NULL;
+    }
+    gray->width = img->width;
+    gray->height = img->height;
+    gray->colorDepth = 8;
+    gray->dataSize = gray->width * gray->height;
+    gray->data = (unsigned char*)instrument_malloc(gray->dataSize);
+    if (!gray->data) {
+        printf("Erreur: Allocation mémoire pour les données échouée\n");
+        free(gray);
+        INSTRUMENT_END();
+        return NULL;
+    }
+
+    // En-tête et palette de gris ; les tailles sont complétées par bmp8_saveImage
+    unsigned char* header = gray->header;
+    *(uint16_t*)&header[0] = BMP_TYPE;
+    *(uint32_t*)&header[10] = 54 + 1024;
+    *(uint32_t*)&header[14] = INFO_SIZE;
+    *(int32_t*)&header[18] = img->width;
+    *(int32_t*)&header[22] = img->height;
+    *(uint16_t*)&header[26] = 1;
+    *(uint16_t*)&header[28] = 8;
+    *(int32_t*)&header[38] = img->header_info.xresolution;
+    *(int32_t*)&header[42] = img->header_info.yresolution;
+    *(uint32_t*)&header[46] = 256;
+    for (int i = 0; i < 256; i++) {
+        gray->colorTable[i * 4] = (unsigned char)i;
+        gray->colorTable[i * 4 + 1] = (unsigned char)i;
+        gray->colorTable[i * 4 + 2] = (unsigned char)i;
+    }
+
+    t_bmp24Job job = {.img = img, .gray = gray};
+    threadpool_run(img->height, img->width, toBmp8Band, &job);
+    INSTRUMENT_END();
+    return gray;
+}
+
 /**
  * @brief Ajuste la luminosité de l'image
  * @param img Structure d'image
@@ -406,27 +713,13 @@ void bmp24_brightness(t_bmp24* img, int value) {
         return;
     }
 
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            // Rouge
-            int newRed = img->data[y][x].red + value;
-            if (newRed > 255) newRed = 255;
-            if (newRed < 0) newRed = 0;
-            img->data[y][x].red = (uint8_t)newRed;
-
-            // Vert
-            int newGreen = img->data[y][x].green + value;
-            if (newGreen > 255) newGreen = 255;
-            if (newGreen < 0) newGreen = 0;
-            img->data[y][x].green = (uint8_t)newGreen;
-
-            // Bleu
-            int newBlue = img->data[y][x].blue + value;
-            if (newBlue > 255) newBlue = 255;
-            if (newBlue < 0) newBlue = 0;
-            img->data[y][x].blue = (uint8_t)newBlue;
-        }
-    }
+    INSTRUMENT_BEGIN("bmp24_brightness");
+
+    t_lut lut;
+    lut_identity(&lut);
+    lut_brightness(&lut, LUT_ALL, value);
+    bmp24_applyLUT(img, &lut);
+    INSTRUMENT_END();
 }
 
 /**
@@ -477,9 +770,9 @@ t_pixel bmp24_convolution(t_bmp24* img, int x, int y, float** kernel, int kernel
 
 // Fonction utilitaire pour créer un noyau
 float** createKernel(int size) {
-    float** kernel = (float**)malloc(size * sizeof(float*));
+    float** kernel = (float**)instrument_malloc(size * sizeof(float*));
     for (int i = 0; i < size; i++) {
-        kernel[i] = (float*)malloc(size * sizeof(float));
+        kernel[i] = (float*)instrument_malloc(size * sizeof(float));
     }
     return kernel;
 }
@@ -493,225 +786,409 @@ void freeKernel(float** kernel, int size) {
 }
 
 /**
- * @brief Applique un flou simple (box blur)
- * @param img Structure d'image
+ * @brief Recopie la bordure de n pixels d'une image dans une autre
+ *
+ * Ces pixels n'ont pas de voisinage complet et ne sont pas modifiés par
+ * les filtres : ils sont traités à part, hors de la boucle de convolution.
+ *
+ * @param dst Image de destination (mêmes dimensions)
+ * @param src Image source
+ * @param n Épaisseur de la bordure
  */
-void bmp24_boxBlur(t_bmp24* img) {
-    if (!img || !img->data) return;
-
-    float** kernel = createKernel(3);
-    for (int i = 0; i < 3; i++) {
-        for (int j = 0; j < 3; j++) {
-            kernel[i][j] = 1.0f / 9.0f;
+static void bmp24_copyBorder(t_bmp24* dst, t_bmp24* src, int n) {
+    for (int y = 0; y < src->height; y++) {
+        if (y < n || y >= src->height - n || src->width <= 2 * n) {
+            memcpy(dst->data[y], src->data[y], src->width * sizeof(t_pixel));
+        } else {
+            memcpy(dst->data[y], src->data[y], n * sizeof(t_pixel));
+            memcpy(dst->data[y] + src->width - n, src->data[y] + src->width - n, n * sizeof(t_pixel));
         }
     }
+}
 
-    // Créer une copie pour stocker le résultat
-    t_bmp24* temp = bmp24_allocate(img->width, img->height, img->colorDepth);
-    if (!temp) {
-        freeKernel(kernel, 3);
-        return;
-    }
 
-    // Appliquer le filtre
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            temp->data[y][x] = bmp24_convolution(img, x, y, kernel, 3);
+/**
+ * @brief Convolution pixel par pixel des lignes [start, end) vers job->out
+ */
+static void convolutionBand(int start, int end, int band, void* arg) {
+    t_bmp24Job* job = (t_bmp24Job*)arg;
+    (void)band;
+    for (int y = start; y < end; y++) {
+        for (int x = 0; x < job->img->width; x++) {
+            job->out->data[y][x] = bmp24_convolution(job->img, x, y, job->kernel, job->kernelSize);
         }
     }
+}
 
-    // Copier le résultat
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            img->data[y][x] = temp->data[y][x];
-        }
+/**
+ * @brief Applique un filtre de convolution de src vers dst
+ *
+ * Pour un noyau 3x3, les pixels entrelacés sont traités comme un plan
+ * d'octets où deux voisins d'un même canal sont séparés de 3 octets : les
+ * lignes entières passent dans les noyaux vectorisés de convolution.c, sans
+ * appel par pixel ni test de bord. Le résultat est identique à celui de
+ * bmp24_convolution. Tous les pixels de dst sont écrits (la bordure est
+ * recopiée de src) : une chaîne de filtres peut alterner entre deux images
+ * sans allocation ni copie.
+ *
+ * @param src Image source
+ * @param dst Image destination, distincte de src et de mêmes dimensions
+ * @param kernel Noyau de convolution
+ * @param kernelSize Taille du noyau (doit être impaire)
+ */
+void bmp24_applyFilterTo(t_bmp24* src, t_bmp24* dst, float** kernel, int kernelSize) {
+    if (!src || !src->data || !dst || !dst->data || !kernel || src == dst) {
+        printf("Erreur: Paramètres invalides\n");
+        return;
+    }
+    if (dst->width != src->width || dst->height != src->height) {
+        printf("Erreur: Dimensions incompatibles\n");
+        return;
     }
 
-    bmp24_free(temp);
-    freeKernel(kernel, 3);
+    INSTRUMENT_BEGIN("bmp24_applyFilterTo");
+
+    if (kernelSize == 3) {
+        bmp24_copyBorder(dst, src, 1);
+        conv_filter3x3((unsigned char*)src->data[0], (unsigned char*)dst->data[0], src->stride,
+                       src->width, src->height, 3, kernel);
+    } else {
+        t_bmp24Job job = {.img = src, .out = dst, .kernel = kernel, .kernelSize = kernelSize};
+        threadpool_run(src->height, src->width * kernelSize, convolutionBand, &job);
+    }
+    INSTRUMENT_END();
 }
 
 /**
- * @brief Applique un flou gaussien
+ * @brief Applique un filtre de convolution sur toute l'image
+ *
+ * Le résultat est calculé dans une image temporaire dont les pixels sont
+ * ensuite échangés avec ceux de img, sans recopie.
+ *
  * @param img Structure d'image
+ * @param kernel Noyau de convolution
+ * @param kernelSize Taille du noyau (doit être impaire)
  */
-void bmp24_gaussianBlur(t_bmp24* img) {
-    if (!img || !img->data) return;
+void bmp24_applyFilter(t_bmp24* img, float** kernel, int kernelSize) {
+    if (!img || !img->data || !kernel) {
+        printf("Erreur: Paramètres invalides\n");
+        return;
+    }
 
-    float** kernel = createKernel(3);
-    kernel[0][0] = 1.0f/16; kernel[0][1] = 2.0f/16; kernel[0][2] = 1.0f/16;
-    kernel[1][0] = 2.0f/16; kernel[1][1] = 4.0f/16; kernel[1][2] = 2.0f/16;
-    kernel[2][0] = 1.0f/16; kernel[2][1] = 2.0f/16; kernel[2][2] = 1.0f/16;
+    INSTRUMENT_BEGIN("bmp24_applyFilter");
 
     t_bmp24* temp = bmp24_allocate(img->width, img->height, img->colorDepth);
     if (!temp) {
-        freeKernel(kernel, 3);
+        INSTRUMENT_END();
         return;
     }
 
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            temp->data[y][x] = bmp24_convolution(img, x, y, kernel, 3);
-        }
+    bmp24_applyFilterTo(img, temp, kernel, kernelSize);
+    bmp24_swapPixels(img, temp);
+    bmp24_free(temp);
+    INSTRUMENT_END();
+}
+
+/**
+ * @brief Applique une suite de filtres 3x3, tuile par tuile
+ *
+ * Chaque tuile de l'image passe par tous les filtres pendant qu'elle est
+ * en cache ; seul le résultat final est écrit en mémoire
+ * (conv_filter3x3Chain). Le résultat est identique à des appels successifs
+ * à bmp24_applyFilter.
+ *
+ * @param img Pointeur vers l'image
+ * @param kernels Noyaux 3x3, dans l'ordre d'application
+ * @param count Nombre de noyaux
+ */
+void bmp24_applyFilterChain(t_bmp24* img, float** kernels[], int count) {
+    if (!img || !img->data || !kernels || count < 0) {
+        printf("Erreur: Paramètres invalides\n");
+        return;
     }
+    if (count == 0) return;
 
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            img->data[y][x] = temp->data[y][x];
+    INSTRUMENT_BEGIN("bmp24_applyFilterChain");
+
+    t_bmp24* temp = bmp24_allocate(img->width, img->height, img->colorDepth);
+    if (!temp) {
+        INSTRUMENT_END();
+        return;
+    }
+
+    // Les suites plus longues que CONV_CHAIN_MAX_STAGES sont traitées en plusieurs parcours
+    for (int first = 0; first < count; first += CONV_CHAIN_MAX_STAGES) {
+        t_convStage stages[CONV_CHAIN_MAX_STAGES];
+        int n = (count - first < CONV_CHAIN_MAX_STAGES) ? count - first : CONV_CHAIN_MAX_STAGES;
+        for (int i = 0; i < n; i++) {
+            stages[i].kernel = kernels[first + i];
+            stages[i].lut = NULL;
         }
+        conv_filter3x3Chain((unsigned char*)img->data[0], (unsigned char*)temp->data[0], img->stride,
+                            img->width, img->height, 3, stages, n, NULL);
+        bmp24_swapPixels(img, temp);
     }
 
     bmp24_free(temp);
-    freeKernel(kernel, 3);
+    INSTRUMENT_END();
 }
 
 /**
- * @brief Applique un filtre de détection de contours
+ * @brief Applique un noyau entier en arithmétique entière sur toute l'image
+ *
+ * Les trois canaux sont traités ensemble comme pour bmp24_applyFilter ; le
+ * résultat ne dépend ni du compilateur ni des instructions disponibles.
+ *
  * @param img Structure d'image
+ * @param kernel Noyau entier (voir createBoxBlurIntKernel)
  */
-void bmp24_outline(t_bmp24* img) {
-    if (!img || !img->data) return;
+void bmp24_applyIntFilter(t_bmp24* img, const t_intKernel* kernel) {
+    if (!img || !img->data || !kernel) {
+        printf("Erreur: Paramètres invalides\n");
+        return;
+    }
 
-    float** kernel = createKernel(3);
-    kernel[0][0] = -1; kernel[0][1] = -1; kernel[0][2] = -1;
-    kernel[1][0] = -1; kernel[1][1] = 8;  kernel[1][2] = -1;
-    kernel[2][0] = -1; kernel[2][1] = -1; kernel[2][2] = -1;
+    INSTRUMENT_BEGIN("bmp24_applyIntFilter");
 
     t_bmp24* temp = bmp24_allocate(img->width, img->height, img->colorDepth);
     if (!temp) {
-        freeKernel(kernel, 3);
+        INSTRUMENT_END();
         return;
     }
 
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            temp->data[y][x] = bmp24_convolution(img, x, y, kernel, 3);
-        }
+    bmp24_copyBorder(temp, img, kernel->size / 2);
+    conv_filterInt((unsigned char*)img->data[0], (unsigned char*)temp->data[0], img->stride,
+                   img->width, img->height, 3, kernel);
+
+    bmp24_swapPixels(img, temp);
+    bmp24_free(temp);
+    INSTRUMENT_END();
+}
+
+/**
+ * @brief Applique un filtre séparable en deux passes 1D (ligne puis colonne)
+ *
+ * Les trois canaux sont traités ensemble, directement sur les pixels
+ * entrelacés du tampon contigu.
+ *
+ * @param img Structure d'image
+ * @param kernel Noyau séparable (voir createSeparableGaussianKernel)
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int bmp24_applySeparableFilter(t_bmp24* img, const t_separableKernel* kernel) {
+    if (!img || !img->data || !kernel) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
     }
 
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            img->data[y][x] = temp->data[y][x];
-        }
+    INSTRUMENT_BEGIN("bmp24_applySeparableFilter");
+
+    int result = conv_separable((unsigned char*)img->data[0], img->stride, img->width, img->height, 3,
+                                kernel, NULL);
+    INSTRUMENT_END();
+    return result;
+}
+
+/**
+ * @brief Applique un flou simple de rayon quelconque en temps constant par pixel
+ *
+ * Contrairement à bmp24_boxBlur, aucun noyau ni image temporaire n'est
+ * construit : le flou utilise des sommes glissantes.
+ *
+ * @param img Structure d'image
+ * @param radius Rayon du flou (fenêtre de 2 * radius + 1 pixels de côté)
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int bmp24_boxBlurRadius(t_bmp24* img, int radius) {
+    if (!img || !img->data) {
+        printf("Erreur: Image invalide\n");
+        return -1;
     }
 
-    bmp24_free(temp);
-    freeKernel(kernel, 3);
+    INSTRUMENT_BEGIN("bmp24_boxBlurRadius");
+
+    int result = conv_boxBlur((unsigned char*)img->data[0], img->stride, img->width, img->height, 3,
+                              radius, NULL);
+    INSTRUMENT_END();
+    return result;
 }
 
 /**
- * @brief Applique un filtre de relief
+ * @brief Applique un filtre médian de rayon quelconque en temps constant par pixel
+ *
+ * Chaque canal est filtré séparément. Le médian supprime le bruit
+ * impulsionnel en préservant les contours ; la bordure de radius pixels
+ * n'est pas modifiée.
+ *
  * @param img Structure d'image
+ * @param radius Rayon du filtre (fenêtre de 2 * radius + 1 pixels de côté)
+ * @return 0 en cas de succès, -1 en cas d'erreur
  */
-void bmp24_emboss(t_bmp24* img) {
-    if (!img || !img->data) return;
+int bmp24_medianFilter(t_bmp24* img, int radius) {
+    if (!img || !img->data) {
+        printf("Erreur: Image invalide\n");
+        return -1;
+    }
+    if (radius == 0) return 0;
 
-    float** kernel = createKernel(3);
-    kernel[0][0] = -2; kernel[0][1] = -1; kernel[0][2] = 0;
-    kernel[1][0] = -1; kernel[1][1] = 1;  kernel[1][2] = 1;
-    kernel[2][0] = 0;  kernel[2][1] = 1;  kernel[2][2] = 2;
+    INSTRUMENT_BEGIN("bmp24_medianFilter");
 
     t_bmp24* temp = bmp24_allocate(img->width, img->height, img->colorDepth);
     if (!temp) {
-        freeKernel(kernel, 3);
-        return;
+        INSTRUMENT_END();
+        return -1;
     }
 
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            temp->data[y][x] = bmp24_convolution(img, x, y, kernel, 3);
-        }
+    bmp24_copyBorder(temp, img, radius);
+    int result = conv_median((unsigned char*)img->data[0], (unsigned char*)temp->data[0], img->stride,
+                             img->width, img->height, 3, radius, NULL);
+    if (result == 0) {
+        bmp24_swapPixels(img, temp);
     }
+    bmp24_free(temp);
+    INSTRUMENT_END();
+    return result;
+}
 
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            img->data[y][x] = temp->data[y][x];
+/**
+ * @brief Applique un flou simple (box blur)
+ * @param img Structure d'image
+ */
+void bmp24_boxBlur(t_bmp24* img) {
+    if (!img || !img->data) return;
+
+    INSTRUMENT_BEGIN("bmp24_boxBlur");
+
+    // Noyau sur la pile : aucune allocation
+    float rows[3][3];
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            rows[i][j] = 1.0f / 9.0f;
         }
     }
+    float* kernel[3] = {rows[0], rows[1], rows[2]};
 
-    bmp24_free(temp);
-    freeKernel(kernel, 3);
+    bmp24_applyFilter(img, kernel, 3);
+    INSTRUMENT_END();
 }
 
 /**
- * @brief Applique un filtre de netteté
+ * @brief Applique un flou gaussien
  * @param img Structure d'image
  */
-void bmp24_sharpen(t_bmp24* img) {
+void bmp24_gaussianBlur(t_bmp24* img) {
     if (!img || !img->data) return;
 
-    float** kernel = createKernel(3);
-    kernel[0][0] = 0;  kernel[0][1] = -1; kernel[0][2] = 0;
-    kernel[1][0] = -1; kernel[1][1] = 5;  kernel[1][2] = -1;
-    kernel[2][0] = 0;  kernel[2][1] = -1; kernel[2][2] = 0;
+    INSTRUMENT_BEGIN("bmp24_gaussianBlur");
 
-    t_bmp24* temp = bmp24_allocate(img->width, img->height, img->colorDepth);
-    if (!temp) {
-        freeKernel(kernel, 3);
-        return;
-    }
+    float rows[3][3] = {
+        {1.0f/16, 2.0f/16, 1.0f/16},
+        {2.0f/16, 4.0f/16, 2.0f/16},
+        {1.0f/16, 2.0f/16, 1.0f/16}
+    };
+    float* kernel[3] = {rows[0], rows[1], rows[2]};
 
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            temp->data[y][x] = bmp24_convolution(img, x, y, kernel, 3);
-        }
-    }
+    bmp24_applyFilter(img, kernel, 3);
+    INSTRUMENT_END();
+}
 
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            img->data[y][x] = temp->data[y][x];
-        }
-    }
+/**
+ * @brief Applique un filtre de détection de contours
+ * @param img Structure d'image
+ */
+void bmp24_outline(t_bmp24* img) {
+    if (!img || !img->data) return;
 
-    bmp24_free(temp);
-    freeKernel(kernel, 3);
+    INSTRUMENT_BEGIN("bmp24_outline");
+
+    float rows[3][3] = {
+        {-1, -1, -1},
+        {-1, 8, -1},
+        {-1, -1, -1}
+    };
+    float* kernel[3] = {rows[0], rows[1], rows[2]};
+
+    bmp24_applyFilter(img, kernel, 3);
+    INSTRUMENT_END();
 }
 
 /**
- * @brief Applique l'égalisation d'histogramme sur une image couleur
+ * @brief Applique un filtre de relief
  * @param img Structure d'image
  */
-void bmp24_equalize(t_bmp24* img) {
-    if (!img || !img->data) {
-        printf("Erreur: Image invalide\n");
-        return;
-    }
+void bmp24_emboss(t_bmp24* img) {
+    if (!img || !img->data) return;
 
-    // Tableaux pour stocker les composantes YUV
-    float** Y = (float**)malloc(img->height * sizeof(float*));
-    float** U = (float**)malloc(img->height * sizeof(float*));
-    float** V = (float**)malloc(img->height * sizeof(float*));
+    INSTRUMENT_BEGIN("bmp24_emboss");
 
-    for (int i = 0; i < img->height; i++) {
-        Y[i] = (float*)malloc(img->width * sizeof(float));
-        U[i] = (float*)malloc(img->width * sizeof(float));
-        V[i] = (float*)malloc(img->width * sizeof(float));
-    }
+    float rows[3][3] = {
+        {-2, -1, 0},
+        {-1, 1, 1},
+        {0, 1, 2}
+    };
+    float* kernel[3] = {rows[0], rows[1], rows[2]};
 
-    // Convertir RGB vers YUV
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            float R = img->data[y][x].red;
-            float G = img->data[y][x].green;
-            float B = img->data[y][x].blue;
+    bmp24_applyFilter(img, kernel, 3);
+    INSTRUMENT_END();
+}
 
-            Y[y][x] = 0.299f * R + 0.587f * G + 0.114f * B;
-            U[y][x] = -0.14713f * R - 0.28886f * G + 0.436f * B;
-            V[y][x] = 0.615f * R - 0.51499f * G - 0.10001f * B;
-        }
+/**
+ * @brief Applique un filtre de netteté
+ * @param img Structure d'image
+ */
+void bmp24_sharpen(t_bmp24* img) {
+    if (!img || !img->data) return;
+
+    INSTRUMENT_BEGIN("bmp24_sharpen");
+
+    float rows[3][3] = {
+        {0, -1, 0},
+        {-1, 5, -1},
+        {0, -1, 0}
+    };
+    float* kernel[3] = {rows[0], rows[1], rows[2]};
+
+    bmp24_applyFilter(img, kernel, 3);
+    INSTRUMENT_END();
+}
+
+/**
+ * @brief Ajoute la luminance (Y) d'une ligne de pixels à un histogramme
+ * @param row Ligne de pixels
+ * @param width Nombre de pixels de la ligne
+ * @param hist Histogramme de 256 entrées à compléter
+ */
+void bmp24_computeLumaHistogram(t_pixel* row, int width, unsigned int* hist) {
+    for (int x = 0; x < width; x++) {
+        hist[bmp24_lumaIndex(row[x].red, row[x].green, row[x].blue)]++;
     }
+}
 
-    // Calculer l'histogramme de la composante Y
-    unsigned int hist[256] = {0};
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            int yValue = (int)round(Y[y][x]);
-            if (yValue < 0) yValue = 0;
-            if (yValue > 255) yValue = 255;
-            hist[yValue]++;
-        }
+/**
+ * @brief Remplace la luminance d'une ligne de pixels via une table d'égalisation
+ *
+ * Dans la conversion YUV, U et V ne dépendent pas de Y et la reconversion
+ * en RGB ajoute Y à chaque canal : remplacer Y par lut[Y] revient donc à
+ * ajouter lut[Y] - Y aux trois canaux. Le calcul est fait en entiers, avec
+ * la luminance exacte (non arrondie) multipliée par BMP24_LUMA_SCALE.
+ *
+ * @param row Ligne de pixels
+ * @param width Nombre de pixels de la ligne
+ * @param lut Table de 256 entrées (histogramme égalisé)
+ */
+void bmp24_equalizeRow(t_pixel* row, int width, const unsigned int* lut) {
+    for (int x = 0; x < width; x++) {
+        bmp24_equalizePixel(&row[x].red, &row[x].green, &row[x].blue, lut);
     }
+}
 
+/**
+ * @brief Construit la table d'égalisation à partir de l'histogramme de la luminance
+ * @param hist Histogramme de 256 entrées
+ * @param pixelCount Nombre de pixels de l'image
+ * @param map Table de 256 entrées à remplir
+ */
+void bmp24_computeEqualizationMap(const unsigned int* hist, unsigned int pixelCount, unsigned int* map) {
     // Calculer la CDF
     unsigned int cdf[256];
     cdf[0] = hist[0];
@@ -729,58 +1206,172 @@ void bmp24_equalize(t_bmp24* img) {
     }
 
     // Normaliser la CDF
-    unsigned int N = img->width * img->height;
-    unsigned int hist_eq[256];
+    unsigned int N = pixelCount;
     for (int i = 0; i < 256; i++) {
         if (N > cdf_min) {
-            hist_eq[i] = round(((double)(cdf[i] - cdf_min) / (N - cdf_min)) * 255);
+            map[i] = round(((double)(cdf[i] - cdf_min) / (N - cdf_min)) * 255);
         } else {
-            hist_eq[i] = 0;
+            map[i] = 0;
         }
     }
+}
 
-    // Appliquer l'égalisation à la composante Y
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            int yValue = (int)round(Y[y][x]);
-            if (yValue < 0) yValue = 0;
-            if (yValue > 255) yValue = 255;
-            Y[y][x] = (float)hist_eq[yValue];
+/**
+ * @brief Histogramme partiel de luminance des lignes [start, end), dans job->hist[band]
+ */
+static void lumaHistogramBand(int start, int end, int band, void* arg) {
+    t_bmp24Job* job = (t_bmp24Job*)arg;
+    for (int y = start; y < end; y++) {
+        bmp24_computeLumaHistogram(job->img->data[y], job->img->width, job->hist[band]);
+    }
+}
+
+/**
+ * @brief Égalisation des lignes [start, end) via job->map
+ */
+static void equalizeBand(int start, int end, int band, void* arg) {
+    t_bmp24Job* job = (t_bmp24Job*)arg;
+    (void)band;
+    for (int y = start; y < end; y++) {
+        bmp24_equalizeRow(job->img->data[y], job->img->width, job->map);
+    }
+}
+
+/**
+ * @brief Applique l'égalisation d'histogramme sur une image couleur
+ *
+ * Deux passes : l'histogramme de la luminance est construit directement à
+ * partir des pixels RGB, puis chaque ligne est reconvertie via la table
+ * d'égalisation. Tout le calcul est fait en entiers et sans allocation :
+ * les histogrammes partiels (un par bande) sont sur la pile.
+ *
+ * @param img Structure d'image
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int bmp24_equalize(t_bmp24* img) {
+    if (!img || !img->data) {
+        printf("Erreur: Image invalide\n");
+        return -1;
+    }
+
+    INSTRUMENT_BEGIN("bmp24_equalize");
+
+    // Calculer l'histogramme de la composante Y (un histogramme partiel par bande)
+    unsigned int partial[THREADPOOL_MAX_THREADS][256];
+    memset(partial, 0, sizeof(partial));
+
+    t_bmp24Job job = {.img = img, .hist = partial};
+    int bands = threadpool_run(img->height, img->width, lumaHistogramBand, &job);
+
+    unsigned int hist[256] = {0};
+    for (int b = 0; b < bands; b++) {
+        for (int i = 0; i < 256; i++) {
+            hist[i] += partial[b][i];
         }
     }
 
-    // Convertir YUV vers RGB
-    for (int y = 0; y < img->height; y++) {
-        for (int x = 0; x < img->width; x++) {
-            float yVal = Y[y][x];
-            float uVal = U[y][x];
-            float vVal = V[y][x];
-
-            float R = yVal + 1.13983f * vVal;
-            float G = yVal - 0.39465f * uVal - 0.58060f * vVal;
-            float B = yVal + 2.03211f * uVal;
-
-            // Limiter les valeurs
-            if (R < 0) R = 0;
-            if (R > 255) R = 255;
-            if (G < 0) G = 0;
-            if (G > 255) G = 255;
-            if (B < 0) B = 0;
-            if (B > 255) B = 255;
-
-            img->data[y][x].red = (uint8_t)round(R);
-            img->data[y][x].green = (uint8_t)round(G);
-            img->data[y][x].blue = (uint8_t)round(B);
+    unsigned int hist_eq[256];
+    bmp24_computeEqualizationMap(hist, img->width * img->height, hist_eq);
+
+    // Appliquer l'égalisation ligne par ligne
+    job.map = hist_eq;
+    threadpool_run(img->height, img->width, equalizeBand, &job);
+    INSTRUMENT_END();
+    return 0;
+}
+
+/**
+ * @brief Histogrammes de luminance et tables des tuiles [start, end) de l'égalisation adaptative
+ */
+static void claheTileBand(int start, int end, int band, void* arg) {
+    t_bmp24Job* job = (t_bmp24Job*)arg;
+    t_bmp24* img = job->img;
+    (void)band;
+
+    for (int t = start; t < end; t++) {
+        int x0, y0, x1, y1;
+        clahe_tileBounds(job->clahe, t, &x0, &y0, &x1, &y1);
+
+        unsigned int hist[256] = {0};
+        for (int y = y0; y < y1; y++) {
+            bmp24_computeLumaHistogram(img->data[y] + x0, x1 - x0, hist);
         }
+        clahe_setTileHistogram(job->clahe, t, hist, job->clipLimit);
     }
+}
+
+/**
+ * @brief Égalisation adaptative de la luminance des lignes [start, end)
+ *
+ * Comme pour bmp24_equalizeRow, la différence entre la luminance égalisée
+ * et la luminance exacte est ajoutée aux trois canaux. L'indice de luminance
+ * est celui des histogrammes des tuiles (bmp24_equalizeIndex). Les luminances
+ * sont traitées par blocs de 256 pixels pour rester sur la pile.
+ */
+static void claheMapBand(int start, int end, int band, void* arg) {
+    t_bmp24Job* job = (t_bmp24Job*)arg;
+    t_bmp24* img = job->img;
+    (void)band;
+
+    int scaled[256];
+    unsigned char luma[256];
+    unsigned char target[256];
+    t_claheRow rowLuts;
+
+    for (int y = start; y < end; y++) {
+        t_pixel* row = img->data[y];
+        clahe_prepareRow(job->clahe, y, rowLuts);
+        for (int x = 0; x < img->width; x += 256) {
+            int count = (img->width - x < 256) ? img->width - x : 256;
+            t_pixel* pixels = row + x;
+
+            for (int i = 0; i < count; i++) {
+                scaled[i] = BMP24_LUMA_SCALED(pixels[i].red, pixels[i].green, pixels[i].blue);
+                luma[i] = (unsigned char)bmp24_equalizeIndex(pixels[i].red, pixels[i].green, pixels[i].blue, scaled[i]);
+            }
+
+            clahe_mapRow(job->clahe, rowLuts, x, count, luma, target);
+
+            for (int i = 0; i < count; i++) {
+                bmp24_setLuma(&pixels[i].red, &pixels[i].green, &pixels[i].blue, scaled[i], target[i]);
+            }
+        }
+    }
+}
 
-    // Libérer la mémoire
-    for (int i = 0; i < img->height; i++) {
-        free(Y[i]);
-        free(U[i]);
-        free(V[i]);
+/**
+ * @brief Applique une égalisation adaptative à contraste limité (CLAHE) à la luminance
+ *
+ * Les histogrammes de luminance des tuiles sont calculés en parallèle, puis
+ * la luminance de chaque pixel est égalisée par interpolation bilinéaire
+ * entre les tables des tuiles voisines (voir clahe.h).
+ *
+ * @param img Structure d'image
+ * @param tilesX Nombre de tuiles en largeur (0 pour CLAHE_DEFAULT_TILES)
+ * @param tilesY Nombre de tuiles en hauteur (0 pour CLAHE_DEFAULT_TILES)
+ * @param clipLimit Limite de contraste relative (2 à 4 en général), 0 pour ne pas limiter
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int bmp24_clahe(t_bmp24* img, int tilesX, int tilesY, float clipLimit) {
+    if (!img || !img->data) {
+        printf("Erreur: Image invalide\n");
+        return -1;
     }
-    free(Y);
-    free(U);
-    free(V);
-}
\ No newline at end of file
+
+    INSTRUMENT_BEGIN("bmp24_clahe");
+
+    t_clahe* clahe = clahe_create(img->width, img->height, tilesX, tilesY);
+    if (!clahe) {
+        INSTRUMENT_END();
+        return -1;
+    }
+
+    int tiles = clahe->tilesX * clahe->tilesY;
+    t_bmp24Job job = {.img = img, .clahe = clahe, .clipLimit = clipLimit};
+    threadpool_run(tiles, (int)((long long)img->width * img->height / tiles), claheTileBand, &job);
+    threadpool_run(img->height, img->width, claheMapBand, &job);
+
+    clahe_free(clahe);
+    INSTRUMENT_END();
+    return 0;
+}
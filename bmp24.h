@@ -6,6 +6,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include "filters.h"
+#include "lut.h"
+#include "bmp8.h"
 
 
 // Constantes pour les offsets des champs de l'en-tête BMP
@@ -25,6 +28,81 @@
 #define INFO_SIZE 0x28
 #define DEFAULT_DEPTH 0x18
 
+// Alignement (en octets) du tampon de pixels d'une image 24 bits
+#define BMP24_ALIGNMENT 64
+
+// Taille d'une ligne de pixels alignée sur 4 octets, comme dans le fichier BMP
+#define BMP24_STRIDE(width) ((((width) * 3) + 3) & ~3)
+
+// Luminance BT.601 en entiers : Y = (299 R + 587 G + 114 B) / 1000, sans erreur d'arrondi
+#define BMP24_LUMA_R 299
+#define BMP24_LUMA_G 587
+#define BMP24_LUMA_B 114
+#define BMP24_LUMA_SCALE 1000
+
+// Luminance multipliée par BMP24_LUMA_SCALE, puis arrondie à l'entier (0 à 255)
+#define BMP24_LUMA_SCALED(r, g, b) (BMP24_LUMA_R * (r) + BMP24_LUMA_G * (g) + BMP24_LUMA_B * (b))
+#define BMP24_LUMA(r, g, b) ((BMP24_LUMA_SCALED(r, g, b) + BMP24_LUMA_SCALE / 2) / BMP24_LUMA_SCALE)
+
+// Coefficients 0.299f, 0.587f et 0.114f exprimés exactement en unités de 2^-27
+#define BMP24_LUMA_FLOAT_SHIFT 27
+#define BMP24_LUMA_FLOAT_R 40131100LL
+#define BMP24_LUMA_FLOAT_G 78785808LL
+#define BMP24_LUMA_FLOAT_B 15300821LL
+
+// Arrondit une valeur positive (en unités de 2^-27) au float le plus proche, à mantisse paire en cas d'égalité
+static inline int64_t bmp24_roundToFloat(int64_t value) {
+    int shift = 0;
+    while ((value >> shift) >= (1LL << 24)) shift++;
+    if (shift == 0) return value;
+
+    int64_t half = 1LL << (shift - 1);
+    int64_t rest = value & ((1LL << shift) - 1);
+    int64_t kept = value >> shift;
+    if (rest > half || (rest == half && (kept & 1))) kept++;
+    return kept << shift;
+}
+
+// Indice de luminance utilisé par l'égalisation : BMP24_LUMA, sauf pour les valeurs
+// tombant exactement à mi-chemin (x,5), tranchées comme round(0.299f R + 0.587f G + 0.114f B).
+// Ce calcul flottant est reproduit en entiers, opération par opération (vérifié sur les 256^3 couleurs).
+static inline int bmp24_equalizeIndex(int r, int g, int b, int scaled) {
+    if (scaled % BMP24_LUMA_SCALE != BMP24_LUMA_SCALE / 2) {
+        return (scaled + BMP24_LUMA_SCALE / 2) / BMP24_LUMA_SCALE;
+    }
+    int64_t sum = bmp24_roundToFloat(bmp24_roundToFloat(BMP24_LUMA_FLOAT_R * r) + bmp24_roundToFloat(BMP24_LUMA_FLOAT_G * g));
+    sum = bmp24_roundToFloat(sum + bmp24_roundToFloat(BMP24_LUMA_FLOAT_B * b));
+    return (int)((sum + (1LL << (BMP24_LUMA_FLOAT_SHIFT - 1))) >> BMP24_LUMA_FLOAT_SHIFT);
+}
+
+// Ajoute un décalage (multiplié par BMP24_LUMA_SCALE) à un canal, arrondit et ramène entre 0 et 255
+static inline uint8_t bmp24_shiftChannel(int channel, int delta) {
+    int value = channel * BMP24_LUMA_SCALE + delta;
+    if (value < 0) return 0;
+    value /= BMP24_LUMA_SCALE;
+    return value > 255 ? 255 : (uint8_t)value;
+}
+
+// Indice de luminance d'un pixel pour les histogrammes et tables d'égalisation
+static inline int bmp24_lumaIndex(int r, int g, int b) {
+    return bmp24_equalizeIndex(r, g, b, BMP24_LUMA_SCALED(r, g, b));
+}
+
+// Remplace la luminance exacte (scaled, multipliée par BMP24_LUMA_SCALE) d'un pixel par target,
+// en ajoutant la différence arrondie aux trois canaux
+static inline void bmp24_setLuma(uint8_t* r, uint8_t* g, uint8_t* b, int scaled, int target) {
+    int delta = target * BMP24_LUMA_SCALE - scaled + BMP24_LUMA_SCALE / 2;
+    *r = bmp24_shiftChannel(*r, delta);
+    *g = bmp24_shiftChannel(*g, delta);
+    *b = bmp24_shiftChannel(*b, delta);
+}
+
+// Égalise un pixel via une table de 256 entrées indexée par bmp24_lumaIndex
+static inline void bmp24_equalizePixel(uint8_t* r, uint8_t* g, uint8_t* b, const unsigned int* lut) {
+    int scaled = BMP24_LUMA_SCALED(*r, *g, *b);
+    bmp24_setLuma(r, g, b, scaled, (int)lut[bmp24_equalizeIndex(*r, *g, *b, scaled)]);
+}
+
 // Structure pour l'en-tête BMP
 typedef struct {
     uint16_t type;
@@ -63,7 +141,8 @@ typedef struct {
     int width;
     int height;
     int colorDepth;
-    t_pixel **data;
+    int stride;          // Nombre d'octets entre deux lignes de data
+    t_pixel **data;      // Pointeurs de lignes vers un tampon contigu unique
 } t_bmp24;
 
 // Fonctions d'allocation et de libération
@@ -71,19 +150,34 @@ t_pixel** bmp24_allocateDataPixels(int width, int height);
 void bmp24_freeDataPixels(t_pixel** pixels, int height);
 t_bmp24* bmp24_allocate(int width, int height, int colorDepth);
 void bmp24_free(t_bmp24* img);
+void bmp24_copyPixels(t_bmp24* dst, t_bmp24* src);
+void bmp24_swapPixels(t_bmp24* a, t_bmp24* b);
 
 // Fonctions de lecture et écriture
 t_bmp24* bmp24_loadImage(const char* filename);
-void bmp24_saveImage(t_bmp24* img, const char* filename);
+int bmp24_saveImage(t_bmp24* img, const char* filename);
 void bmp24_printInfo(t_bmp24* img);
+int bmp24_readPixelData(t_bmp24* img, FILE* file);
+int bmp24_writePixelData(t_bmp24* img, FILE* file);
+void bmp24_swapRedBlue(unsigned char* row, int width);
 
 // Fonctions de traitement d'image
+void bmp24_applyLUT(t_bmp24* img, const t_lut* lut);
 void bmp24_negative(t_bmp24* img);
 void bmp24_grayscale(t_bmp24* img);
+void bmp24_lumaRow(const t_pixel* row, int width, unsigned char* out);
+t_bmp8* bmp24_toBmp8(t_bmp24* img);
 void bmp24_brightness(t_bmp24* img, int value);
 
 // Fonctions de filtrage
 t_pixel bmp24_convolution(t_bmp24* img, int x, int y, float** kernel, int kernelSize);
+void bmp24_applyFilter(t_bmp24* img, float** kernel, int kernelSize);
+void bmp24_applyFilterTo(t_bmp24* src, t_bmp24* dst, float** kernel, int kernelSize);
+void bmp24_applyFilterChain(t_bmp24* img, float** kernels[], int count);
+void bmp24_applyIntFilter(t_bmp24* img, const t_intKernel* kernel);
+int bmp24_applySeparableFilter(t_bmp24* img, const t_separableKernel* kernel);
+int bmp24_boxBlurRadius(t_bmp24* img, int radius);
+int bmp24_medianFilter(t_bmp24* img, int radius);
 void bmp24_boxBlur(t_bmp24* img);
 void bmp24_gaussianBlur(t_bmp24* img);
 void bmp24_outline(t_bmp24* img);
@@ -91,6 +185,10 @@ void bmp24_emboss(t_bmp24* img);
 void bmp24_sharpen(t_bmp24* img);
 
 // Fonctions d'égalisation d'histogramme
-void bmp24_equalize(t_bmp24* img);
+void bmp24_computeLumaHistogram(t_pixel* row, int width, unsigned int* hist);
+void bmp24_computeEqualizationMap(const unsigned int* hist, unsigned int pixelCount, unsigned int* map);
+void bmp24_equalizeRow(t_pixel* row, int width, const unsigned int* lut);
+int bmp24_equalize(t_bmp24* img);
+int bmp24_clahe(t_bmp24* img, int tilesX, int tilesY, float clipLimit);
 
 #endif // BMP24_H
\ No newline at end of file
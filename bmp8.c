@@ -6,96 +6,267 @@
  */
 
 #include "bmp8.h"
+#include "convolution.h"
+#include "integral.h"
+#include "clahe.h"
+#include "threadpool.h"
+#include "instrument.h"
+
+// Paramètres d'un traitement réparti en bandes entre les threads du pool
+typedef struct {
+    t_bmp8* img;
+    int value;                 // Ajustement ou seuil
+    unsigned char* out;        // Destination d'un filtre
+    float** kernel;
+    int kernelSize;
+    const t_lut* lut;          // Table de correspondance
+    unsigned int (*hist)[256]; // Un histogramme partiel par bande
+    t_integralImage* integral;
+    t_clahe* clahe;            // Tables par tuile de l'égalisation adaptative
+    float clipLimit;
+} t_bmp8Job;
+
+/**
+ * @brief Retourne les lignes d'une image de haut en bas, sur place
+ * @param data Pixels, lignes sans padding
+ * @param width Largeur d'une ligne en octets
+ * @param height Nombre de lignes
+ */
+static void flipRows(unsigned char* data, unsigned int width, unsigned int height) {
+    for (unsigned int y = 0; y < height / 2; y++) {
+        unsigned char* top = data + (size_t)y * width;
+        unsigned char* bottom = data + (size_t)(height - 1 - y) * width;
+        for (unsigned int x = 0; x < width; x++) {
+            unsigned char t = top[x];
+            top[x] = bottom[x];
+            bottom[x] = t;
+        }
+    }
+}
 
 /**
  * @brief Charge une image BMP 8 bits depuis un fichier
+ *
+ * Les pixels sont lus à partir de l'offset indiqué dans l'en-tête, après
+ * une palette de taille quelconque, en une seule lecture de toutes les
+ * lignes. Le padding des lignes (largeur non multiple de 4) est ensuite
+ * retiré sur place et une image de haut en bas (hauteur négative) est
+ * retournée : l'image chargée a toujours des lignes sans padding, de bas
+ * en haut, et une hauteur positive dans son en-tête (voir bmp8.h). Pour
+ * un fichier déjà sous cette forme (palette de 256 couleurs,
+ * largeur multiple de 4), les pixels sont lus tels quels.
+ *
  * @param filename Nom du fichier à charger
  * @return Pointeur vers l'image chargée, NULL en cas d'erreur
  */
 t_bmp8* bmp8_loadImage(const char* filename) {
+    INSTRUMENT_BEGIN("bmp8_loadImage");
+
     FILE* file = fopen(filename, "rb");
     if (!file) {
         printf("Erreur: Impossible d'ouvrir le fichier %s\n", filename);
+        INSTRUMENT_END();
         return NULL;
     }
 
-    // Allouer la mémoire pour l'image
-    t_bmp8* img = (t_bmp8*)malloc(sizeof(t_bmp8));
-    if (!img) {
-        printf("Erreur: Allocation mémoire échouée\n");
+    // Lire l'en-tête
+    unsigned char header[54];
+    size_t headerRead = fread(header, sizeof(unsigned char), 54, file);
+    instrument_addRead(headerRead);
+    if (headerRead != 54 || *(uint16_t*)&header[0] != 0x4D42) {
+        printf("Erreur: Le fichier n'est pas un BMP valide\n");
         fclose(file);
+        INSTRUMENT_END();
         return NULL;
     }
 
-    // Lire l'en-tête
-    fread(img->header, sizeof(unsigned char), 54, file);
-
     // Extraire les informations de l'en-tête
-    img->width = *(unsigned int*)&img->header[18];
-    img->height = *(unsigned int*)&img->header[22];
-    img->colorDepth = *(unsigned short*)&img->header[28];
-    img->dataSize = *(unsigned int*)&img->header[34];
+    uint32_t offset = *(uint32_t*)&header[10];
+    uint32_t infoSize = *(uint32_t*)&header[14];
+    int32_t width = *(int32_t*)&header[18];
+    int32_t height = *(int32_t*)&header[22];
+    uint16_t colorDepth = *(uint16_t*)&header[28];
+    uint32_t compression = *(uint32_t*)&header[30];
+    uint32_t colors = *(uint32_t*)&header[46];
 
     // Vérifier que c'est bien une image 8 bits
-    if (img->colorDepth != 8) {
-        printf("Erreur: L'image n'est pas en 8 bits (profondeur: %d)\n", img->colorDepth);
-        free(img);
+    if (colorDepth != 8) {
+        printf("Erreur: L'image n'est pas en 8 bits (profondeur: %d)\n", colorDepth);
         fclose(file);
+        INSTRUMENT_END();
         return NULL;
     }
 
-    // Si dataSize est 0, calculer la taille
-    if (img->dataSize == 0) {
-        img->dataSize = img->width * img->height;
+    if (compression != 0 || infoSize < 40 || width <= 0 || height == 0 || height == INT32_MIN) {
+        printf("Erreur: Format BMP non supporté\n");
+        fclose(file);
+        INSTRUMENT_END();
+        return NULL;
     }
 
-    // Lire la table de couleurs
-    fread(img->colorTable, sizeof(unsigned char), 1024, file);
+    unsigned int rows = height < 0 ? (unsigned int)-height : (unsigned int)height;
+    size_t stride = ((size_t)width + 3) & ~(size_t)3;
+    if ((uint64_t)stride * rows > 0x7FFFFFFF) {
+        printf("Erreur: Image trop grande\n");
+        fclose(file);
+        INSTRUMENT_END();
+        return NULL;
+    }
+
+    // La palette suit l'en-tête d'information et s'arrête aux pixels
+    size_t paletteStart = 14 + (size_t)infoSize;
+    if (offset < paletteStart) {
+        printf("Erreur: Offset des pixels invalide (%u)\n", offset);
+        fclose(file);
+        INSTRUMENT_END();
+        return NULL;
+    }
+    size_t paletteSize = offset - paletteStart;
+    if (colors > 0 && colors < 256 && paletteSize > colors * 4) paletteSize = colors * 4;
+    if (paletteSize > 1024) paletteSize = 1024;
 
-    // Allouer la mémoire pour les données
-    img->data = (unsigned char*)malloc(img->dataSize);
+    // Allouer la mémoire pour l'image
+    t_bmp8* img = (t_bmp8*)instrument_malloc(sizeof(t_bmp8));
+    if (!img) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        fclose(file);
+        INSTRUMENT_END();
+        return NULL;
+    }
+
+    img->width = width;
+    img->height = rows;
+    img->colorDepth = colorDepth;
+    img->dataSize = img->width * img->height;
+
+    // Allouer la mémoire pour les données, padding compris pour la lecture
+    img->data = (unsigned char*)instrument_malloc(stride * rows);
     if (!img->data) {
         printf("Erreur: Allocation mémoire pour les données échouée\n");
         free(img);
         fclose(file);
+        INSTRUMENT_END();
         return NULL;
     }
 
-    // Lire les données de l'image
-    fread(img->data, sizeof(unsigned char), img->dataSize, file);
+    // Lire la table de couleurs, complétée par du noir
+    memset(img->colorTable, 0, 1024);
+    size_t position = 54;
+    if (paletteSize > 0) {
+        if (paletteStart != position) fseek(file, (long)paletteStart, SEEK_SET);
+        instrument_addRead(fread(img->colorTable, sizeof(unsigned char), paletteSize, file));
+        position = paletteStart + paletteSize;
+    }
 
+    // Lire toutes les lignes d'un seul bloc
+    if (offset != position) fseek(file, (long)offset, SEEK_SET);
+    size_t dataRead = fread(img->data, sizeof(unsigned char), stride * rows, file);
+    instrument_addRead(dataRead);
     fclose(file);
+    if (dataRead != stride * rows) {
+        printf("Erreur: Données de l'image incomplètes\n");
+        bmp8_free(img);
+        INSTRUMENT_END();
+        return NULL;
+    }
+
+    // Retirer le padding : chaque ligne recule, la première ne bouge pas
+    if (stride != img->width) {
+        for (unsigned int y = 1; y < rows; y++) {
+            memmove(img->data + (size_t)y * img->width, img->data + y * stride, img->width);
+        }
+    }
+    if (height < 0) {
+        flipRows(img->data, img->width, rows);
+    }
+
+    // L'en-tête décrit désormais l'image telle que bmp8_saveImage l'écrit
+    memcpy(img->header, header, 54);
+    *(uint32_t*)&img->header[2] = (uint32_t)(54 + 1024 + stride * rows);
+    *(uint32_t*)&img->header[10] = 54 + 1024;
+    *(uint32_t*)&img->header[14] = 40;
+    *(int32_t*)&img->header[22] = (int32_t)rows;
+    if (*(uint32_t*)&img->header[34] != 0) {
+        *(uint32_t*)&img->header[34] = (uint32_t)(stride * rows);
+    }
+
+    INSTRUMENT_END();
     return img;
 }
 
 /**
  * @brief Sauvegarde une image BMP 8 bits dans un fichier
+ *
+ * Les dimensions de l'en-tête sont reprises de img et les lignes sont
+ * complétées à un multiple de 4 octets lorsque la largeur l'exige. Elles
+ * sont écrites dans l'ordre de la mémoire : une hauteur négative dans
+ * l'en-tête signifie que data est de haut en bas (voir bmp8.h) et elle
+ * est conservée dans le fichier.
+ *
  * @param filename Nom du fichier de sortie
  * @param img Pointeur vers l'image à sauvegarder
+ * @return 0 en cas de succès, -1 si le fichier n'a pas pu être écrit entièrement
  */
-void bmp8_saveImage(const char* filename, t_bmp8* img) {
+int bmp8_saveImage(const char* filename, t_bmp8* img) {
     if (!img) {
         printf("Erreur: Image NULL\n");
-        return;
+        return -1;
     }
 
+    INSTRUMENT_BEGIN("bmp8_saveImage");
+
     FILE* file = fopen(filename, "wb");
     if (!file) {
         printf("Erreur: Impossible d'ouvrir le fichier %s en écriture\n", filename);
-        return;
+        INSTRUMENT_END();
+        return -1;
     }
 
-    // Écrire l'en-tête
-    fwrite(img->header, sizeof(unsigned char), 54, file);
-
-    // Écrire la table de couleurs
-    fwrite(img->colorTable, sizeof(unsigned char), 1024, file);
+    // Mettre à jour les tailles dans une copie de l'en-tête (le sens des
+    // lignes déclaré par l'en-tête est conservé)
+    size_t stride = ((size_t)img->width + 3) & ~(size_t)3;
+    unsigned char header[54];
+    memcpy(header, img->header, 54);
+    *(uint32_t*)&header[2] = (uint32_t)(54 + 1024 + stride * img->height);
+    *(uint32_t*)&header[10] = 54 + 1024;
+    *(uint32_t*)&header[14] = 40;
+    *(int32_t*)&header[18] = (int32_t)img->width;
+    if (*(int32_t*)&header[22] >= 0) {
+        *(int32_t*)&header[22] = (int32_t)img->height;
+    } else {
+        *(int32_t*)&header[22] = -(int32_t)img->height;
+    }
+    if (*(uint32_t*)&header[34] != 0) {
+        *(uint32_t*)&header[34] = (uint32_t)(stride * img->height);
+    }
 
-    // Écrire les données
-    fwrite(img->data, sizeof(unsigned char), img->dataSize, file);
+    // Écrire l'en-tête et la table de couleurs
+    size_t written = fwrite(header, sizeof(unsigned char), 54, file);
+    written += fwrite(img->colorTable, sizeof(unsigned char), 1024, file);
+
+    // Écrire les données, d'un bloc si les lignes n'ont pas de padding
+    if (stride == img->width) {
+        written += fwrite(img->data, sizeof(unsigned char), img->dataSize, file);
+    } else {
+        static const unsigned char padding[3] = {0, 0, 0};
+        for (unsigned int y = 0; y < img->height; y++) {
+            written += fwrite(img->data + (size_t)y * img->width, sizeof(unsigned char), img->width, file);
+            written += fwrite(padding, sizeof(unsigned char), stride - img->width, file);
+        }
+    }
+    instrument_addWritten(written);
+
+    // fclose vide le tampon : une erreur d'écriture peut n'apparaître qu'ici
+    int closed = fclose(file);
+    if (written != 54 + 1024 + stride * img->height || closed != 0) {
+        printf("Erreur: Écriture du fichier %s échouée\n", filename);
+        INSTRUMENT_END();
+        return -1;
+    }
 
-    fclose(file);
     printf("Image sauvegardée avec succès dans %s\n", filename);
+    INSTRUMENT_END();
+    return 0;
 }
 
 /**
@@ -128,6 +299,36 @@ void bmp8_printInfo(t_bmp8* img) {
     printf("Data Size: %u\n", img->dataSize);
 }
 
+/**
+ * @brief Applique la table aux octets [start, end)
+ */
+static void applyLUTBand(int start, int end, int band, void* arg) {
+    t_bmp8Job* job = (t_bmp8Job*)arg;
+    (void)band;
+    lut_applyBytes(job->lut->table[LUT_GRAY], job->img->data + start, end - start);
+}
+
+/**
+ * @brief Applique une chaîne d'opérations ponctuelles en un seul parcours
+ *
+ * Seule la table LUT_GRAY est utilisée.
+ *
+ * @param img Pointeur vers l'image
+ * @param lut Table construite avec lut_identity puis les fonctions lut_xxx
+ */
+void bmp8_applyLUT(t_bmp8* img, const t_lut* lut) {
+    if (!img || !img->data || !lut) {
+        printf("Erreur: Paramètres invalides\n");
+        return;
+    }
+
+    INSTRUMENT_BEGIN("bmp8_applyLUT");
+
+    t_bmp8Job job = {.img = img, .lut = lut};
+    threadpool_run(img->dataSize, 1, applyLUTBand, &job);
+    INSTRUMENT_END();
+}
+
 /**
  * @brief Applique un effet négatif sur l'image
  * @param img Pointeur vers l'image
@@ -138,9 +339,13 @@ void bmp8_negative(t_bmp8* img) {
         return;
     }
 
-    for (unsigned int i = 0; i < img->dataSize; i++) {
-        img->data[i] = 255 - img->data[i];
-    }
+    INSTRUMENT_BEGIN("bmp8_negative");
+
+    t_lut lut;
+    lut_identity(&lut);
+    lut_negative(&lut, LUT_ALL);
+    bmp8_applyLUT(img, &lut);
+    INSTRUMENT_END();
 }
 
 /**
@@ -154,12 +359,13 @@ void bmp8_brightness(t_bmp8* img, int value) {
         return;
     }
 
-    for (unsigned int i = 0; i < img->dataSize; i++) {
-        int newValue = img->data[i] + value;
-        if (newValue > 255) newValue = 255;
-        if (newValue < 0) newValue = 0;
-        img->data[i] = (unsigned char)newValue;
-    }
+    INSTRUMENT_BEGIN("bmp8_brightness");
+
+    t_lut lut;
+    lut_identity(&lut);
+    lut_brightness(&lut, LUT_ALL, value);
+    bmp8_applyLUT(img, &lut);
+    INSTRUMENT_END();
 }
 
 /**
@@ -173,35 +379,70 @@ void bmp8_threshold(t_bmp8* img, int threshold) {
         return;
     }
 
-    for (unsigned int i = 0; i < img->dataSize; i++) {
-        img->data[i] = (img->data[i] >= threshold) ? 255 : 0;
+    INSTRUMENT_BEGIN("bmp8_threshold");
+
+    t_lut lut;
+    lut_identity(&lut);
+    lut_threshold(&lut, LUT_ALL, threshold);
+    bmp8_applyLUT(img, &lut);
+    INSTRUMENT_END();
+}
+
+/**
+ * @brief Seuillage adaptatif des lignes [start, end)
+ */
+static void adaptiveThresholdBand(int start, int end, int band, void* arg) {
+    t_bmp8Job* job = (t_bmp8Job*)arg;
+    t_bmp8* img = job->img;
+    (void)band;
+    for (int y = start; y < end; y++) {
+        unsigned char* row = img->data + y * img->width;
+        for (unsigned int x = 0; x < img->width; x++) {
+            float mean;
+            integral_localStats(job->integral, x, y, job->kernelSize, &mean, NULL);
+            row[x] = (row[x] >= mean - job->value) ? 255 : 0;
+        }
     }
 }
 
 /**
- * @brief Applique un filtre de convolution sur l'image
+ * @brief Applique un seuillage adaptatif : chaque pixel est comparé à la
+ * moyenne de son voisinage, obtenue en temps constant par image intégrale
  * @param img Pointeur vers l'image
- * @param kernel Noyau de convolution
- * @param kernelSize Taille du noyau (doit être impaire)
+ * @param radius Rayon du voisinage (fenêtre tronquée aux bords)
+ * @param offset Valeur retranchée à la moyenne locale pour obtenir le seuil
  */
-void bmp8_applyFilter(t_bmp8* img, float** kernel, int kernelSize) {
-    if (!img || !img->data || !kernel) {
+void bmp8_adaptiveThreshold(t_bmp8* img, int radius, int offset) {
+    if (!img || !img->data || radius < 0) {
         printf("Erreur: Paramètres invalides\n");
         return;
     }
 
-    // Créer une copie des données pour stocker le résultat
-    unsigned char* newData = (unsigned char*)malloc(img->dataSize);
-    if (!newData) {
-        printf("Erreur: Allocation mémoire échouée\n");
+    INSTRUMENT_BEGIN("bmp8_adaptiveThreshold");
+
+    t_integralImage* integral = integral_create(img->data, img->width, img->width, img->height);
+    if (!integral) {
+        INSTRUMENT_END();
         return;
     }
-    memcpy(newData, img->data, img->dataSize);
 
-    int n = kernelSize / 2;
+    t_bmp8Job job = {.img = img, .value = offset, .kernelSize = radius, .integral = integral};
+    threadpool_run(img->height, img->width, adaptiveThresholdBand, &job);
+
+    integral_free(integral);
+    INSTRUMENT_END();
+}
+
+/**
+ * @brief Convolution des lignes intérieures [start + n, end + n) vers job->out
+ */
+static void filterBand(int start, int end, int band, void* arg) {
+    t_bmp8Job* job = (t_bmp8Job*)arg;
+    t_bmp8* img = job->img;
+    int n = job->kernelSize / 2;
+    (void)band;
 
-    // Appliquer le filtre (sans traiter les bords)
-    for (int y = n; y < (int)img->height - n; y++) {
+    for (int y = start + n; y < end + n; y++) {
         for (int x = n; x < (int)img->width - n; x++) {
             float sum = 0.0;
 
@@ -211,7 +452,7 @@ void bmp8_applyFilter(t_bmp8* img, float** kernel, int kernelSize) {
                     int pixelY = y + ky;
                     int pixelX = x + kx;
                     int pixelIndex = pixelY * img->width + pixelX;
-                    sum += img->data[pixelIndex] * kernel[ky + n][kx + n];
+                    sum += img->data[pixelIndex] * job->kernel[ky + n][kx + n];
                 }
             }
 
@@ -219,55 +460,316 @@ void bmp8_applyFilter(t_bmp8* img, float** kernel, int kernelSize) {
             if (sum < 0) sum = 0;
             if (sum > 255) sum = 255;
 
-            newData[y * img->width + x] = (unsigned char)sum;
+            job->out[y * img->width + x] = (unsigned char)sum;
         }
     }
+}
 
-    // Copier le résultat dans l'image originale
-    memcpy(img->data, newData, img->dataSize);
-    free(newData);
+/**
+ * @brief Recopie la bordure de n pixels d'une image dans une autre
+ * @param dst Image de destination (mêmes dimensions)
+ * @param src Image source
+ * @param n Épaisseur de la bordure
+ */
+static void copyBorder(t_bmp8* dst, t_bmp8* src, int n) {
+    int width = src->width;
+    int height = src->height;
+
+    for (int y = 0; y < height; y++) {
+        const unsigned char* in = src->data + (size_t)y * width;
+        unsigned char* out = dst->data + (size_t)y * width;
+        if (y < n || y >= height - n || width <= 2 * n) {
+            memcpy(out, in, width);
+        } else {
+            memcpy(out, in, n);
+            memcpy(out + width - n, in + width - n, n);
+        }
+    }
 }
 
 /**
- * @brief Calcule l'histogramme d'une image
+ * @brief Convolution de l'intérieur de src vers out (la bordure de out n'est pas écrite)
+ */
+static void filterInterior(t_bmp8* src, unsigned char* out, float** kernel, int kernelSize) {
+    // Noyau 3x3 : version vectorisée, au résultat identique
+    if (kernelSize == 3) {
+        conv_filter3x3(src->data, out, src->width, src->width, src->height, 1, kernel);
+        return;
+    }
+
+    int n = kernelSize / 2;
+    t_bmp8Job job = {.img = src, .out = out, .kernel = kernel, .kernelSize = kernelSize};
+    threadpool_run((int)src->height - 2 * n, src->width * kernelSize, filterBand, &job);
+}
+
+/**
+ * @brief Applique un filtre de convolution de src vers dst
+ *
+ * Tous les pixels de dst sont écrits (la bordure est recopiée de src) :
+ * une chaîne de filtres peut alterner entre deux images sans allocation
+ * ni copie.
+ *
+ * @param src Image source
+ * @param dst Image destination, distincte de src et de mêmes dimensions
+ * @param kernel Noyau de convolution
+ * @param kernelSize Taille du noyau (doit être impaire)
+ */
+void bmp8_applyFilterTo(t_bmp8* src, t_bmp8* dst, float** kernel, int kernelSize) {
+    if (!src || !src->data || !dst || !dst->data || !kernel || src->data == dst->data) {
+        printf("Erreur: Paramètres invalides\n");
+        return;
+    }
+    if (dst->width != src->width || dst->height != src->height) {
+        printf("Erreur: Dimensions incompatibles\n");
+        return;
+    }
+
+    INSTRUMENT_BEGIN("bmp8_applyFilterTo");
+
+    copyBorder(dst, src, kernelSize / 2);
+    filterInterior(src, dst->data, kernel, kernelSize);
+    INSTRUMENT_END();
+}
+
+/**
+ * @brief Applique un filtre de convolution sur l'image
+ *
+ * Les pixels d'origine sont copiés une fois dans un tampon qui sert de
+ * source ; le résultat est écrit directement dans l'image, dont la bordure
+ * est déjà en place. Les pixels restent à leur adresse, ce qui permet de
+ * filtrer une image présentée par bmp_viewAsBmp8.
+ *
  * @param img Pointeur vers l'image
- * @return Tableau de 256 entiers contenant l'histogramme
+ * @param kernel Noyau de convolution
+ * @param kernelSize Taille du noyau (doit être impaire)
  */
-unsigned int* bmp8_computeHistogram(t_bmp8* img) {
+void bmp8_applyFilter(t_bmp8* img, float** kernel, int kernelSize) {
+    if (!img || !img->data || !kernel) {
+        printf("Erreur: Paramètres invalides\n");
+        return;
+    }
+
+    INSTRUMENT_BEGIN("bmp8_applyFilter");
+
+    // Copie des pixels d'origine, lue par le filtre
+    t_bmp8 source = *img;
+    source.data = (unsigned char*)instrument_malloc(img->dataSize);
+    if (!source.data) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        INSTRUMENT_END();
+        return;
+    }
+    memcpy(source.data, img->data, img->dataSize);
+
+    filterInterior(&source, img->data, kernel, kernelSize);
+
+    free(source.data);
+    INSTRUMENT_END();
+}
+
+/**
+ * @brief Applique une suite de filtres 3x3, tuile par tuile
+ *
+ * Chaque tuile de l'image passe par tous les filtres pendant qu'elle est
+ * en cache ; seul le résultat final est écrit en mémoire
+ * (conv_filter3x3Chain). Le résultat est identique à des appels successifs
+ * à bmp8_applyFilter.
+ *
+ * @param img Pointeur vers l'image
+ * @param kernels Noyaux 3x3, dans l'ordre d'application
+ * @param count Nombre de noyaux
+ */
+void bmp8_applyFilterChain(t_bmp8* img, float** kernels[], int count) {
+    if (!img || !img->data || !kernels || count < 0) {
+        printf("Erreur: Paramètres invalides\n");
+        return;
+    }
+    if (count == 0) return;
+
+    INSTRUMENT_BEGIN("bmp8_applyFilterChain");
+
+    unsigned char* source = (unsigned char*)instrument_malloc(img->dataSize);
+    if (!source) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        INSTRUMENT_END();
+        return;
+    }
+
+    // Les suites plus longues que CONV_CHAIN_MAX_STAGES sont traitées en plusieurs parcours
+    for (int first = 0; first < count; first += CONV_CHAIN_MAX_STAGES) {
+        t_convStage stages[CONV_CHAIN_MAX_STAGES];
+        int n = (count - first < CONV_CHAIN_MAX_STAGES) ? count - first : CONV_CHAIN_MAX_STAGES;
+        for (int i = 0; i < n; i++) {
+            stages[i].kernel = kernels[first + i];
+            stages[i].lut = NULL;
+        }
+        memcpy(source, img->data, img->dataSize);
+        conv_filter3x3Chain(source, img->data, img->width, img->width, img->height, 1, stages, n, NULL);
+    }
+
+    free(source);
+    INSTRUMENT_END();
+}
+
+/**
+ * @brief Applique un noyau entier (voir createBoxBlurIntKernel) en arithmétique entière
+ * @param img Pointeur vers l'image
+ * @param kernel Noyau entier
+ */
+void bmp8_applyIntFilter(t_bmp8* img, const t_intKernel* kernel) {
+    if (!img || !img->data || !kernel) {
+        printf("Erreur: Paramètres invalides\n");
+        return;
+    }
+
+    INSTRUMENT_BEGIN("bmp8_applyIntFilter");
+
+    unsigned char* source = (unsigned char*)instrument_malloc(img->dataSize);
+    if (!source) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        INSTRUMENT_END();
+        return;
+    }
+    memcpy(source, img->data, img->dataSize);
+
+    conv_filterInt(source, img->data, img->width, img->width, img->height, 1, kernel);
+    free(source);
+    INSTRUMENT_END();
+}
+
+/**
+ * @brief Applique un filtre séparable en deux passes 1D (ligne puis colonne)
+ * @param img Pointeur vers l'image
+ * @param kernel Noyau séparable (voir createSeparableGaussianKernel)
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int bmp8_applySeparableFilter(t_bmp8* img, const t_separableKernel* kernel) {
+    if (!img || !img->data || !kernel) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    INSTRUMENT_BEGIN("bmp8_applySeparableFilter");
+
+    int result = conv_separable(img->data, img->width, img->width, img->height, 1, kernel, NULL);
+    INSTRUMENT_END();
+    return result;
+}
+
+/**
+ * @brief Applique un flou simple de rayon quelconque en temps constant par pixel
+ * @param img Pointeur vers l'image
+ * @param radius Rayon du flou (fenêtre de 2 * radius + 1 pixels de côté)
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int bmp8_boxBlurRadius(t_bmp8* img, int radius) {
     if (!img || !img->data) {
-        return NULL;
+        printf("Erreur: Image invalide\n");
+        return -1;
     }
 
-    unsigned int* hist = (unsigned int*)calloc(256, sizeof(unsigned int));
-    if (!hist) {
+    INSTRUMENT_BEGIN("bmp8_boxBlurRadius");
+
+    int result = conv_boxBlur(img->data, img->width, img->width, img->height, 1, radius, NULL);
+    INSTRUMENT_END();
+    return result;
+}
+
+/**
+ * @brief Applique un filtre médian de rayon quelconque en temps constant par pixel
+ * @param img Pointeur vers l'image
+ * @param radius Rayon du filtre (fenêtre de 2 * radius + 1 pixels de côté)
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int bmp8_medianFilter(t_bmp8* img, int radius) {
+    if (!img || !img->data) {
+        printf("Erreur: Image invalide\n");
+        return -1;
+    }
+
+    INSTRUMENT_BEGIN("bmp8_medianFilter");
+
+    unsigned char* source = (unsigned char*)instrument_malloc(img->dataSize);
+    if (!source) {
         printf("Erreur: Allocation mémoire échouée\n");
-        return NULL;
+        INSTRUMENT_END();
+        return -1;
     }
+    memcpy(source, img->data, img->dataSize);
+
+    int result = conv_median(source, img->data, img->width, img->width, img->height, 1, radius, NULL);
+    free(source);
+    INSTRUMENT_END();
+    return result;
+}
+
+/**
+ * @brief Histogramme partiel des octets [start, end), dans job->hist[band]
+ */
+static void histogramBand(int start, int end, int band, void* arg) {
+    t_bmp8Job* job = (t_bmp8Job*)arg;
+    const unsigned char* data = job->img->data;
+    unsigned int* hist = job->hist[band];
 
     // Compter les pixels pour chaque niveau de gris
-    for (unsigned int i = 0; i < img->dataSize; i++) {
-        hist[img->data[i]]++;
+    for (int i = start; i < end; i++) {
+        hist[data[i]]++;
     }
+}
 
-    return hist;
+/**
+ * @brief Remplit l'histogramme d'une image, sans allocation
+ * @param img Pointeur vers l'image
+ * @param hist Tableau de 256 entiers
+ */
+static void computeHistogramInto(t_bmp8* img, unsigned int* hist) {
+    // Un histogramme partiel par bande, fusionnés à la fin
+    unsigned int partial[THREADPOOL_MAX_THREADS][256];
+    memset(partial, 0, sizeof(partial));
+
+    t_bmp8Job job = {.img = img, .hist = partial};
+    int bands = threadpool_run(img->dataSize, 1, histogramBand, &job);
+
+    memset(hist, 0, 256 * sizeof(unsigned int));
+    for (int b = 0; b < bands; b++) {
+        for (int i = 0; i < 256; i++) {
+            hist[i] += partial[b][i];
+        }
+    }
 }
 
 /**
- * @brief Calcule la CDF et normalise l'histogramme
- * @param hist Histogramme d'entrée
- * @return Histogramme cumulé normalisé
+ * @brief Calcule l'histogramme d'une image
+ * @param img Pointeur vers l'image
+ * @return Tableau de 256 entiers contenant l'histogramme
  */
-unsigned int* bmp8_computeCDF(unsigned int* hist) {
-    if (!hist) {
+unsigned int* bmp8_computeHistogram(t_bmp8* img) {
+    if (!img || !img->data) {
         return NULL;
     }
 
-    unsigned int* cdf = (unsigned int*)malloc(256 * sizeof(unsigned int));
-    if (!cdf) {
+    INSTRUMENT_BEGIN("bmp8_computeHistogram");
+
+    unsigned int* hist = (unsigned int*)instrument_malloc(256 * sizeof(unsigned int));
+    if (!hist) {
         printf("Erreur: Allocation mémoire échouée\n");
+        INSTRUMENT_END();
         return NULL;
     }
 
+    computeHistogramInto(img, hist);
+    INSTRUMENT_END();
+    return hist;
+}
+
+/**
+ * @brief Calcule la CDF normalisée d'un histogramme, sans allocation
+ * @param hist Histogramme d'entrée
+ * @param hist_eq Tableau de 256 entiers recevant l'histogramme cumulé normalisé
+ */
+static void computeCDFInto(const unsigned int* hist, unsigned int* hist_eq) {
+    unsigned int cdf[256];
+
     // Calculer la CDF
     cdf[0] = hist[0];
     for (int i = 1; i < 256; i++) {
@@ -287,13 +789,6 @@ unsigned int* bmp8_computeCDF(unsigned int* hist) {
     unsigned int N = cdf[255];
 
     // Normaliser la CDF
-    unsigned int* hist_eq = (unsigned int*)malloc(256 * sizeof(unsigned int));
-    if (!hist_eq) {
-        printf("Erreur: Allocation mémoire échouée\n");
-        free(cdf);
-        return NULL;
-    }
-
     for (int i = 0; i < 256; i++) {
         if (N > cdf_min) {
             hist_eq[i] = round(((double)(cdf[i] - cdf_min) / (N - cdf_min)) * 255);
@@ -301,37 +796,131 @@ unsigned int* bmp8_computeCDF(unsigned int* hist) {
             hist_eq[i] = 0;
         }
     }
+}
+
+/**
+ * @brief Calcule la CDF et normalise l'histogramme
+ * @param hist Histogramme d'entrée
+ * @return Histogramme cumulé normalisé
+ */
+unsigned int* bmp8_computeCDF(unsigned int* hist) {
+    if (!hist) {
+        return NULL;
+    }
 
-    free(cdf);
+    unsigned int* hist_eq = (unsigned int*)instrument_malloc(256 * sizeof(unsigned int));
+    if (!hist_eq) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        return NULL;
+    }
+
+    computeCDFInto(hist, hist_eq);
     return hist_eq;
 }
 
 /**
  * @brief Applique l'égalisation d'histogramme sur l'image
+ *
+ * L'histogramme et la table sont gardés sur la pile : aucune allocation.
+ *
  * @param img Pointeur vers l'image
+ * @return 0 en cas de succès, -1 en cas d'erreur
  */
-void bmp8_equalize(t_bmp8* img) {
+int bmp8_equalize(t_bmp8* img) {
     if (!img || !img->data) {
         printf("Erreur: Image invalide\n");
-        return;
+        return -1;
     }
 
-    // Calculer l'histogramme
-    unsigned int* hist = bmp8_computeHistogram(img);
-    if (!hist) return;
+    INSTRUMENT_BEGIN("bmp8_equalize");
 
-    // Calculer l'histogramme égalisé
-    unsigned int* hist_eq = bmp8_computeCDF(hist);
-    if (!hist_eq) {
-        free(hist);
-        return;
-    }
+    // Calculer l'histogramme puis l'histogramme égalisé
+    unsigned int hist[256];
+    unsigned int hist_eq[256];
+    computeHistogramInto(img, hist);
+    computeCDFInto(hist, hist_eq);
 
     // Appliquer la transformation
-    for (unsigned int i = 0; i < img->dataSize; i++) {
-        img->data[i] = (unsigned char)hist_eq[img->data[i]];
+    t_lut lut;
+    lut_identity(&lut);
+    lut_remap(&lut, LUT_ALL, hist_eq);
+    bmp8_applyLUT(img, &lut);
+    INSTRUMENT_END();
+    return 0;
+}
+
+/**
+ * @brief Histogrammes et tables des tuiles [start, end) de l'égalisation adaptative
+ */
+static void claheTileBand(int start, int end, int band, void* arg) {
+    t_bmp8Job* job = (t_bmp8Job*)arg;
+    t_bmp8* img = job->img;
+    (void)band;
+
+    for (int t = start; t < end; t++) {
+        int x0, y0, x1, y1;
+        clahe_tileBounds(job->clahe, t, &x0, &y0, &x1, &y1);
+
+        unsigned int hist[256] = {0};
+        for (int y = y0; y < y1; y++) {
+            const unsigned char* row = img->data + (size_t)y * img->width;
+            for (int x = x0; x < x1; x++) {
+                hist[row[x]]++;
+            }
+        }
+        clahe_setTileHistogram(job->clahe, t, hist, job->clipLimit);
     }
+}
+
+/**
+ * @brief Égalisation adaptative des lignes [start, end)
+ */
+static void claheMapBand(int start, int end, int band, void* arg) {
+    t_bmp8Job* job = (t_bmp8Job*)arg;
+    t_bmp8* img = job->img;
+    t_claheRow rowLuts;
+    (void)band;
+
+    for (int y = start; y < end; y++) {
+        unsigned char* row = img->data + (size_t)y * img->width;
+        clahe_prepareRow(job->clahe, y, rowLuts);
+        clahe_mapRow(job->clahe, rowLuts, 0, img->width, row, row);
+    }
+}
+
+/**
+ * @brief Applique une égalisation adaptative à contraste limité (CLAHE)
+ *
+ * Les histogrammes des tuiles sont calculés en parallèle, puis chaque pixel
+ * est égalisé par interpolation bilinéaire entre les tables des tuiles
+ * voisines (voir clahe.h).
+ *
+ * @param img Pointeur vers l'image
+ * @param tilesX Nombre de tuiles en largeur (0 pour CLAHE_DEFAULT_TILES)
+ * @param tilesY Nombre de tuiles en hauteur (0 pour CLAHE_DEFAULT_TILES)
+ * @param clipLimit Limite de contraste relative (2 à 4 en général), 0 pour ne pas limiter
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int bmp8_clahe(t_bmp8* img, int tilesX, int tilesY, float clipLimit) {
+    if (!img || !img->data) {
+        printf("Erreur: Image invalide\n");
+        return -1;
+    }
+
+    INSTRUMENT_BEGIN("bmp8_clahe");
+
+    t_clahe* clahe = clahe_create(img->width, img->height, tilesX, tilesY);
+    if (!clahe) {
+        INSTRUMENT_END();
+        return -1;
+    }
+
+    int tiles = clahe->tilesX * clahe->tilesY;
+    t_bmp8Job job = {.img = img, .clahe = clahe, .clipLimit = clipLimit};
+    threadpool_run(tiles, img->dataSize / tiles, claheTileBand, &job);
+    threadpool_run(img->height, img->width, claheMapBand, &job);
 
-    free(hist);
-    free(hist_eq);
+    clahe_free(clahe);
+    INSTRUMENT_END();
+    return 0;
 }
\ No newline at end of file
@@ -6,8 +6,16 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include "filters.h"
+#include "lut.h"
 
 // Structure pour représenter une image BMP 8 bits en niveaux de gris
+//
+// Les lignes de data sont sans padding, dans le sens indiqué par la hauteur
+// de l'en-tête (header[22]) : de bas en haut si elle est positive (toujours
+// le cas après bmp8_loadImage), de haut en bas si elle est négative (vue
+// d'un fichier de haut en bas, voir bmp_viewAsBmp8). bmp8_saveImage écrit
+// les lignes dans cet ordre, sans les retourner.
 typedef struct {
     unsigned char header[54];        // En-tête du fichier BMP
     unsigned char colorTable[1024];  // Table de couleurs
@@ -20,21 +28,30 @@ typedef struct {
 
 // Fonctions de lecture et écriture
 t_bmp8* bmp8_loadImage(const char* filename);
-void bmp8_saveImage(const char* filename, t_bmp8* img);
+int bmp8_saveImage(const char* filename, t_bmp8* img);
 void bmp8_free(t_bmp8* img);
 void bmp8_printInfo(t_bmp8* img);
 
 // Fonctions de traitement d'image
+void bmp8_applyLUT(t_bmp8* img, const t_lut* lut);
 void bmp8_negative(t_bmp8* img);
 void bmp8_brightness(t_bmp8* img, int value);
 void bmp8_threshold(t_bmp8* img, int threshold);
+void bmp8_adaptiveThreshold(t_bmp8* img, int radius, int offset);
 
 // Fonctions de filtrage
 void bmp8_applyFilter(t_bmp8* img, float** kernel, int kernelSize);
+void bmp8_applyFilterTo(t_bmp8* src, t_bmp8* dst, float** kernel, int kernelSize);
+void bmp8_applyFilterChain(t_bmp8* img, float** kernels[], int count);
+void bmp8_applyIntFilter(t_bmp8* img, const t_intKernel* kernel);
+int bmp8_applySeparableFilter(t_bmp8* img, const t_separableKernel* kernel);
+int bmp8_boxBlurRadius(t_bmp8* img, int radius);
+int bmp8_medianFilter(t_bmp8* img, int radius);
 
 // Fonctions d'égalisation d'histogramme
 unsigned int* bmp8_computeHistogram(t_bmp8* img);
 unsigned int* bmp8_computeCDF(unsigned int* hist);
-void bmp8_equalize(t_bmp8* img);
+int bmp8_equalize(t_bmp8* img);
+int bmp8_clahe(t_bmp8* img, int tilesX, int tilesY, float clipLimit);
 
 #endif // BMP8_H
\ No newline at end of file
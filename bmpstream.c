@@ -0,0 +1,451 @@
+/**
+ * @file bmpstream.c
+ * @author Projet TI202
+ * @brief Implémentation du traitement d'images BMP par bandes de lignes
+ * @date 2025
+ *
+ * Les lignes sont lues dans l'ordre du fichier, par bandes de bandHeight
+ * lignes, et écrites dès qu'elles sont traitées : la mémoire utilisée est
+ * proportionnelle à largeur × hauteur de bande, quelle que soit la taille
+ * de l'image.
+ */
+
+#include "bmpstream.h"
+#include "bmp8.h"
+#include "bmp24.h"
+#include "instrument.h"
+
+// État d'un traitement en flux
+typedef struct {
+    FILE* in;            // Fichier source
+    FILE* out;           // Fichier destination
+    int width;           // Largeur de l'image
+    int height;          // Hauteur de l'image (positive)
+    int colorDepth;      // Profondeur de couleur (8 ou 24 bits)
+    int stride;          // Taille d'une ligne du fichier, padding compris
+    int bottomUp;        // 1 si le fichier stocke les lignes de bas en haut
+    uint32_t offset;     // Début des données dans le fichier
+} t_stream;
+
+/**
+ * @brief Ferme les fichiers d'un flux
+ * @param stream Flux
+ */
+static void stream_close(t_stream* stream) {
+    if (stream->in) fclose(stream->in);
+    if (stream->out) fclose(stream->out);
+    stream->in = NULL;
+    stream->out = NULL;
+}
+
+/**
+ * @brief Ouvre un flux et recopie tout ce qui précède les pixels (en-têtes, palette)
+ * @param stream Flux à initialiser
+ * @param input Fichier source
+ * @param output Fichier destination
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+static int stream_open(t_stream* stream, const char* input, const char* output) {
+    memset(stream, 0, sizeof(t_stream));
+
+    stream->in = fopen(input, "rb");
+    if (!stream->in) {
+        printf("Erreur: Impossible d'ouvrir le fichier %s\n", input);
+        return -1;
+    }
+
+    unsigned char header[54];
+    if (fread(header, 1, 54, stream->in) != 54 || *(uint16_t*)&header[0] != 0x4D42) {
+        printf("Erreur: Le fichier n'est pas un BMP valide\n");
+        stream_close(stream);
+        return -1;
+    }
+
+    int32_t width = *(int32_t*)&header[18];
+    int32_t height = *(int32_t*)&header[22];
+    uint16_t colorDepth = *(uint16_t*)&header[28];
+    uint32_t compression = *(uint32_t*)&header[30];
+
+    if ((colorDepth != 8 && colorDepth != 24) || compression != 0 || width <= 0 || height == 0) {
+        printf("Erreur: Format BMP non supporté (profondeur: %d)\n", colorDepth);
+        stream_close(stream);
+        return -1;
+    }
+
+    stream->width = width;
+    stream->height = height < 0 ? -height : height;
+    stream->bottomUp = height > 0;
+    stream->colorDepth = colorDepth;
+    stream->stride = ((width * (colorDepth / 8)) + 3) & ~3;
+    stream->offset = *(uint32_t*)&header[10];
+
+    if (stream->offset < 54) {
+        printf("Erreur: Le fichier n'est pas un BMP valide\n");
+        stream_close(stream);
+        return -1;
+    }
+
+    // Recopier les en-têtes et la palette tels quels
+    unsigned char* prefix = (unsigned char*)instrument_malloc(stream->offset);
+    if (!prefix) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        stream_close(stream);
+        return -1;
+    }
+    memcpy(prefix, header, 54);
+    size_t rest = stream->offset - 54;
+    if (fread(prefix + 54, 1, rest, stream->in) != rest) {
+        printf("Erreur: Le fichier n'est pas un BMP valide\n");
+        free(prefix);
+        stream_close(stream);
+        return -1;
+    }
+    instrument_addRead(stream->offset);
+
+    stream->out = fopen(output, "wb");
+    if (!stream->out) {
+        printf("Erreur: Impossible d'ouvrir le fichier %s en écriture\n", output);
+        free(prefix);
+        stream_close(stream);
+        return -1;
+    }
+
+    size_t written = fwrite(prefix, 1, stream->offset, stream->out);
+    instrument_addWritten(written);
+    free(prefix);
+    if (written != stream->offset) {
+        printf("Erreur: Écriture des données échouée\n");
+        stream_close(stream);
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Lit des lignes brutes (padding compris) depuis le fichier source
+ * @return 0 en cas de succès, -1 si le fichier est tronqué
+ */
+static int stream_read(t_stream* stream, unsigned char* buffer, int rows) {
+    size_t n = fread(buffer, stream->stride, rows, stream->in);
+    instrument_addRead(n * stream->stride);
+    if (n != (size_t)rows) {
+        printf("Erreur: Données de l'image incomplètes\n");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Écrit des lignes brutes (padding compris) dans le fichier destination
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+static int stream_write(t_stream* stream, unsigned char* buffer, int rows) {
+    size_t n = fwrite(buffer, stream->stride, rows, stream->out);
+    instrument_addWritten(n * stream->stride);
+    if (n != (size_t)rows) {
+        printf("Erreur: Écriture des données échouée\n");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Applique une opération ponctuelle bande par bande
+ *
+ * L'opération est ramenée à une table de 256 valeurs appliquée à chaque
+ * octet de pixel ; en 24 bits, elle agit donc canal par canal.
+ *
+ * @param input Fichier source
+ * @param output Fichier destination
+ * @param op Opération à appliquer
+ * @param value Paramètre de l'opération (ignoré pour le négatif)
+ * @param bandHeight Nombre de lignes lues à la fois
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int bmp_streamPointOp(const char* input, const char* output, t_bmp_streamOp op, int value, int bandHeight) {
+    if (bandHeight <= 0) bandHeight = BMP_STREAM_BAND_HEIGHT;
+
+    INSTRUMENT_BEGIN("bmp_streamPointOp");
+
+    t_lut lut;
+    lut_identity(&lut);
+    switch (op) {
+        case BMP_STREAM_NEGATIVE:   lut_negative(&lut, LUT_ALL); break;
+        case BMP_STREAM_BRIGHTNESS: lut_brightness(&lut, LUT_ALL, value); break;
+        case BMP_STREAM_THRESHOLD:  lut_threshold(&lut, LUT_ALL, value); break;
+    }
+
+    t_stream stream;
+    if (stream_open(&stream, input, output) != 0) {
+        INSTRUMENT_END();
+        return -1;
+    }
+
+    unsigned char* band = (unsigned char*)instrument_malloc((size_t)stream.stride * bandHeight);
+    if (!band) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        stream_close(&stream);
+        INSTRUMENT_END();
+        return -1;
+    }
+
+    int rowBytes = stream.width * (stream.colorDepth / 8);
+    int status = 0;
+
+    for (int r = 0; r < stream.height && status == 0; r += bandHeight) {
+        int rows = (stream.height - r < bandHeight) ? stream.height - r : bandHeight;
+        status = stream_read(&stream, band, rows);
+        if (status != 0) break;
+
+        for (int y = 0; y < rows; y++) {
+            lut_applyBytes(lut.table[0], band + (size_t)y * stream.stride, rowBytes);
+        }
+
+        status = stream_write(&stream, band, rows);
+    }
+
+    free(band);
+    stream_close(&stream);
+    INSTRUMENT_END();
+    return status;
+}
+
+/**
+ * @brief Applique l'égalisation d'histogramme en deux passes sur le fichier
+ *
+ * La première passe construit l'histogramme (de la luminance en 24 bits),
+ * la seconde relit le fichier et réécrit les lignes égalisées. Le résultat
+ * est identique à bmp8_equalize / bmp24_equalize.
+ *
+ * @param input Fichier source
+ * @param output Fichier destination
+ * @param bandHeight Nombre de lignes lues à la fois
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int bmp_streamEqualize(const char* input, const char* output, int bandHeight) {
+    if (bandHeight <= 0) bandHeight = BMP_STREAM_BAND_HEIGHT;
+
+    INSTRUMENT_BEGIN("bmp_streamEqualize");
+
+    t_stream stream;
+    if (stream_open(&stream, input, output) != 0) {
+        INSTRUMENT_END();
+        return -1;
+    }
+
+    unsigned char* band = (unsigned char*)instrument_malloc((size_t)stream.stride * bandHeight);
+    if (!band) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        stream_close(&stream);
+        INSTRUMENT_END();
+        return -1;
+    }
+
+    // Première passe : histogramme
+    unsigned int hist[256] = {0};
+    int status = 0;
+
+    for (int r = 0; r < stream.height && status == 0; r += bandHeight) {
+        int rows = (stream.height - r < bandHeight) ? stream.height - r : bandHeight;
+        status = stream_read(&stream, band, rows);
+        if (status != 0) break;
+
+        for (int y = 0; y < rows; y++) {
+            unsigned char* row = band + (size_t)y * stream.stride;
+            if (stream.colorDepth == 8) {
+                for (int x = 0; x < stream.width; x++) {
+                    hist[row[x]]++;
+                }
+            } else {
+                bmp24_swapRedBlue(row, stream.width);
+                bmp24_computeLumaHistogram((t_pixel*)row, stream.width, hist);
+            }
+        }
+    }
+
+    unsigned int* hist_eq = (status == 0) ? bmp8_computeCDF(hist) : NULL;
+    if (!hist_eq) status = -1;
+
+    // Seconde passe : remplacement des valeurs
+    if (status == 0) {
+        fseek(stream.in, stream.offset, SEEK_SET);
+    }
+
+    for (int r = 0; r < stream.height && status == 0; r += bandHeight) {
+        int rows = (stream.height - r < bandHeight) ? stream.height - r : bandHeight;
+        status = stream_read(&stream, band, rows);
+        if (status != 0) break;
+
+        for (int y = 0; y < rows; y++) {
+            unsigned char* row = band + (size_t)y * stream.stride;
+            if (stream.colorDepth == 8) {
+                for (int x = 0; x < stream.width; x++) {
+                    row[x] = (unsigned char)hist_eq[row[x]];
+                }
+            } else {
+                bmp24_swapRedBlue(row, stream.width);
+                bmp24_equalizeRow((t_pixel*)row, stream.width, hist_eq);
+                bmp24_swapRedBlue(row, stream.width);
+            }
+        }
+
+        status = stream_write(&stream, band, rows);
+    }
+
+    free(hist_eq);
+    free(band);
+    stream_close(&stream);
+    INSTRUMENT_END();
+    return status;
+}
+
+/**
+ * @brief Applique un filtre de convolution bande par bande
+ *
+ * Seules les kernelSize / 2 lignes de halo de part et d'autre de la bande
+ * courante sont conservées en mémoire. Chaque bande est filtrée du tampon
+ * source vers le tampon résultat avec bmp8_applyFilterTo ou
+ * bmp24_applyFilterTo, sans copie intermédiaire : le résultat est identique
+ * au traitement de l'image entière, bords compris.
+ *
+ * @param input Fichier source
+ * @param output Fichier destination
+ * @param kernel Noyau de convolution
+ * @param kernelSize Taille du noyau (doit être impaire)
+ * @param bandHeight Nombre de lignes produites à la fois
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int bmp_streamFilter(const char* input, const char* output, float** kernel, int kernelSize, int bandHeight) {
+    if (!kernel || kernelSize <= 0) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+    INSTRUMENT_BEGIN("bmp_streamFilter");
+
+    if (bandHeight <= 0) bandHeight = BMP_STREAM_BAND_HEIGHT;
+
+    t_stream stream;
+    if (stream_open(&stream, input, output) != 0) {
+        INSTRUMENT_END();
+        return -1;
+    }
+
+    int n = kernelSize / 2;
+    int capacity = bandHeight + 2 * n;
+    int width = stream.width;
+
+    // Les lignes sont filtrées dans l'ordre du fichier, alors que t_bmp24 les
+    // range de haut en bas et bmp8_loadImage de bas en haut : si les deux
+    // ordres diffèrent, on retourne le noyau verticalement pour garder le
+    // même résultat qu'un traitement de l'image chargée
+    int flip = (stream.colorDepth == 24) == stream.bottomUp;
+    float** rows = (float**)instrument_malloc(kernelSize * sizeof(float*));
+    if (rows) {
+        for (int i = 0; i < kernelSize; i++) {
+            rows[i] = flip ? kernel[kernelSize - 1 - i] : kernel[i];
+        }
+    }
+
+    // Tampon des lignes sources (A) et résultat filtré (B)
+    unsigned char* scratch = (unsigned char*)instrument_calloc(stream.stride, 1);
+    unsigned char *bufA = NULL, *bufB = NULL;
+    t_bmp24 *imgA = NULL, *imgB = NULL;
+    int pitch;
+
+    if (stream.colorDepth == 8) {
+        pitch = width;
+        bufA = (unsigned char*)instrument_malloc((size_t)pitch * capacity);
+        bufB = (unsigned char*)instrument_malloc((size_t)pitch * capacity);
+    } else {
+        pitch = stream.stride;
+        imgA = bmp24_allocate(width, capacity, 24);
+        imgB = bmp24_allocate(width, capacity, 24);
+        if (imgA && imgB) {
+            bufA = (unsigned char*)imgA->data[0];
+            bufB = (unsigned char*)imgB->data[0];
+        }
+    }
+
+    int status = 0;
+    if (!scratch || !bufA || !bufB || !rows) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        status = -1;
+    }
+
+    int first = 0;   // Indice (dans le fichier) de la première ligne de A
+    int loaded = 0;  // Nombre de lignes présentes dans A
+
+    for (int r = 0; r < stream.height && status == 0; r += bandHeight) {
+        int end = (r + bandHeight < stream.height) ? r + bandHeight : stream.height;
+        int need = (end + n < stream.height) ? end + n : stream.height;
+
+        // Ne garder que le halo nécessaire au-dessus de la bande
+        int keepFrom = (r - n > 0) ? r - n : 0;
+        if (keepFrom > first) {
+            int shift = keepFrom - first;
+            memmove(bufA, bufA + (size_t)shift * pitch, (size_t)(loaded - shift) * pitch);
+            loaded -= shift;
+            first = keepFrom;
+        }
+
+        // Lire les lignes manquantes
+        while (first + loaded < need && status == 0) {
+            unsigned char* row = bufA + (size_t)loaded * pitch;
+            if (stream.colorDepth == 8) {
+                status = stream_read(&stream, scratch, 1);
+                memcpy(row, scratch, width);
+            } else {
+                status = stream_read(&stream, row, 1);
+                bmp24_swapRedBlue(row, width);
+            }
+            loaded++;
+        }
+        if (status != 0) break;
+
+        // Filtrer la bande et son halo de A vers B
+        if (stream.colorDepth == 8) {
+            t_bmp8 bandA, bandB;
+            bandA.data = bufA;
+            bandA.width = width;
+            bandA.height = loaded;
+            bandA.colorDepth = 8;
+            bandA.dataSize = width * loaded;
+            bandB = bandA;
+            bandB.data = bufB;
+            bmp8_applyFilterTo(&bandA, &bandB, rows, kernelSize);
+        } else {
+            imgA->height = loaded;
+            imgB->height = loaded;
+            bmp24_applyFilterTo(imgA, imgB, rows, kernelSize);
+            imgA->height = capacity;
+            imgB->height = capacity;
+        }
+
+        // Écrire les lignes de la bande
+        memset(scratch, 0, stream.stride);
+        for (int y = r; y < end && status == 0; y++) {
+            unsigned char* row = bufB + (size_t)(y - first) * pitch;
+            if (stream.colorDepth == 8) {
+                memcpy(scratch, row, width);
+            } else {
+                memcpy(scratch, row, width * 3);
+                bmp24_swapRedBlue(scratch, width);
+            }
+            status = stream_write(&stream, scratch, 1);
+        }
+    }
+
+    if (stream.colorDepth == 8) {
+        free(bufA);
+        free(bufB);
+    } else {
+        bmp24_free(imgA);
+        bmp24_free(imgB);
+    }
+    free(rows);
+    free(scratch);
+    stream_close(&stream);
+    INSTRUMENT_END();
+    return status;
+}
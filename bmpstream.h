@@ -0,0 +1,26 @@
+/**
+ * @file bmpstream.h
+ * @author Projet TI202
+ * @brief Traitement d'images BMP par bandes de lignes, sans charger l'image entière
+ * @date 2025
+ */
+
+#ifndef BMPSTREAM_H
+#define BMPSTREAM_H
+
+// Nombre de lignes lues à la fois par défaut
+#define BMP_STREAM_BAND_HEIGHT 64
+
+// Opérations ponctuelles disponibles en flux
+typedef enum {
+    BMP_STREAM_NEGATIVE,     // Négatif
+    BMP_STREAM_BRIGHTNESS,   // Luminosité (value = ajustement)
+    BMP_STREAM_THRESHOLD     // Binarisation (value = seuil), canal par canal en 24 bits
+} t_bmp_streamOp;
+
+// Fonctions de traitement en flux (8 ou 24 bits, détecté depuis l'en-tête)
+int bmp_streamPointOp(const char* input, const char* output, t_bmp_streamOp op, int value, int bandHeight);
+int bmp_streamFilter(const char* input, const char* output, float** kernel, int kernelSize, int bandHeight);
+int bmp_streamEqualize(const char* input, const char* output, int bandHeight);
+
+#endif // BMPSTREAM_H
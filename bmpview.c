@@ -0,0 +1,353 @@
+/**
+ * @file bmpview.c
+ * @author Projet TI202
+ * @brief Implémentation des vues mmap sur les fichiers BMP
+ * @date 2025
+ */
+
+#ifndef _WIN32
+    #define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "bmpview.h"
+#include "instrument.h"
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+/**
+ * @brief Projette un fichier en mémoire
+ * @param filename Nom du fichier
+ * @param mode Mode d'ouverture
+ * @param view Vue à remplir (champs map, mapSize et mapped)
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+static int mapFile(const char* filename, t_bmp_viewMode mode, t_bmp_view* view) {
+#ifndef _WIN32
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return -1;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return -1;
+    }
+
+    int prot = (mode == BMP_VIEW_PRIVATE) ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* map = mmap(NULL, (size_t)st.st_size, prot, MAP_PRIVATE, fd, 0);
+    close(fd); // La projection reste valide après la fermeture
+    if (map == MAP_FAILED) return -1;
+
+    view->map = (unsigned char*)map;
+    view->mapSize = (size_t)st.st_size;
+    view->mapped = 1;
+    return 0;
+#else
+    // Pas de mmap : on lit le fichier entier en une fois
+    (void)mode;
+    FILE* file = fopen(filename, "rb");
+    if (!file) return -1;
+
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size <= 0) {
+        fclose(file);
+        return -1;
+    }
+
+    view->map = (unsigned char*)instrument_malloc((size_t)size);
+    if (!view->map || fread(view->map, 1, (size_t)size, file) != (size_t)size) {
+        free(view->map);
+        fclose(file);
+        return -1;
+    }
+    fclose(file);
+
+    view->mapSize = (size_t)size;
+    view->mapped = 0;
+    return 0;
+#endif
+}
+
+/**
+ * @brief Libère la projection d'une vue
+ * @param view Vue
+ */
+static void unmapFile(t_bmp_view* view) {
+#ifndef _WIN32
+    if (view->mapped) {
+        munmap(view->map, view->mapSize);
+        return;
+    }
+#endif
+    free(view->map);
+}
+
+/**
+ * @brief Ouvre un fichier BMP 8 ou 24 bits sans copier ses pixels
+ *
+ * En mode BMP_VIEW_PRIVATE, la projection est copy-on-write : les pixels peuvent
+ * être modifiés sur place sans affecter le fichier, seules les pages touchées
+ * sont dupliquées.
+ *
+ * @param filename Nom du fichier
+ * @param mode Mode d'ouverture
+ * @return Vue ouverte, NULL en cas d'erreur
+ */
+t_bmp_view* bmp_viewOpen(const char* filename, t_bmp_viewMode mode) {
+    INSTRUMENT_BEGIN("bmp_viewOpen");
+
+    t_bmp_view* view = (t_bmp_view*)instrument_calloc(1, sizeof(t_bmp_view));
+    if (!view) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        INSTRUMENT_END();
+        return NULL;
+    }
+
+    if (mapFile(filename, mode, view) != 0) {
+        printf("Erreur: Impossible d'ouvrir le fichier %s\n", filename);
+        free(view);
+        INSTRUMENT_END();
+        return NULL;
+    }
+    view->mode = mode;
+
+    unsigned char* header = view->map;
+    if (view->mapSize < 54 || *(uint16_t*)&header[0] != 0x4D42) {
+        printf("Erreur: Le fichier n'est pas un BMP valide\n");
+        bmp_viewClose(view);
+        INSTRUMENT_END();
+        return NULL;
+    }
+
+    uint32_t offset = *(uint32_t*)&header[10];
+    int32_t width = *(int32_t*)&header[18];
+    int32_t height = *(int32_t*)&header[22];
+    uint16_t colorDepth = *(uint16_t*)&header[28];
+    uint32_t compression = *(uint32_t*)&header[30];
+
+    if ((colorDepth != 8 && colorDepth != 24) || compression != 0 || width <= 0 || height == 0) {
+        printf("Erreur: Format BMP non supporté (profondeur: %d)\n", colorDepth);
+        bmp_viewClose(view);
+        INSTRUMENT_END();
+        return NULL;
+    }
+
+    view->width = width;
+    view->height = height < 0 ? -height : height;
+    view->bottomUp = height > 0;
+    view->colorDepth = colorDepth;
+    view->stride = ((width * (colorDepth / 8)) + 3) & ~3;
+
+    if ((size_t)offset + (size_t)view->stride * view->height > view->mapSize) {
+        printf("Erreur: Données de l'image incomplètes\n");
+        bmp_viewClose(view);
+        INSTRUMENT_END();
+        return NULL;
+    }
+    view->pixels = view->map + offset;
+
+    INSTRUMENT_END();
+    return view;
+}
+
+/**
+ * @brief Ferme une vue et libère sa projection
+ * @param view Vue à fermer
+ */
+void bmp_viewClose(t_bmp_view* view) {
+    if (view) {
+        if (view->map) {
+            unmapFile(view);
+        }
+        free(view);
+    }
+}
+
+/**
+ * @brief Écrit le contenu de la vue (en-têtes compris) dans un fichier
+ * @param view Vue
+ * @param filename Nom du fichier de sortie
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int bmp_viewSave(t_bmp_view* view, const char* filename) {
+    if (!view) {
+        printf("Erreur: Vue NULL\n");
+        return -1;
+    }
+
+    INSTRUMENT_BEGIN("bmp_viewSave");
+
+    FILE* file = fopen(filename, "wb");
+    if (!file) {
+        printf("Erreur: Impossible d'ouvrir le fichier %s en écriture\n", filename);
+        INSTRUMENT_END();
+        return -1;
+    }
+
+    size_t written = fwrite(view->map, 1, view->mapSize, file);
+    instrument_addWritten(written);
+    fclose(file);
+    if (written != view->mapSize) {
+        printf("Erreur: Écriture des données échouée\n");
+        INSTRUMENT_END();
+        return -1;
+    }
+
+    printf("Image sauvegardée avec succès dans %s\n", filename);
+    INSTRUMENT_END();
+    return 0;
+}
+
+/**
+ * @brief Renvoie l'adresse d'une ligne de la vue
+ * @param view Vue
+ * @param y Indice de ligne, 0 étant le haut de l'image
+ * @return Pointeur vers la ligne dans la projection
+ */
+unsigned char* bmp_viewRow(t_bmp_view* view, int y) {
+    int fileRow = view->bottomUp ? view->height - 1 - y : y;
+    return view->pixels + (size_t)fileRow * view->stride;
+}
+
+/**
+ * @brief Présente une vue 8 bits comme un t_bmp8 sans copier les pixels
+ *
+ * img->data pointe directement dans la projection : img ne doit pas être
+ * passé à bmp8_free et reste valide tant que la vue est ouverte. Les lignes
+ * sont dans l'ordre du fichier et l'en-tête est celui du fichier. Pour un
+ * fichier de haut en bas (hauteur négative), les lignes ne sont donc pas
+ * retournées comme avec bmp8_loadImage : un noyau non symétrique
+ * verticalement (relief) doit être passé lignes inversées pour obtenir le
+ * même résultat. Les fonctions de bmp8.h modifiant l'image exigent le mode
+ * BMP_VIEW_PRIVATE.
+ *
+ * @param view Vue 8 bits dont les lignes n'ont pas de padding
+ * @param img Image à remplir
+ * @return 0 en cas de succès, -1 si la vue ne peut pas être présentée ainsi
+ */
+int bmp_viewAsBmp8(t_bmp_view* view, t_bmp8* img) {
+    if (!view || !img) return -1;
+
+    if (view->colorDepth != 8 || view->stride != view->width) {
+        printf("Erreur: La vue doit être en 8 bits sans padding de ligne\n");
+        return -1;
+    }
+
+    memcpy(img->header, view->map, 54);
+
+    // La palette suit l'en-tête d'information
+    uint32_t infoSize = *(uint32_t*)&view->map[14];
+    size_t paletteStart = 14 + infoSize;
+    size_t paletteSize = 0;
+    if (view->pixels > view->map + paletteStart) {
+        paletteSize = (size_t)(view->pixels - view->map) - paletteStart;
+    }
+    if (paletteSize > 1024) paletteSize = 1024;
+    memset(img->colorTable, 0, 1024);
+    memcpy(img->colorTable, view->map + paletteStart, paletteSize);
+
+    img->data = view->pixels;
+    img->width = view->width;
+    img->height = view->height;
+    img->colorDepth = 8;
+    img->dataSize = view->width * view->height;
+    return 0;
+}
+
+/**
+ * @brief Calcule l'histogramme d'un canal directement sur la projection
+ * @param view Vue
+ * @param channel Canal (BMP_CHANNEL_*) pour une image 24 bits, ignoré en 8 bits
+ * @return Tableau de 256 entiers contenant l'histogramme
+ */
+unsigned int* bmp_viewComputeHistogram(t_bmp_view* view, int channel) {
+    if (!view || channel < 0 || channel > 2) {
+        return NULL;
+    }
+
+    INSTRUMENT_BEGIN("bmp_viewComputeHistogram");
+
+    unsigned int* hist = (unsigned int*)instrument_calloc(256, sizeof(unsigned int));
+    if (!hist) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        INSTRUMENT_END();
+        return NULL;
+    }
+
+    int step = view->colorDepth / 8;
+    int start = (step == 3) ? channel : 0;
+    int rowBytes = view->width * step;
+
+    for (int y = 0; y < view->height; y++) {
+        const unsigned char* row = view->pixels + (size_t)y * view->stride;
+        for (int i = start; i < rowBytes; i += step) {
+            hist[row[i]]++;
+        }
+    }
+
+    INSTRUMENT_END();
+    return hist;
+}
+
+/**
+ * @brief Calcule les statistiques d'un canal directement sur la projection
+ * @param view Vue
+ * @param channel Canal (BMP_CHANNEL_*) pour une image 24 bits, ignoré en 8 bits
+ * @param stats Statistiques calculées
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int bmp_viewComputeStats(t_bmp_view* view, int channel, t_bmp_stats* stats) {
+    if (!stats) return -1;
+
+    unsigned int* hist = bmp_viewComputeHistogram(view, channel);
+    if (!hist) return -1;
+
+    double count = (double)view->width * view->height;
+    double sum = 0, sumSq = 0;
+    stats->min = -1;
+    stats->max = 0;
+
+    for (int i = 0; i < 256; i++) {
+        if (hist[i] > 0) {
+            if (stats->min < 0) stats->min = i;
+            stats->max = i;
+        }
+        sum += (double)hist[i] * i;
+        sumSq += (double)hist[i] * i * i;
+    }
+
+    stats->mean = sum / count;
+    double variance = sumSq / count - stats->mean * stats->mean;
+    stats->stddev = variance > 0 ? sqrt(variance) : 0;
+
+    free(hist);
+    return 0;
+}
+
+/**
+ * @brief Applique un effet négatif directement sur la projection
+ * @param view Vue ouverte en mode BMP_VIEW_PRIVATE
+ */
+void bmp_viewNegative(t_bmp_view* view) {
+    if (!view || view->mode != BMP_VIEW_PRIVATE) {
+        printf("Erreur: La vue doit être ouverte en mode privé\n");
+        return;
+    }
+
+    INSTRUMENT_BEGIN("bmp_viewNegative");
+
+    int rowBytes = view->width * (view->colorDepth / 8);
+    for (int y = 0; y < view->height; y++) {
+        unsigned char* row = view->pixels + (size_t)y * view->stride;
+        for (int i = 0; i < rowBytes; i++) {
+            row[i] = 255 - row[i];
+        }
+    }
+    INSTRUMENT_END();
+}
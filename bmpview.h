@@ -0,0 +1,61 @@
+/**
+ * @file bmpview.h
+ * @author Projet TI202
+ * @brief Ouverture d'images BMP par projection mémoire (mmap), sans copie
+ * @date 2025
+ */
+
+#ifndef BMPVIEW_H
+#define BMPVIEW_H
+
+#include <stddef.h>
+#include "bmp8.h"
+
+// Modes d'ouverture d'une vue
+typedef enum {
+    BMP_VIEW_READONLY,   // Projection en lecture seule
+    BMP_VIEW_PRIVATE     // Projection copy-on-write : modifiable, le fichier reste intact
+} t_bmp_viewMode;
+
+// Canaux d'une image 24 bits, dans l'ordre du fichier (BGR)
+#define BMP_CHANNEL_BLUE 0
+#define BMP_CHANNEL_GREEN 1
+#define BMP_CHANNEL_RED 2
+
+// Vue sur les pixels d'un fichier BMP 8 ou 24 bits projeté en mémoire
+typedef struct {
+    unsigned char* map;      // Début du fichier projeté
+    size_t mapSize;          // Taille de la projection
+    unsigned char* pixels;   // Première ligne stockée dans le fichier
+    int width;               // Largeur de l'image
+    int height;              // Hauteur de l'image (toujours positive)
+    int colorDepth;          // Profondeur de couleur (8 ou 24 bits)
+    int stride;              // Nombre d'octets entre deux lignes du fichier
+    int bottomUp;            // 1 si la première ligne du fichier est le bas de l'image
+    t_bmp_viewMode mode;     // Mode d'ouverture
+    int mapped;              // 0 si le fichier a été lu en mémoire faute de mmap
+} t_bmp_view;
+
+// Statistiques d'un canal
+typedef struct {
+    int min;
+    int max;
+    double mean;
+    double stddev;
+} t_bmp_stats;
+
+// Ouverture et fermeture
+t_bmp_view* bmp_viewOpen(const char* filename, t_bmp_viewMode mode);
+void bmp_viewClose(t_bmp_view* view);
+int bmp_viewSave(t_bmp_view* view, const char* filename);
+
+// Accès aux pixels
+unsigned char* bmp_viewRow(t_bmp_view* view, int y);
+int bmp_viewAsBmp8(t_bmp_view* view, t_bmp8* img);
+
+// Opérations directement sur la projection
+unsigned int* bmp_viewComputeHistogram(t_bmp_view* view, int channel);
+int bmp_viewComputeStats(t_bmp_view* view, int channel, t_bmp_stats* stats);
+void bmp_viewNegative(t_bmp_view* view);
+
+#endif // BMPVIEW_H
@@ -0,0 +1,234 @@
+/**
+ * @file clahe.c
+ * @author Projet TI202
+ * @brief Implémentation de l'égalisation adaptative à contraste limité
+ * @date 2025
+ */
+
+#include "clahe.h"
+#include "bmp8.h"
+#include "instrument.h"
+
+/**
+ * @brief Calcule, pour chaque position d'un axe, la tuile précédente et le poids de la suivante
+ *
+ * La tuile i couvre [size * i / tiles, size * (i + 1) / tiles) ; les centres
+ * sont manipulés doublés pour rester entiers. Avant le premier centre et
+ * après le dernier, seule la tuile du bord est utilisée (poids nul).
+ *
+ * @param size Nombre de positions (largeur ou hauteur)
+ * @param tiles Nombre de tuiles sur cet axe
+ * @param tile Tuile précédente de chaque position
+ * @param weight Poids de la tuile suivante (0 à 1 << CLAHE_WEIGHT_BITS)
+ */
+static void computeWeights(int size, int tiles, int* tile, int* weight) {
+    int i = 0;
+    for (int p = 0; p < size; p++) {
+        int p2 = 2 * p;
+
+        // Avancer tant que le centre de la tuile suivante est atteint
+        while (i < tiles - 1) {
+            long long start = (long long)size * (i + 1) / tiles;
+            long long end = (long long)size * (i + 2) / tiles;
+            if (start + end - 1 > p2) break;
+            i++;
+        }
+
+        long long start = (long long)size * i / tiles;
+        long long end = (long long)size * (i + 1) / tiles;
+        long long center = start + end - 1;
+
+        tile[p] = i;
+        if (i == tiles - 1 || p2 <= center) {
+            weight[p] = 0;
+        } else {
+            long long nextStart = end;
+            long long nextEnd = (long long)size * (i + 2) / tiles;
+            long long nextCenter = nextStart + nextEnd - 1;
+            weight[p] = (int)(((p2 - center) << CLAHE_WEIGHT_BITS) / (nextCenter - center));
+        }
+    }
+}
+
+/**
+ * @brief Prépare le découpage en tuiles et les poids d'interpolation d'une image
+ * @param width Largeur de l'image
+ * @param height Hauteur de l'image
+ * @param tilesX Nombre de tuiles en largeur (0 pour CLAHE_DEFAULT_TILES, au plus CLAHE_MAX_TILES)
+ * @param tilesY Nombre de tuiles en hauteur (0 pour CLAHE_DEFAULT_TILES, au plus CLAHE_MAX_TILES)
+ * @return Structure préparée (tables à remplir avec clahe_setTileHistogram), NULL en cas d'erreur
+ */
+t_clahe* clahe_create(int width, int height, int tilesX, int tilesY) {
+    if (width <= 0 || height <= 0 || tilesX < 0 || tilesY < 0) {
+        printf("Erreur: Paramètres invalides\n");
+        return NULL;
+    }
+    if (tilesX == 0) tilesX = CLAHE_DEFAULT_TILES;
+    if (tilesY == 0) tilesY = CLAHE_DEFAULT_TILES;
+    if (tilesX > CLAHE_MAX_TILES) tilesX = CLAHE_MAX_TILES;
+    if (tilesY > CLAHE_MAX_TILES) tilesY = CLAHE_MAX_TILES;
+    if (tilesX > width) tilesX = width;
+    if (tilesY > height) tilesY = height;
+
+    t_clahe* clahe = (t_clahe*)instrument_calloc(1, sizeof(t_clahe));
+    if (!clahe) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        return NULL;
+    }
+
+    clahe->width = width;
+    clahe->height = height;
+    clahe->tilesX = tilesX;
+    clahe->tilesY = tilesY;
+    clahe->luts = instrument_malloc((size_t)tilesX * tilesY * sizeof(*clahe->luts));
+    clahe->colTile = (int*)instrument_malloc(2 * (size_t)width * sizeof(int));
+    clahe->rowTile = (int*)instrument_malloc(2 * (size_t)height * sizeof(int));
+    if (!clahe->luts || !clahe->colTile || !clahe->rowTile) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        clahe_free(clahe);
+        return NULL;
+    }
+    clahe->colWeight = clahe->colTile + width;
+    clahe->rowWeight = clahe->rowTile + height;
+
+    computeWeights(width, tilesX, clahe->colTile, clahe->colWeight);
+    computeWeights(height, tilesY, clahe->rowTile, clahe->rowWeight);
+    return clahe;
+}
+
+/**
+ * @brief Libère une structure CLAHE
+ * @param clahe Structure à libérer
+ */
+void clahe_free(t_clahe* clahe) {
+    if (!clahe) return;
+
+    free(clahe->luts);
+    free(clahe->colTile);
+    free(clahe->rowTile);
+    free(clahe);
+}
+
+/**
+ * @brief Renvoie le rectangle [x0, x1) x [y0, y1) couvert par une tuile
+ * @param clahe Structure préparée
+ * @param tile Indice de la tuile (ty * tilesX + tx)
+ */
+void clahe_tileBounds(const t_clahe* clahe, int tile, int* x0, int* y0, int* x1, int* y1) {
+    int tx = tile % clahe->tilesX;
+    int ty = tile / clahe->tilesX;
+
+    *x0 = (int)((long long)clahe->width * tx / clahe->tilesX);
+    *x1 = (int)((long long)clahe->width * (tx + 1) / clahe->tilesX);
+    *y0 = (int)((long long)clahe->height * ty / clahe->tilesY);
+    *y1 = (int)((long long)clahe->height * (ty + 1) / clahe->tilesY);
+}
+
+/**
+ * @brief Écrête l'histogramme d'une tuile et en déduit sa table d'égalisation
+ *
+ * Chaque case est limitée à clipLimit fois la hauteur moyenne ; l'excédent
+ * est réparti uniformément, le reste de la division une case sur n. La
+ * table est ensuite construite par bmp8_computeCDF. Une tuile d'une seule
+ * valeur garde une table identité (elle serait sinon ramenée à 0).
+ *
+ * @param clahe Structure préparée
+ * @param tile Indice de la tuile
+ * @param hist Histogramme de la tuile (modifié)
+ * @param clipLimit Limite relative (2 à 4 en général), 0 pour ne pas écrêter
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int clahe_setTileHistogram(t_clahe* clahe, int tile, unsigned int* hist, float clipLimit) {
+    unsigned char* lut = clahe->luts[tile];
+
+    unsigned int area = 0;
+    int levels = 0;
+    for (int i = 0; i < 256; i++) {
+        area += hist[i];
+        if (hist[i] > 0) levels++;
+    }
+
+    if (levels <= 1) {
+        for (int i = 0; i < 256; i++) lut[i] = (unsigned char)i;
+        return 0;
+    }
+
+    if (clipLimit > 0) {
+        unsigned int limit = (unsigned int)(clipLimit * area / 256);
+        if (limit < 1) limit = 1;
+
+        unsigned int excess = 0;
+        for (int i = 0; i < 256; i++) {
+            if (hist[i] > limit) {
+                excess += hist[i] - limit;
+                hist[i] = limit;
+            }
+        }
+
+        unsigned int share = excess / 256;
+        unsigned int rest = excess % 256;
+        for (int i = 0; i < 256; i++) {
+            hist[i] += share;
+        }
+        if (rest > 0) {
+            int step = 256 / rest;
+            for (int i = 0; i < 256 && rest > 0; i += step, rest--) {
+                hist[i]++;
+            }
+        }
+    }
+
+    unsigned int* hist_eq = bmp8_computeCDF(hist);
+    if (!hist_eq) return -1;
+
+    for (int i = 0; i < 256; i++) {
+        lut[i] = (unsigned char)hist_eq[i];
+    }
+    free(hist_eq);
+    return 0;
+}
+
+/**
+ * @brief Mélange les tables des deux rangées de tuiles qui entourent une ligne
+ * @param clahe Structure dont toutes les tables sont construites
+ * @param y Indice de la ligne
+ * @param rowLuts Tables de la ligne (valeurs multipliées par 1 << CLAHE_WEIGHT_BITS)
+ */
+void clahe_prepareRow(const t_clahe* clahe, int y, t_claheRow rowLuts) {
+    int wy = clahe->rowWeight[y];
+    const unsigned char (*top)[256] = clahe->luts + (size_t)clahe->rowTile[y] * clahe->tilesX;
+    const unsigned char (*bottom)[256] = wy > 0 ? top + clahe->tilesX : top;
+
+    for (int t = 0; t < clahe->tilesX; t++) {
+        for (int v = 0; v < 256; v++) {
+            rowLuts[t][v] = (uint16_t)((top[t][v] << CLAHE_WEIGHT_BITS) + (bottom[t][v] - top[t][v]) * wy);
+        }
+    }
+}
+
+/**
+ * @brief Remplace des valeurs d'une ligne par l'interpolation des tables des tuiles voisines
+ * @param clahe Structure préparée
+ * @param rowLuts Tables de la ligne (clahe_prepareRow)
+ * @param x Première colonne traitée
+ * @param count Nombre de colonnes traitées
+ * @param values Valeurs d'origine des colonnes [x, x + count)
+ * @param out Valeurs égalisées (peut être égal à values)
+ */
+void clahe_mapRow(const t_clahe* clahe, t_claheRow rowLuts, int x, int count, const unsigned char* values,
+                  unsigned char* out) {
+    const int* colTile = clahe->colTile + x;
+    const int* colWeight = clahe->colWeight + x;
+
+    for (int i = 0; i < count; i++) {
+        int t0 = colTile[i];
+        int wx = colWeight[i];
+        int v = values[i];
+
+        int left = rowLuts[t0][v];
+        int right = rowLuts[t0 + (wx > 0)][v];
+        int value = (left << CLAHE_WEIGHT_BITS) + (right - left) * wx;
+
+        out[i] = (unsigned char)((value + (1 << (2 * CLAHE_WEIGHT_BITS - 1))) >> (2 * CLAHE_WEIGHT_BITS));
+    }
+}
@@ -0,0 +1,60 @@
+/**
+ * @file clahe.h
+ * @author Projet TI202
+ * @brief Égalisation adaptative à contraste limité (CLAHE) : tables par tuile et interpolation
+ * @date 2025
+ *
+ * L'image est découpée en tilesX x tilesY tuiles. Chaque tuile reçoit sa
+ * propre table d'égalisation, construite à partir de son histogramme écrêté
+ * à clipLimit fois la hauteur moyenne d'une case (l'excédent est réparti sur
+ * toutes les cases). La valeur d'un pixel est ensuite interpolée
+ * bilinéairement entre les tables des quatre tuiles dont les centres
+ * l'entourent, ce qui évite les frontières visibles entre tuiles.
+ *
+ * Les positions et poids d'interpolation de chaque colonne et de chaque
+ * ligne sont calculés une fois pour toutes. Pour chaque ligne, les tables
+ * des deux rangées de tuiles voisines sont d'abord mélangées verticalement
+ * (clahe_prepareRow) : il ne reste que deux lectures de table et une
+ * interpolation entière par pixel.
+ */
+
+#ifndef CLAHE_H
+#define CLAHE_H
+
+#include <stdint.h>
+
+// Valeurs par défaut
+#define CLAHE_DEFAULT_TILES 8
+#define CLAHE_DEFAULT_CLIP 2.0f
+
+// Nombre maximal de tuiles par axe
+#define CLAHE_MAX_TILES 64
+
+// Précision des poids d'interpolation (en bits)
+#define CLAHE_WEIGHT_BITS 8
+
+// Tables d'une ligne de pixels : interpolation verticale déjà faite, une table par colonne de tuiles
+typedef uint16_t t_claheRow[CLAHE_MAX_TILES][256];
+
+// Tables et poids d'interpolation d'une image
+typedef struct {
+    int width;
+    int height;
+    int tilesX;
+    int tilesY;
+    unsigned char (*luts)[256];   // Une table par tuile, ligne de tuiles par ligne de tuiles
+    int* colTile;                 // Tuile de gauche utilisée pour chaque colonne
+    int* colWeight;               // Poids de la tuile de droite (0 à 1 << CLAHE_WEIGHT_BITS)
+    int* rowTile;                 // Tuile du haut utilisée pour chaque ligne
+    int* rowWeight;               // Poids de la tuile du bas
+} t_clahe;
+
+t_clahe* clahe_create(int width, int height, int tilesX, int tilesY);
+void clahe_free(t_clahe* clahe);
+void clahe_tileBounds(const t_clahe* clahe, int tile, int* x0, int* y0, int* x1, int* y1);
+int clahe_setTileHistogram(t_clahe* clahe, int tile, unsigned int* hist, float clipLimit);
+void clahe_prepareRow(const t_clahe* clahe, int y, t_claheRow rowLuts);
+void clahe_mapRow(const t_clahe* clahe, t_claheRow rowLuts, int x, int count, const unsigned char* values,
+                  unsigned char* out);
+
+#endif // CLAHE_H
@@ -0,0 +1,322 @@
+/**
+ * @file context.c
+ * @author Projet TI202
+ * @brief Implémentation du contexte de traitement réutilisable
+ * @date 2025
+ */
+
+#include "context.h"
+#include "convolution.h"
+#include "instrument.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Alignement des tampons découpés dans la zone de travail
+#define CONTEXT_ALIGNMENT 16
+
+/**
+ * @brief Crée un contexte et construit ses noyaux
+ * @return Contexte créé (zone de travail vide), NULL en cas d'erreur
+ */
+t_bmpContext* context_create(void) {
+    t_bmpContext* ctx = (t_bmpContext*)instrument_calloc(1, sizeof(t_bmpContext));
+    if (!ctx) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        return NULL;
+    }
+
+    ctx->kernels[CONTEXT_BOX_BLUR] = createBoxBlurKernel();
+    ctx->kernels[CONTEXT_GAUSSIAN_BLUR] = createGaussianBlurKernel();
+    ctx->kernels[CONTEXT_OUTLINE] = createOutlineKernel();
+    ctx->kernels[CONTEXT_EMBOSS] = createEmbossKernel();
+    ctx->kernels[CONTEXT_SHARPEN] = createSharpenKernel();
+
+    for (int i = 0; i < CONTEXT_KERNEL_COUNT; i++) {
+        if (!ctx->kernels[i]) {
+            printf("Erreur: Allocation mémoire échouée\n");
+            context_free(ctx);
+            return NULL;
+        }
+    }
+    return ctx;
+}
+
+/**
+ * @brief Libère un contexte, ses noyaux et sa zone de travail
+ * @param ctx Contexte à libérer
+ */
+void context_free(t_bmpContext* ctx) {
+    if (!ctx) return;
+
+    for (int i = 0; i < CONTEXT_KERNEL_COUNT; i++) {
+        if (ctx->kernels[i]) freeFilterKernel(ctx->kernels[i], 3);
+    }
+    free(ctx->scratch);
+    free(ctx);
+}
+
+/**
+ * @brief Garantit une zone de travail d'au moins size octets
+ *
+ * La zone n'est jamais réduite : une fois dimensionnée pour la plus grande
+ * image traitée, elle n'est plus réallouée. Son contenu n'est pas conservé
+ * lorsqu'elle est agrandie.
+ *
+ * @param ctx Contexte
+ * @param size Taille nécessaire en octets
+ * @return Début de la zone de travail (NULL si size vaut 0 et qu'aucune zone n'existe encore)
+ */
+void* context_reserve(t_bmpContext* ctx, size_t size) {
+    if (!ctx) return NULL;
+
+    if (size > ctx->scratchSize) {
+        free(ctx->scratch);
+        ctx->scratch = (unsigned char*)instrument_malloc(size);
+        ctx->scratchSize = ctx->scratch ? size : 0;
+        if (!ctx->scratch) {
+            printf("Erreur: Allocation mémoire échouée\n");
+            return NULL;
+        }
+    }
+    return ctx->scratch;
+}
+
+/**
+ * @brief Taille d'une copie de plan arrondie à l'alignement des tampons qui la suivent
+ */
+static size_t planeSize(int pitch, int height) {
+    size_t size = (size_t)pitch * height;
+    return (size + CONTEXT_ALIGNMENT - 1) & ~(size_t)(CONTEXT_ALIGNMENT - 1);
+}
+
+/**
+ * @brief Filtre 3x3 d'un plan sur place, à partir d'une copie dans la zone de travail
+ *
+ * La copie sert de source et le résultat est écrit directement dans le
+ * plan : la bordure, que le filtre ne modifie pas, est déjà en place.
+ */
+static int filterPlane(t_bmpContext* ctx, unsigned char* pixels, int pitch, int width, int height,
+                       int step, t_contextKernel kernel) {
+    if ((int)kernel < 0 || kernel >= CONTEXT_KERNEL_COUNT) {
+        printf("Erreur: Noyau inconnu\n");
+        return -1;
+    }
+
+    unsigned char* copy = (unsigned char*)context_reserve(ctx, planeSize(pitch, height));
+    if (!copy) return -1;
+
+    memcpy(copy, pixels, (size_t)pitch * height);
+    return conv_filter3x3(copy, pixels, pitch, width, height, step, ctx->kernels[kernel]);
+}
+
+/**
+ * @brief Filtre séparable d'un plan sur place, tampons intermédiaires dans la zone de travail
+ */
+static int separablePlane(t_bmpContext* ctx, unsigned char* pixels, int pitch, int width, int height,
+                          int step, const t_separableKernel* kernel) {
+    if (!kernel) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    size_t size = conv_separableScratchSize(width, height, step, kernel->size);
+    void* scratch = context_reserve(ctx, size);
+    if (size > 0 && !scratch) return -1;
+
+    return conv_separable(pixels, pitch, width, height, step, kernel, scratch);
+}
+
+/**
+ * @brief Flou par sommes glissantes d'un plan sur place, sommes dans la zone de travail
+ */
+static int boxBlurPlane(t_bmpContext* ctx, unsigned char* pixels, int pitch, int width, int height,
+                        int step, int radius) {
+    if (radius < 0 || radius > CONV_BOX_MAX_RADIUS) {
+        printf("Erreur: Rayon invalide (0 à %d)\n", CONV_BOX_MAX_RADIUS);
+        return -1;
+    }
+
+    size_t size = conv_boxBlurScratchSize(width, height, step, radius);
+    void* scratch = context_reserve(ctx, size);
+    if (size > 0 && !scratch) return -1;
+
+    return conv_boxBlur(pixels, pitch, width, height, step, radius, scratch);
+}
+
+/**
+ * @brief Filtre médian d'un plan sur place : copie source et histogrammes dans la zone de travail
+ */
+static int medianPlane(t_bmpContext* ctx, unsigned char* pixels, int pitch, int width, int height,
+                       int step, int radius) {
+    if (radius < 0 || radius > CONV_MEDIAN_MAX_RADIUS) {
+        printf("Erreur: Rayon invalide (0 à %d)\n", CONV_MEDIAN_MAX_RADIUS);
+        return -1;
+    }
+
+    size_t histSize = conv_medianScratchSize(width, height, step, radius);
+    if (radius == 0 || histSize == 0) return 0; // Aucun pixel n'a un voisinage complet
+
+    size_t copySize = planeSize(pitch, height);
+    unsigned char* copy = (unsigned char*)context_reserve(ctx, copySize + histSize);
+    if (!copy) return -1;
+
+    memcpy(copy, pixels, (size_t)pitch * height);
+    return conv_median(copy, pixels, pitch, width, height, step, radius, copy + copySize);
+}
+
+/**
+ * @brief Applique un noyau 3x3 préconstruit à une image 8 bits
+ * @param ctx Contexte
+ * @param img Pointeur vers l'image
+ * @param kernel Noyau (CONTEXT_*)
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int context_bmp8Filter(t_bmpContext* ctx, t_bmp8* img, t_contextKernel kernel) {
+    if (!ctx || !img || !img->data) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    INSTRUMENT_BEGIN("context_bmp8Filter");
+    int status = filterPlane(ctx, img->data, img->width, img->width, img->height, 1, kernel);
+    INSTRUMENT_END();
+    return status;
+}
+
+/**
+ * @brief Applique un filtre séparable à une image 8 bits
+ * @param ctx Contexte
+ * @param img Pointeur vers l'image
+ * @param kernel Noyau séparable, construit une fois par l'appelant
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int context_bmp8SeparableFilter(t_bmpContext* ctx, t_bmp8* img, const t_separableKernel* kernel) {
+    if (!ctx || !img || !img->data) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    INSTRUMENT_BEGIN("context_bmp8SeparableFilter");
+    int status = separablePlane(ctx, img->data, img->width, img->width, img->height, 1, kernel);
+    INSTRUMENT_END();
+    return status;
+}
+
+/**
+ * @brief Applique un flou simple de rayon quelconque à une image 8 bits
+ * @param ctx Contexte
+ * @param img Pointeur vers l'image
+ * @param radius Rayon du flou (fenêtre de 2 * radius + 1 pixels de côté)
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int context_bmp8BoxBlurRadius(t_bmpContext* ctx, t_bmp8* img, int radius) {
+    if (!ctx || !img || !img->data) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    INSTRUMENT_BEGIN("context_bmp8BoxBlurRadius");
+    int status = boxBlurPlane(ctx, img->data, img->width, img->width, img->height, 1, radius);
+    INSTRUMENT_END();
+    return status;
+}
+
+/**
+ * @brief Applique un filtre médian à une image 8 bits
+ * @param ctx Contexte
+ * @param img Pointeur vers l'image
+ * @param radius Rayon du filtre (fenêtre de 2 * radius + 1 pixels de côté)
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int context_bmp8MedianFilter(t_bmpContext* ctx, t_bmp8* img, int radius) {
+    if (!ctx || !img || !img->data) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    INSTRUMENT_BEGIN("context_bmp8MedianFilter");
+    int status = medianPlane(ctx, img->data, img->width, img->width, img->height, 1, radius);
+    INSTRUMENT_END();
+    return status;
+}
+
+/**
+ * @brief Applique un noyau 3x3 préconstruit à une image 24 bits
+ * @param ctx Contexte
+ * @param img Structure d'image
+ * @param kernel Noyau (CONTEXT_*)
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int context_bmp24Filter(t_bmpContext* ctx, t_bmp24* img, t_contextKernel kernel) {
+    if (!ctx || !img || !img->data) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    INSTRUMENT_BEGIN("context_bmp24Filter");
+    int status = filterPlane(ctx, (unsigned char*)img->data[0], img->stride, img->width, img->height, 3,
+                             kernel);
+    INSTRUMENT_END();
+    return status;
+}
+
+/**
+ * @brief Applique un filtre séparable à une image 24 bits
+ * @param ctx Contexte
+ * @param img Structure d'image
+ * @param kernel Noyau séparable, construit une fois par l'appelant
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int context_bmp24SeparableFilter(t_bmpContext* ctx, t_bmp24* img, const t_separableKernel* kernel) {
+    if (!ctx || !img || !img->data) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    INSTRUMENT_BEGIN("context_bmp24SeparableFilter");
+    int status = separablePlane(ctx, (unsigned char*)img->data[0], img->stride, img->width, img->height, 3,
+                                kernel);
+    INSTRUMENT_END();
+    return status;
+}
+
+/**
+ * @brief Applique un flou simple de rayon quelconque à une image 24 bits
+ * @param ctx Contexte
+ * @param img Structure d'image
+ * @param radius Rayon du flou (fenêtre de 2 * radius + 1 pixels de côté)
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int context_bmp24BoxBlurRadius(t_bmpContext* ctx, t_bmp24* img, int radius) {
+    if (!ctx || !img || !img->data) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    INSTRUMENT_BEGIN("context_bmp24BoxBlurRadius");
+    int status = boxBlurPlane(ctx, (unsigned char*)img->data[0], img->stride, img->width, img->height, 3,
+                              radius);
+    INSTRUMENT_END();
+    return status;
+}
+
+/**
+ * @brief Applique un filtre médian à une image 24 bits, canal par canal
+ * @param ctx Contexte
+ * @param img Structure d'image
+ * @param radius Rayon du filtre (fenêtre de 2 * radius + 1 pixels de côté)
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int context_bmp24MedianFilter(t_bmpContext* ctx, t_bmp24* img, int radius) {
+    if (!ctx || !img || !img->data) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+
+    INSTRUMENT_BEGIN("context_bmp24MedianFilter");
+    int status = medianPlane(ctx, (unsigned char*)img->data[0], img->stride, img->width, img->height, 3,
+                             radius);
+    INSTRUMENT_END();
+    return status;
+}
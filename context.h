@@ -0,0 +1,63 @@
+/**
+ * @file context.h
+ * @author Projet TI202
+ * @brief Contexte de traitement réutilisable : noyaux préconstruits et zone de travail
+ * @date 2025
+ *
+ * Les fonctions de bmp8.h et bmp24.h allouent à chaque appel leur image
+ * temporaire et, pour les filtres nommés, leur noyau. Un programme qui
+ * traite de nombreuses images (service, traitement par lots) peut créer un
+ * contexte une fois pour toutes et passer par les fonctions context_* :
+ * les noyaux 3x3 sont construits à la création et la zone de travail n'est
+ * agrandie que lorsqu'une image plus grande se présente. Les appels
+ * suivants sur des images de même taille ne font aucune allocation.
+ *
+ * Les résultats sont identiques à ceux des fonctions de bmp8.h et bmp24.h.
+ * Un contexte ne doit être utilisé que par un thread à la fois ; les
+ * traitements eux-mêmes restent répartis entre les threads de threadpool.h.
+ * Les égalisations d'histogramme (bmp8_equalize, bmp24_equalize)
+ * n'allouent rien et s'utilisent directement.
+ */
+
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include <stddef.h>
+#include "bmp8.h"
+#include "bmp24.h"
+#include "filters.h"
+
+// Noyaux 3x3 préconstruits
+typedef enum {
+    CONTEXT_BOX_BLUR,
+    CONTEXT_GAUSSIAN_BLUR,
+    CONTEXT_OUTLINE,
+    CONTEXT_EMBOSS,
+    CONTEXT_SHARPEN,
+    CONTEXT_KERNEL_COUNT
+} t_contextKernel;
+
+// Contexte de traitement
+typedef struct {
+    float** kernels[CONTEXT_KERNEL_COUNT];  // Noyaux construits à la création
+    unsigned char* scratch;                 // Zone de travail partagée par les traitements
+    size_t scratchSize;                     // Taille de la zone de travail, en octets
+} t_bmpContext;
+
+t_bmpContext* context_create(void);
+void context_free(t_bmpContext* ctx);
+void* context_reserve(t_bmpContext* ctx, size_t size);
+
+// Traitements des images 8 bits
+int context_bmp8Filter(t_bmpContext* ctx, t_bmp8* img, t_contextKernel kernel);
+int context_bmp8SeparableFilter(t_bmpContext* ctx, t_bmp8* img, const t_separableKernel* kernel);
+int context_bmp8BoxBlurRadius(t_bmpContext* ctx, t_bmp8* img, int radius);
+int context_bmp8MedianFilter(t_bmpContext* ctx, t_bmp8* img, int radius);
+
+// Traitements des images 24 bits
+int context_bmp24Filter(t_bmpContext* ctx, t_bmp24* img, t_contextKernel kernel);
+int context_bmp24SeparableFilter(t_bmpContext* ctx, t_bmp24* img, const t_separableKernel* kernel);
+int context_bmp24BoxBlurRadius(t_bmpContext* ctx, t_bmp24* img, int radius);
+int context_bmp24MedianFilter(t_bmpContext* ctx, t_bmp24* img, int radius);
+
+#endif // CONTEXT_H
@@ -0,0 +1,1234 @@
+/**
+ * @file convolution.c
+ * @author Projet TI202
+ * @brief Implémentation des moteurs de convolution sur plans d'octets
+ * @date 2025
+ */
+
+#include "convolution.h"
+#include "simd.h"
+#include "threadpool.h"
+#include "instrument.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * Filtres en place par bandes de lignes
+ *
+ * conv_separable et conv_boxBlur écrivent leur résultat dans le plan
+ * qu'ils lisent. Chaque bande de lignes de sortie [start + halo, end + halo)
+ * lit aussi halo lignes au-dessus et au-dessous, qui appartiennent aux
+ * bandes voisines : une première passe copie ces lignes dans la zone de
+ * travail de la bande, avant toute écriture, puis une seconde passe filtre
+ * chaque bande avec son propre anneau. Les deux passes utilisent le même
+ * découpage (threadpool_runBands) et chaque ligne est calculée exactement
+ * comme en un seul passage.
+ */
+
+// Paramètres d'un filtre en place réparti en bandes
+typedef struct {
+    unsigned char* pixels;
+    int pitch;
+    int width;
+    int step;
+    int halo;                          // Lignes lues de part et d'autre d'une bande
+    const t_separableKernel* kernel;   // conv_separable
+    int radius;                        // conv_boxBlur
+    unsigned char* scratch;            // bandSize octets par bande
+    size_t bandSize;
+    size_t haloOffset;                 // Début des lignes de bord copiées dans la zone d'une bande
+} t_inPlaceJob;
+
+/**
+ * @brief Nombre de bandes d'un filtre en place
+ *
+ * Une bande recalcule les 2 * halo lignes de ses bords : elle garde au
+ * moins 4 * halo lignes de sortie pour que ce surcoût reste limité.
+ */
+static int inPlaceBandCount(int rows, int itemWork, int halo) {
+    int bands = threadpool_bandCount(rows, itemWork);
+    int maxBands = halo > 0 ? rows / (4 * halo) : rows;
+    if (maxBands < 1) maxBands = 1;
+    return bands < maxBands ? bands : maxBands;
+}
+
+/**
+ * @brief Taille de la zone d'une bande : work octets de calcul puis les lignes de bord copiées
+ */
+static size_t inPlaceBandSize(size_t work, int width, int step, int halo) {
+    size_t size = work + (size_t)2 * halo * width * step;
+    return (size + 15) & ~(size_t)15;
+}
+
+/**
+ * @brief Copie les lignes de bord de la bande [start, end) avant toute écriture
+ */
+static void saveHaloBand(int start, int end, int band, void* arg) {
+    const t_inPlaceJob* job = (const t_inPlaceJob*)arg;
+    size_t rowBytes = (size_t)job->width * job->step;
+    unsigned char* copy = job->scratch + (size_t)band * job->bandSize + job->haloOffset;
+
+    for (int i = 0; i < job->halo; i++) {
+        memcpy(copy + (size_t)i * rowBytes, job->pixels + (size_t)(start + i) * job->pitch, rowBytes);
+        memcpy(copy + (size_t)(job->halo + i) * rowBytes,
+               job->pixels + (size_t)(end + job->halo + i) * job->pitch, rowBytes);
+    }
+}
+
+/**
+ * @brief Ligne r du plan d'origine, vue depuis la bande [start, end)
+ *
+ * Les lignes de la bande ne sont écrites qu'après leur dernière lecture ;
+ * les lignes de bord viennent de la copie de saveHaloBand.
+ */
+static const unsigned char* inPlaceRow(const t_inPlaceJob* job, const unsigned char* copy,
+                                       int start, int end, int r) {
+    size_t rowBytes = (size_t)job->width * job->step;
+    if (r < start + job->halo) return copy + (size_t)(r - start) * rowBytes;
+    if (r >= end + job->halo) return copy + (size_t)(r - end) * rowBytes;
+    return job->pixels + (size_t)r * job->pitch;
+}
+
+/**
+ * @brief Passe horizontale d'un noyau séparable sur une ligne
+ * @param row Ligne source
+ * @param line Tampon flottant de rowBytes valeurs
+ * @param dst Résultat pour les octets [first, first + count)
+ */
+static void separableRow(const unsigned char* row, float* line, float* dst, int rowBytes,
+                         int first, int count, int step, const t_separableKernel* kernel) {
+    int n = kernel->size / 2;
+
+    for (int i = 0; i < rowBytes; i++) {
+        line[i] = row[i];
+    }
+    for (int x = 0; x < count; x++) {
+        dst[x] = 0;
+    }
+
+    for (int j = 0; j < kernel->size; j++) {
+        const float* src = line + first + (j - n) * step;
+        float w = kernel->horizontal[j];
+        for (int x = 0; x < count; x++) {
+            dst[x] += w * src[x];
+        }
+    }
+}
+
+/**
+ * @brief Octets de calcul d'une bande de conv_separable : anneau, ligne convertie et somme
+ */
+static size_t separableWorkSize(int width, int step, int size) {
+    size_t rowBytes = (size_t)width * step;
+    size_t count = rowBytes - (size_t)(size / 2) * 2 * step;
+    return ((size_t)size * count + rowBytes + count) * sizeof(float);
+}
+
+/**
+ * @brief Nombre de bandes de conv_separable
+ */
+static int separableBandCount(int width, int height, int step, int size) {
+    return inPlaceBandCount(height - 2 * (size / 2), width * step * size, size / 2);
+}
+
+/**
+ * @brief Taille de la zone de travail de conv_separable
+ *
+ * Elle dépend du nombre de bandes, donc du nombre de threads au moment de
+ * l'appel (threadpool_setThreadCount).
+ *
+ * @param width Largeur en pixels
+ * @param height Hauteur en lignes
+ * @param step Écart en octets entre deux pixels d'un même canal
+ * @param size Taille du noyau
+ * @return Nombre d'octets (0 si aucun pixel n'est modifié)
+ */
+size_t conv_separableScratchSize(int width, int height, int step, int size) {
+    if (width < size || height < size) return 0;
+    size_t bandSize = inPlaceBandSize(separableWorkSize(width, step, size), width, step, size / 2);
+    return (size_t)separableBandCount(width, height, step, size) * bandSize;
+}
+
+/**
+ * @brief Filtre séparable des lignes intérieures [start + n, end + n)
+ *
+ * Les résultats de la passe horizontale sont conservés dans un anneau de
+ * kernel->size lignes : la ligne y est écrite une fois la ligne y + n lue.
+ */
+static void separableBand(int start, int end, int band, void* arg) {
+    const t_inPlaceJob* job = (const t_inPlaceJob*)arg;
+    const t_separableKernel* kernel = job->kernel;
+    int k = kernel->size;
+    int n = job->halo;
+    int step = job->step;
+    int rowBytes = job->width * step;
+    int first = n * step;
+    int count = rowBytes - 2 * n * step;
+
+    unsigned char* zone = job->scratch + (size_t)band * job->bandSize;
+    float* ring = (float*)zone;
+    float* line = ring + (size_t)k * count;
+    float* acc = line + rowBytes;
+    const unsigned char* copy = zone + job->haloOffset;
+
+    // Amorcer l'anneau avec les lignes start à start + 2n - 1
+    for (int r = start; r < start + 2 * n; r++) {
+        separableRow(inPlaceRow(job, copy, start, end, r), line, ring + (size_t)(r % k) * count,
+                     rowBytes, first, count, step, kernel);
+    }
+
+    for (int y = start + n; y < end + n; y++) {
+        // La ligne y + n n'a pas encore été modifiée
+        int r = y + n;
+        separableRow(inPlaceRow(job, copy, start, end, r), line, ring + (size_t)(r % k) * count,
+                     rowBytes, first, count, step, kernel);
+
+        // Passe verticale
+        for (int x = 0; x < count; x++) {
+            acc[x] = 0;
+        }
+        for (int i = 0; i < k; i++) {
+            const float* src = ring + (size_t)((y - n + i) % k) * count;
+            float w = kernel->vertical[i];
+            for (int x = 0; x < count; x++) {
+                acc[x] += w * src[x];
+            }
+        }
+
+        // Limiter les valeurs entre 0 et 255
+        unsigned char* out = job->pixels + (size_t)y * job->pitch + first;
+        for (int x = 0; x < count; x++) {
+            float sum = acc[x];
+            if (sum < 0) sum = 0;
+            if (sum > 255) sum = 255;
+            out[x] = (unsigned char)sum;
+        }
+    }
+}
+
+/**
+ * @brief Applique un noyau séparable en deux passes 1D, sur place
+ *
+ * Le coût par pixel est en O(2k) au lieu de O(k²). Les lignes sont
+ * réparties en bandes entre les threads, chacune avec son anneau de
+ * kernel->size lignes ; aucune copie de l'image n'est nécessaire.
+ *
+ * @param pixels Première ligne du plan
+ * @param pitch Nombre d'octets entre deux lignes
+ * @param width Largeur en pixels
+ * @param height Hauteur en lignes
+ * @param step Écart en octets entre deux pixels d'un même canal
+ * @param kernel Noyau séparable
+ * @param scratch Zone de travail de conv_separableScratchSize octets, NULL pour l'allouer ici
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int conv_separable(unsigned char* pixels, int pitch, int width, int height, int step,
+                   const t_separableKernel* kernel, void* scratch) {
+    if (!pixels || !kernel) return -1;
+
+    int k = kernel->size;
+    int n = k / 2;
+    if (width < k || height < k) return 0; // Aucun pixel n'a un voisinage complet
+
+    int rows = height - 2 * n;
+    int bands = separableBandCount(width, height, step, k);
+    size_t workSize = separableWorkSize(width, step, k);
+    size_t bandSize = inPlaceBandSize(workSize, width, step, n);
+
+    unsigned char* zone = scratch ? (unsigned char*)scratch
+                                  : (unsigned char*)instrument_malloc((size_t)bands * bandSize);
+    if (!zone) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        return -1;
+    }
+
+    t_inPlaceJob job = {pixels, pitch, width, step, n, kernel, 0, zone, bandSize, workSize};
+    threadpool_runBands(rows, bands, saveHaloBand, &job);
+    threadpool_runBands(rows, bands, separableBand, &job);
+
+    if (!scratch) free(zone);
+    return 0;
+}
+
+/**
+ * @brief Sommes horizontales glissantes d'une ligne sur une fenêtre de k pixels
+ * @param row Ligne source
+ * @param dst Somme de la fenêtre centrée sur chaque octet [first, first + count)
+ */
+static void boxRowSums(const unsigned char* row, uint32_t* dst, int count, int step, int k) {
+    for (int x = 0; x < count; x++) {
+        if (x < step) {
+            uint32_t sum = 0;
+            for (int j = 0; j < k; j++) {
+                sum += row[x + j * step];
+            }
+            dst[x] = sum;
+        } else {
+            // Faire glisser la fenêtre d'un pixel
+            dst[x] = dst[x - step] - row[x - step] + row[x - step + k * step];
+        }
+    }
+}
+
+/**
+ * @brief Octets de calcul d'une bande de conv_boxBlur : anneau de 2 * radius + 2 lignes et sommes de colonnes
+ */
+static size_t boxBlurWorkSize(int width, int step, int radius) {
+    size_t count = ((size_t)width - 2 * (size_t)radius) * step;
+    return (2 * (size_t)radius + 3) * count * sizeof(uint32_t);
+}
+
+/**
+ * @brief Nombre de bandes de conv_boxBlur
+ */
+static int boxBlurBandCount(int width, int height, int step, int radius) {
+    return inPlaceBandCount(height - 2 * radius, width * step, radius);
+}
+
+/**
+ * @brief Taille de la zone de travail de conv_boxBlur
+ *
+ * Elle dépend du nombre de bandes, donc du nombre de threads au moment de
+ * l'appel (threadpool_setThreadCount).
+ *
+ * @param width Largeur en pixels
+ * @param height Hauteur en lignes
+ * @param step Écart en octets entre deux pixels d'un même canal
+ * @param radius Rayon du flou
+ * @return Nombre d'octets (0 si aucun pixel n'est modifié)
+ */
+size_t conv_boxBlurScratchSize(int width, int height, int step, int radius) {
+    if (radius <= 0 || width < 2 * radius + 1 || height < 2 * radius + 1) return 0;
+    size_t bandSize = inPlaceBandSize(boxBlurWorkSize(width, step, radius), width, step, radius);
+    return (size_t)boxBlurBandCount(width, height, step, radius) * bandSize;
+}
+
+/**
+ * @brief Flou simple des lignes intérieures [start + radius, end + radius)
+ *
+ * Les sommes horizontales glissantes de chaque ligne sont gardées dans un
+ * anneau de 2 * radius + 2 lignes, et une somme par colonne est mise à jour
+ * en ajoutant la ligne qui entre et en retirant celle qui sort.
+ */
+static void boxBlurBand(int start, int end, int band, void* arg) {
+    const t_inPlaceJob* job = (const t_inPlaceJob*)arg;
+    int radius = job->radius;
+    int step = job->step;
+    int k = 2 * radius + 1;
+    int first = radius * step;
+    int count = job->width * step - 2 * first;
+    int slots = k + 1;
+    uint32_t area = (uint32_t)k * k;
+
+    unsigned char* zone = job->scratch + (size_t)band * job->bandSize;
+    uint32_t* ring = (uint32_t*)zone;
+    uint32_t* column = ring + (size_t)slots * count;
+    const unsigned char* copy = zone + job->haloOffset;
+    memset(column, 0, (size_t)count * sizeof(uint32_t));
+
+    // Sommes des k premières lignes de la bande
+    for (int r = start; r < start + k; r++) {
+        uint32_t* sums = ring + (size_t)(r % slots) * count;
+        boxRowSums(inPlaceRow(job, copy, start, end, r), sums, count, step, k);
+        for (int x = 0; x < count; x++) {
+            column[x] += sums[x];
+        }
+    }
+
+    for (int y = start + radius; y < end + radius; y++) {
+        if (y > start + radius) {
+            // La ligne y + radius entre dans la fenêtre, la ligne y - radius - 1 en sort
+            int in = y + radius;
+            uint32_t* added = ring + (size_t)(in % slots) * count;
+            const uint32_t* removed = ring + (size_t)((y - radius - 1) % slots) * count;
+            boxRowSums(inPlaceRow(job, copy, start, end, in), added, count, step, k);
+            for (int x = 0; x < count; x++) {
+                column[x] += added[x] - removed[x];
+            }
+        }
+
+        unsigned char* out = job->pixels + (size_t)y * job->pitch + first;
+        for (int x = 0; x < count; x++) {
+            out[x] = (unsigned char)(column[x] / area);
+        }
+    }
+}
+
+/**
+ * @brief Applique un flou simple de rayon quelconque, sur place
+ *
+ * Le coût par pixel ne dépend pas du rayon. Les lignes sont réparties en
+ * bandes entre les threads, chacune avec son anneau de sommes.
+ *
+ * @param pixels Première ligne du plan
+ * @param pitch Nombre d'octets entre deux lignes
+ * @param width Largeur en pixels
+ * @param height Hauteur en lignes
+ * @param step Écart en octets entre deux pixels d'un même canal
+ * @param radius Rayon du flou (fenêtre de 2 * radius + 1 pixels de côté)
+ * @param scratch Zone de travail de conv_boxBlurScratchSize octets, NULL pour l'allouer ici
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int conv_boxBlur(unsigned char* pixels, int pitch, int width, int height, int step, int radius,
+                 void* scratch) {
+    if (!pixels || radius < 0 || radius > CONV_BOX_MAX_RADIUS) {
+        printf("Erreur: Rayon invalide (0 à %d)\n", CONV_BOX_MAX_RADIUS);
+        return -1;
+    }
+
+    int k = 2 * radius + 1;
+    if (radius == 0 || width < k || height < k) return 0;
+
+    int rows = height - 2 * radius;
+    int bands = boxBlurBandCount(width, height, step, radius);
+    size_t workSize = boxBlurWorkSize(width, step, radius);
+    size_t bandSize = inPlaceBandSize(workSize, width, step, radius);
+
+    unsigned char* zone = scratch ? (unsigned char*)scratch
+                                  : (unsigned char*)instrument_malloc((size_t)bands * bandSize);
+    if (!zone) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        return -1;
+    }
+
+    t_inPlaceJob job = {pixels, pitch, width, step, radius, NULL, radius, zone, bandSize, workSize};
+    threadpool_runBands(rows, bands, saveHaloBand, &job);
+    threadpool_runBands(rows, bands, boxBlurBand, &job);
+
+    if (!scratch) free(zone);
+    return 0;
+}
+
+/*
+ * Convolution 3x3
+ *
+ * Deux représentations du noyau sont utilisées :
+ * - entière : pour un t_intKernel, ou pour un noyau flottant dont chaque
+ *   coefficient vaut c / 2^shift avec c entier (le calcul flottant de
+ *   référence est alors exact et vaut S / 2^shift). La somme S est calculée
+ *   en entiers 16 bits (16 ou 32 pixels par itération) puis divisée par
+ *   décalage, ou par multiplication par l'inverse pour un autre diviseur ;
+ *   la saturation de packus reproduit la limitation à 0-255 ;
+ * - flottante : sinon (flou 1/9 par exemple), les mêmes multiplications et
+ *   additions que la version scalaire sont faites dans le même ordre, voie
+ *   par voie, ce qui donne exactement les mêmes arrondis.
+ */
+
+// Noyau 3x3 préparé pour les versions vectorisées
+typedef struct {
+    float weights[9];    // Coefficients flottants, ligne par ligne
+    int16_t coeffs[9];   // Coefficients entiers
+    int integer;         // 1 si la représentation entière est utilisable
+    int divisor;         // Diviseur de la somme entière
+    int shift;           // log2(divisor) si c'est une puissance de deux, -1 sinon
+    uint16_t mul;        // Sinon S / divisor == (S * mul) >> (16 + mulShift)
+    int mulShift;
+    int level;           // Niveau SIMD, lu une fois dans le thread appelant
+} t_kernel3x3;
+
+/**
+ * @brief Cherche un inverse entier exact du diviseur pour 0 <= S <= maxSum
+ * @return 1 si un couple (mul, mulShift) convient, 0 sinon
+ */
+static int findReciprocal(t_kernel3x3* k, int maxSum) {
+    for (int p = 0; p < 16; p++) {
+        uint32_t m = (uint32_t)((((uint64_t)1 << (16 + p)) + k->divisor - 1) / k->divisor);
+        if (m > 0xFFFF) break;
+
+        int ok = 1;
+        for (int sum = 0; sum <= maxSum && ok; sum++) {
+            if ((int)(((uint32_t)sum * m) >> (16 + p)) != sum / k->divisor) ok = 0;
+        }
+        if (ok) {
+            k->mul = (uint16_t)m;
+            k->mulShift = p;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Prépare un noyau 3x3 flottant et cherche une représentation entière exacte
+ */
+static void prepareKernel3x3(float** kernel, t_kernel3x3* k) {
+    k->level = simd_level();
+    k->mul = 0;
+    k->mulShift = 0;
+    for (int i = 0; i < 9; i++) {
+        k->weights[i] = kernel[i / 3][i % 3];
+    }
+
+    k->integer = 0;
+    for (int shift = 0; shift <= 8 && !k->integer; shift++) {
+        int total = 0, ok = 1;
+        for (int i = 0; i < 9 && ok; i++) {
+            float scaled = k->weights[i] * (float)(1 << shift);
+            int c = (int)scaled;
+            if ((float)c != scaled) ok = 0;
+            k->coeffs[i] = (int16_t)c;
+            total += c < 0 ? -c : c;
+        }
+        // 255 * somme des |c| doit tenir sur 16 bits signés
+        if (ok && total <= 128) {
+            k->integer = 1;
+            k->shift = shift;
+            k->divisor = 1 << shift;
+        }
+    }
+}
+
+/**
+ * @brief Prépare un noyau entier 3x3
+ * @return 1 si le noyau peut être traité en 16 bits, 0 sinon
+ */
+static int prepareIntKernel3x3(const t_intKernel* kernel, t_kernel3x3* k) {
+    k->level = simd_level();
+    k->mul = 0;
+    k->mulShift = 0;
+    int total = 0, positive = 0;
+    for (int i = 0; i < 9; i++) {
+        k->coeffs[i] = kernel->weights[i];
+        k->weights[i] = kernel->weights[i];
+        total += kernel->weights[i] < 0 ? -kernel->weights[i] : kernel->weights[i];
+        if (kernel->weights[i] > 0) positive += kernel->weights[i];
+    }
+
+    k->divisor = kernel->divisor;
+    k->shift = kernel->shift;
+    k->integer = total * 255 <= 32767;
+    if (k->integer && k->shift < 0) {
+        k->integer = findReciprocal(k, positive * 255);
+    }
+    return k->integer;
+}
+
+/**
+ * @brief Version scalaire flottante, identique à bmp8_applyFilter
+ */
+static void row3x3_float(const unsigned char* r0, const unsigned char* r1, const unsigned char* r2,
+                         unsigned char* out, int x, int end, int step, const t_kernel3x3* k) {
+    const float* w = k->weights;
+    for (; x < end; x++) {
+        float sum = 0.0;
+        sum += r0[x - step] * w[0];
+        sum += r0[x] * w[1];
+        sum += r0[x + step] * w[2];
+        sum += r1[x - step] * w[3];
+        sum += r1[x] * w[4];
+        sum += r1[x + step] * w[5];
+        sum += r2[x - step] * w[6];
+        sum += r2[x] * w[7];
+        sum += r2[x + step] * w[8];
+
+        if (sum < 0) sum = 0;
+        if (sum > 255) sum = 255;
+        out[x] = (unsigned char)sum;
+    }
+}
+
+/**
+ * @brief Version scalaire entière
+ */
+static void row3x3_int(const unsigned char* r0, const unsigned char* r1, const unsigned char* r2,
+                       unsigned char* out, int x, int end, int step, const t_kernel3x3* k) {
+    const int16_t* c = k->coeffs;
+    for (; x < end; x++) {
+        int sum = r0[x - step] * c[0] + r0[x] * c[1] + r0[x + step] * c[2]
+                + r1[x - step] * c[3] + r1[x] * c[4] + r1[x + step] * c[5]
+                + r2[x - step] * c[6] + r2[x] * c[7] + r2[x + step] * c[8];
+        if (sum < 0) sum = 0;
+        sum = (k->shift >= 0) ? sum >> k->shift : sum / k->divisor;
+        if (sum > 255) sum = 255;
+        out[x] = (unsigned char)sum;
+    }
+}
+
+#if SIMD_X86
+// Multiplie 16 octets non signés par c et ajoute le produit à lo/hi (16 bits)
+#define MAC16_SSE2(p, c, lo, hi) do { \
+        __m128i v_ = _mm_loadu_si128((const __m128i*)(p)); \
+        lo = _mm_add_epi16(lo, _mm_mullo_epi16(_mm_unpacklo_epi8(v_, zero), c)); \
+        hi = _mm_add_epi16(hi, _mm_mullo_epi16(_mm_unpackhi_epi8(v_, zero), c)); \
+    } while (0)
+
+SIMD_TARGET("sse2")
+static int row3x3_int_sse2(const unsigned char* r0, const unsigned char* r1, const unsigned char* r2,
+                           unsigned char* out, int x, int end, int step, const t_kernel3x3* k) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i c[9];
+    for (int i = 0; i < 9; i++) c[i] = _mm_set1_epi16(k->coeffs[i]);
+    const __m128i shift = _mm_cvtsi32_si128(k->shift >= 0 ? k->shift : k->mulShift);
+    const __m128i mul = _mm_set1_epi16((short)k->mul);
+
+    for (; x + 16 <= end; x += 16) {
+        __m128i lo = zero, hi = zero;
+        MAC16_SSE2(r0 + x - step, c[0], lo, hi);
+        MAC16_SSE2(r0 + x, c[1], lo, hi);
+        MAC16_SSE2(r0 + x + step, c[2], lo, hi);
+        MAC16_SSE2(r1 + x - step, c[3], lo, hi);
+        MAC16_SSE2(r1 + x, c[4], lo, hi);
+        MAC16_SSE2(r1 + x + step, c[5], lo, hi);
+        MAC16_SSE2(r2 + x - step, c[6], lo, hi);
+        MAC16_SSE2(r2 + x, c[7], lo, hi);
+        MAC16_SSE2(r2 + x + step, c[8], lo, hi);
+
+        if (k->shift >= 0) {
+            lo = _mm_sra_epi16(lo, shift);
+            hi = _mm_sra_epi16(hi, shift);
+        } else {
+            lo = _mm_srl_epi16(_mm_mulhi_epu16(_mm_max_epi16(lo, zero), mul), shift);
+            hi = _mm_srl_epi16(_mm_mulhi_epu16(_mm_max_epi16(hi, zero), mul), shift);
+        }
+        _mm_storeu_si128((__m128i*)(out + x), _mm_packus_epi16(lo, hi));
+    }
+    return x;
+}
+
+// Multiplie 32 octets non signés par c et ajoute le produit à lo/hi (16 bits)
+#define MAC32_AVX2(p, c, lo, hi) do { \
+        lo = _mm256_add_epi16(lo, _mm256_mullo_epi16(_mm256_cvtepu8_epi16( \
+                 _mm_loadu_si128((const __m128i*)(p))), c)); \
+        hi = _mm256_add_epi16(hi, _mm256_mullo_epi16(_mm256_cvtepu8_epi16( \
+                 _mm_loadu_si128((const __m128i*)((p) + 16))), c)); \
+    } while (0)
+
+SIMD_TARGET("avx2")
+static int row3x3_int_avx2(const unsigned char* r0, const unsigned char* r1, const unsigned char* r2,
+                           unsigned char* out, int x, int end, int step, const t_kernel3x3* k) {
+    __m256i c[9];
+    for (int i = 0; i < 9; i++) c[i] = _mm256_set1_epi16(k->coeffs[i]);
+    const __m128i shift = _mm_cvtsi32_si128(k->shift >= 0 ? k->shift : k->mulShift);
+    const __m256i mul = _mm256_set1_epi16((short)k->mul);
+    const __m256i zero = _mm256_setzero_si256();
+
+    for (; x + 32 <= end; x += 32) {
+        __m256i lo = _mm256_setzero_si256(), hi = _mm256_setzero_si256();
+        MAC32_AVX2(r0 + x - step, c[0], lo, hi);
+        MAC32_AVX2(r0 + x, c[1], lo, hi);
+        MAC32_AVX2(r0 + x + step, c[2], lo, hi);
+        MAC32_AVX2(r1 + x - step, c[3], lo, hi);
+        MAC32_AVX2(r1 + x, c[4], lo, hi);
+        MAC32_AVX2(r1 + x + step, c[5], lo, hi);
+        MAC32_AVX2(r2 + x - step, c[6], lo, hi);
+        MAC32_AVX2(r2 + x, c[7], lo, hi);
+        MAC32_AVX2(r2 + x + step, c[8], lo, hi);
+
+        if (k->shift >= 0) {
+            lo = _mm256_sra_epi16(lo, shift);
+            hi = _mm256_sra_epi16(hi, shift);
+        } else {
+            lo = _mm256_srl_epi16(_mm256_mulhi_epu16(_mm256_max_epi16(lo, zero), mul), shift);
+            hi = _mm256_srl_epi16(_mm256_mulhi_epu16(_mm256_max_epi16(hi, zero), mul), shift);
+        }
+        // packus travaille par moitié de 128 bits : remettre les octets dans l'ordre
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), 0xD8);
+        _mm256_storeu_si256((__m256i*)(out + x), packed);
+    }
+    return x;
+}
+
+// Convertit 16 octets non signés en 4 vecteurs de 4 flottants
+#define LOAD16_PS_SSE2(p, f) do { \
+        __m128i v_ = _mm_loadu_si128((const __m128i*)(p)); \
+        __m128i l_ = _mm_unpacklo_epi8(v_, zero), h_ = _mm_unpackhi_epi8(v_, zero); \
+        f[0] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(l_, zero)); \
+        f[1] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(l_, zero)); \
+        f[2] = _mm_cvtepi32_ps(_mm_unpacklo_epi16(h_, zero)); \
+        f[3] = _mm_cvtepi32_ps(_mm_unpackhi_epi16(h_, zero)); \
+    } while (0)
+
+SIMD_TARGET("sse2")
+static int row3x3_float_sse2(const unsigned char* r0, const unsigned char* r1, const unsigned char* r2,
+                             unsigned char* out, int x, int end, int step, const t_kernel3x3* k) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 fmin = _mm_setzero_ps(), fmax = _mm_set1_ps(255.0f);
+    const unsigned char* rows[3] = {r0, r1, r2};
+
+    for (; x + 16 <= end; x += 16) {
+        __m128 sum[4] = {_mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps()};
+        for (int t = 0; t < 9; t++) {
+            __m128 f[4];
+            __m128 w = _mm_set1_ps(k->weights[t]);
+            LOAD16_PS_SSE2(rows[t / 3] + x + (t % 3 - 1) * step, f);
+            for (int i = 0; i < 4; i++) {
+                sum[i] = _mm_add_ps(sum[i], _mm_mul_ps(f[i], w));
+            }
+        }
+
+        __m128i v[4];
+        for (int i = 0; i < 4; i++) {
+            v[i] = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(sum[i], fmin), fmax));
+        }
+        __m128i packed = _mm_packus_epi16(_mm_packs_epi32(v[0], v[1]), _mm_packs_epi32(v[2], v[3]));
+        _mm_storeu_si128((__m128i*)(out + x), packed);
+    }
+    return x;
+}
+
+SIMD_TARGET("avx2")
+static int row3x3_float_avx2(const unsigned char* r0, const unsigned char* r1, const unsigned char* r2,
+                             unsigned char* out, int x, int end, int step, const t_kernel3x3* k) {
+    const __m256 fmin = _mm256_setzero_ps(), fmax = _mm256_set1_ps(255.0f);
+    const unsigned char* rows[3] = {r0, r1, r2};
+
+    for (; x + 16 <= end; x += 16) {
+        __m256 lo = _mm256_setzero_ps(), hi = _mm256_setzero_ps();
+        for (int t = 0; t < 9; t++) {
+            __m256 w = _mm256_set1_ps(k->weights[t]);
+            __m128i v = _mm_loadu_si128((const __m128i*)(rows[t / 3] + x + (t % 3 - 1) * step));
+            __m256 fl = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(v));
+            __m256 fh = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(v, 8)));
+            lo = _mm256_add_ps(lo, _mm256_mul_ps(fl, w));
+            hi = _mm256_add_ps(hi, _mm256_mul_ps(fh, w));
+        }
+
+        __m256i il = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(lo, fmin), fmax));
+        __m256i ih = _mm256_cvttps_epi32(_mm256_min_ps(_mm256_max_ps(hi, fmin), fmax));
+        __m256i words = _mm256_permute4x64_epi64(_mm256_packs_epi32(il, ih), 0xD8);
+        __m128i packed = _mm_packus_epi16(_mm256_castsi256_si128(words),
+                                          _mm256_extracti128_si256(words, 1));
+        _mm_storeu_si128((__m128i*)(out + x), packed);
+    }
+    return x;
+}
+#endif
+
+/**
+ * @brief Applique un noyau 3x3 sur une ligne (octets [x, end))
+ */
+static void row3x3(const unsigned char* r0, const unsigned char* r1, const unsigned char* r2,
+                   unsigned char* out, int x, int end, int step, const t_kernel3x3* k) {
+    int level = k->level;
+
+    if (k->integer) {
+#if SIMD_X86
+        if (level >= SIMD_LEVEL_AVX2) x = row3x3_int_avx2(r0, r1, r2, out, x, end, step, k);
+        if (level >= SIMD_LEVEL_SSE2) x = row3x3_int_sse2(r0, r1, r2, out, x, end, step, k);
+#endif
+        row3x3_int(r0, r1, r2, out, x, end, step, k);
+    } else {
+#if SIMD_X86
+        if (level >= SIMD_LEVEL_AVX2) x = row3x3_float_avx2(r0, r1, r2, out, x, end, step, k);
+        if (level >= SIMD_LEVEL_SSE2) x = row3x3_float_sse2(r0, r1, r2, out, x, end, step, k);
+#endif
+        row3x3_float(r0, r1, r2, out, x, end, step, k);
+    }
+    (void)level;
+}
+
+// Paramètres d'un filtrage de src vers dst, partagés par les bandes de lignes
+typedef struct {
+    const unsigned char* src;
+    unsigned char* dst;
+    int pitch;
+    int width;
+    int step;
+    const t_kernel3x3* k;       // Noyau 3x3 préparé
+    const t_intKernel* kernel;  // Noyau entier de taille quelconque
+} t_filterJob;
+
+/**
+ * @brief Filtre 3x3 des lignes intérieures [start + 1, end + 1)
+ */
+static void filter3x3Band(int start, int end, int band, void* arg) {
+    const t_filterJob* job = (const t_filterJob*)arg;
+    int last = (job->width - 1) * job->step;
+    (void)band;
+
+    for (int y = start + 1; y < end + 1; y++) {
+        const unsigned char* r1 = job->src + (size_t)y * job->pitch;
+        row3x3(r1 - job->pitch, r1, r1 + job->pitch, job->dst + (size_t)y * job->pitch,
+               job->step, last, job->step, job->k);
+    }
+}
+
+/**
+ * @brief Filtre entier de taille quelconque des lignes intérieures [start + n, end + n)
+ */
+static void filterIntBand(int start, int end, int band, void* arg) {
+    const t_filterJob* job = (const t_filterJob*)arg;
+    const t_intKernel* kernel = job->kernel;
+    int size = kernel->size;
+    int n = size / 2;
+    int step = job->step;
+    (void)band;
+
+    for (int y = start + n; y < end + n; y++) {
+        unsigned char* out = job->dst + (size_t)y * job->pitch;
+        for (int x = n * step; x < (job->width - n) * step; x++) {
+            int32_t sum = 0;
+            const int16_t* w = kernel->weights;
+            for (int ky = -n; ky <= n; ky++) {
+                const unsigned char* row = job->src + (size_t)(y + ky) * job->pitch + x;
+                for (int kx = -n; kx <= n; kx++) {
+                    sum += row[kx * step] * *w++;
+                }
+            }
+
+            if (sum < 0) sum = 0;
+            sum = (kernel->shift >= 0) ? sum >> kernel->shift : sum / kernel->divisor;
+            if (sum > 255) sum = 255;
+            out[x] = (unsigned char)sum;
+        }
+    }
+}
+
+/**
+ * @brief Applique un noyau 3x3 de src vers dst
+ *
+ * Seul l'intérieur de l'image est écrit dans dst : la première et la
+ * dernière ligne, ainsi que le premier et le dernier pixel de chaque ligne,
+ * ne sont pas modifiés. Le résultat est identique au calcul flottant pixel
+ * par pixel de bmp8_applyFilter.
+ *
+ * @param src Première ligne du plan source
+ * @param dst Première ligne du plan destination (distinct de src)
+ * @param pitch Nombre d'octets entre deux lignes (source et destination)
+ * @param width Largeur en pixels
+ * @param height Hauteur en lignes
+ * @param step Écart en octets entre deux pixels d'un même canal
+ * @param kernel Noyau 3x3
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int conv_filter3x3(const unsigned char* src, unsigned char* dst, int pitch, int width, int height,
+                   int step, float** kernel) {
+    if (!src || !dst || !kernel) return -1;
+
+    t_kernel3x3 k;
+    prepareKernel3x3(kernel, &k);
+
+    t_filterJob job = {src, dst, pitch, width, step, &k, NULL};
+    threadpool_run(height - 2, width, filter3x3Band, &job);
+    return 0;
+}
+
+/**
+ * @brief Applique un noyau entier de src vers dst, en arithmétique entière
+ *
+ * Les sommes sont accumulées sur 32 bits (16 bits dans les versions
+ * vectorisées 3x3 lorsque le noyau le permet), ce qui donne le même
+ * résultat quel que soit le compilateur ou la machine. Seul l'intérieur de
+ * l'image est écrit dans dst.
+ *
+ * @param src Première ligne du plan source
+ * @param dst Première ligne du plan destination (distinct de src)
+ * @param pitch Nombre d'octets entre deux lignes (source et destination)
+ * @param width Largeur en pixels
+ * @param height Hauteur en lignes
+ * @param step Écart en octets entre deux pixels d'un même canal
+ * @param kernel Noyau entier
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int conv_filterInt(const unsigned char* src, unsigned char* dst, int pitch, int width, int height,
+                   int step, const t_intKernel* kernel) {
+    if (!src || !dst || !kernel) return -1;
+
+    t_kernel3x3 k;
+    t_filterJob job = {src, dst, pitch, width, step, &k, kernel};
+    if (kernel->size == 3 && prepareIntKernel3x3(kernel, &k)) {
+        threadpool_run(height - 2, width, filter3x3Band, &job);
+    } else {
+        // Cas général : accumulation scalaire sur 32 bits
+        threadpool_run(height - 2 * (kernel->size / 2), width * kernel->size, filterIntBand, &job);
+    }
+    return 0;
+}
+
+/*
+ * Suite de filtres 3x3 en un seul parcours
+ *
+ * Chaque bande de lignes est découpée en tuiles de colonnes, et chaque
+ * tuile est traitée ligne à ligne par toutes les étapes à la fois : à
+ * l'itération t, l'étape s produit sa ligne t - s, à partir des lignes
+ * t - s - 1 à t - s + 1 de l'étape précédente. Les résultats
+ * intermédiaires ne vivent que dans trois lignes de tuile tournantes par
+ * étape, dimensionnées pour rester en cache (CONV_CHAIN_TILE_BYTES), au
+ * lieu d'une image complète écrite puis relue par chaque filtre. Une tuile
+ * recalcule la marge de count - 1 lignes et colonnes voisines dont elle a
+ * besoin, si bien que tuiles et bandes restent indépendantes.
+ */
+
+// Paramètres d'une suite de filtres, partagés par les bandes de lignes
+typedef struct {
+    const unsigned char* src;
+    unsigned char* dst;
+    int pitch;
+    int width;
+    int height;
+    int step;
+    int count;
+    int tileWidth;             // Largeur d'une tuile en pixels, sans la marge
+    size_t ringPitch;          // Octets d'une ligne de tuile, marge comprise
+    const t_convStage* stages;
+    const t_kernel3x3* k;      // Noyaux préparés, un par étape
+    unsigned char* rings;      // count - 1 fois trois lignes de tuile par bande
+} t_chainJob;
+
+/**
+ * @brief Largeur des tuiles : les lignes tournantes et les trois lignes lues tiennent dans CONV_CHAIN_TILE_BYTES
+ */
+static int chainTileWidth(int width, int step, int count) {
+    int tileWidth = CONV_CHAIN_TILE_BYTES / (step * (3 * count + 1)) - 2 * (count - 1);
+    if (tileWidth < CONV_CHAIN_MIN_TILE) tileWidth = CONV_CHAIN_MIN_TILE;
+    return (tileWidth < width) ? tileWidth : width;
+}
+
+/**
+ * @brief Octets d'une ligne de tuile, marge comprise
+ */
+static size_t chainRingPitch(int width, int step, int count) {
+    int columns = chainTileWidth(width, step, count) + 2 * (count - 1);
+    if (columns > width) columns = width;
+    return (size_t)columns * step;
+}
+
+/**
+ * @brief Produit les colonnes [a, b) d'une ligne d'une étape : bordure recopiée, intérieur filtré, puis table
+ *
+ * Les pointeurs désignent la colonne a ; les lignes lues sont valides de
+ * la colonne a - 1 à la colonne b (dans les limites de l'image).
+ */
+static void chainRow(const t_chainJob* job, int s, int y, int a, int b, const unsigned char* r0,
+                     const unsigned char* r1, const unsigned char* r2, unsigned char* out) {
+    int width = job->width;
+    int step = job->step;
+
+    if (y == 0 || y == job->height - 1 || width < 3) {
+        memcpy(out, r1, (size_t)(b - a) * step);
+    } else {
+        if (a == 0) memcpy(out, r1, step);
+        if (b == width) memcpy(out + (width - 1 - a) * step, r1 + (width - 1 - a) * step, step);
+
+        // Colonnes intérieures [xs, xe), pointeurs décalés sur la colonne xs - 1
+        int xs = (a > 1) ? a : 1;
+        int xe = (b < width - 1) ? b : width - 1;
+        if (xe > xs) {
+            int offset = (xs - 1 - a) * step;
+            row3x3(r0 + offset, r1 + offset, r2 + offset, out + offset, step, (xe - xs + 1) * step, step,
+                   &job->k[s]);
+        }
+    }
+
+    const t_lut* lut = job->stages[s].lut;
+    if (lut) {
+        if (step == 1) {
+            lut_applyBytes(lut->table[LUT_GRAY], out, b - a);
+        } else {
+            lut_applyPixels(lut, out, b - a);
+        }
+    }
+}
+
+/**
+ * @brief Applique toutes les étapes aux colonnes [x0, x1) des lignes [start, end) de la destination
+ */
+static void chainTile(const t_chainJob* job, unsigned char* rings, int start, int end, int x0, int x1) {
+    int count = job->count;
+    int height = job->height;
+    int step = job->step;
+    size_t ringPitch = job->ringPitch;
+
+    // Colonne de l'image stockée au début des lignes de tuile
+    int ox = x0 - (count - 1);
+    if (ox < 0) ox = 0;
+
+    // L'étape s calcule les lignes [start - margin, end + margin) et les
+    // colonnes [x0 - margin, x1 + margin), avec margin = count - 1 - s
+    for (int t = start - (count - 1); t < end + count - 1; t++) {
+        for (int s = 0; s < count; s++) {
+            int y = t - s;
+            int margin = count - 1 - s;
+            if (y < 0 || y >= height || y < start - margin || y >= end + margin) continue;
+
+            int a = (x0 - margin > 0) ? x0 - margin : 0;
+            int b = (x1 + margin < job->width) ? x1 + margin : job->width;
+
+            // Lignes y - 1, y et y + 1 de l'étape précédente (ou de la source), à la colonne a
+            const unsigned char* in[3];
+            for (int d = -1; d <= 1; d++) {
+                int row = y + d;
+                if (row < 0) row = 0;
+                if (row >= height) row = height - 1;
+                in[d + 1] = (s == 0) ? job->src + (size_t)row * job->pitch + (size_t)a * step
+                                     : rings + ((size_t)(s - 1) * 3 + row % 3) * ringPitch + (size_t)(a - ox) * step;
+            }
+
+            unsigned char* out = (s == count - 1) ? job->dst + (size_t)y * job->pitch + (size_t)a * step
+                                                  : rings + ((size_t)s * 3 + y % 3) * ringPitch + (size_t)(a - ox) * step;
+            chainRow(job, s, y, a, b, in[0], in[1], in[2], out);
+        }
+    }
+}
+
+/**
+ * @brief Applique toutes les étapes aux lignes [start, end) de la destination, tuile par tuile
+ */
+static void chainBand(int start, int end, int band, void* arg) {
+    const t_chainJob* job = (const t_chainJob*)arg;
+    unsigned char* rings = job->rings + (size_t)band * (job->count - 1) * 3 * job->ringPitch;
+
+    for (int x0 = 0; x0 < job->width; x0 += job->tileWidth) {
+        int x1 = (x0 + job->tileWidth < job->width) ? x0 + job->tileWidth : job->width;
+        chainTile(job, rings, start, end, x0, x1);
+    }
+}
+
+/**
+ * @brief Taille de la zone de travail de conv_filter3x3Chain, en octets
+ */
+size_t conv_chainScratchSize(int width, int height, int step, int count) {
+    if (count < 2 || width <= 0) return 0;
+    int bands = threadpool_bandCount(height, width * count);
+    if (bands <= 0) return 0;
+    return (size_t)bands * (count - 1) * 3 * chainRingPitch(width, step, count);
+}
+
+/**
+ * @brief Applique une suite de noyaux 3x3, chacun suivi d'une table facultative, de src vers dst
+ *
+ * Le résultat est celui de count appels successifs à conv_filter3x3, la
+ * bordure de chaque résultat étant recopiée de l'image d'entrée de l'étape
+ * (comme bmp8_applyFilterTo), puis la table de l'étape appliquée à toutes
+ * les lignes. Toutes les lignes de dst sont écrites.
+ *
+ * @param src Première ligne du plan source
+ * @param dst Première ligne du plan destination (distinct de src)
+ * @param pitch Nombre d'octets entre deux lignes (source et destination)
+ * @param width Largeur en pixels
+ * @param height Hauteur en lignes
+ * @param step 1 pour une image 8 bits, 3 pour des pixels RGB entrelacés
+ * @param stages Étapes (1 à CONV_CHAIN_MAX_STAGES)
+ * @param count Nombre d'étapes
+ * @param scratch Zone de conv_chainScratchSize octets, NULL pour l'allouer
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int conv_filter3x3Chain(const unsigned char* src, unsigned char* dst, int pitch, int width, int height,
+                        int step, const t_convStage* stages, int count, void* scratch) {
+    if (!src || !dst || src == dst || !stages || count < 1 || count > CONV_CHAIN_MAX_STAGES) return -1;
+    if (step != 1 && step != 3) return -1;
+    if (width <= 0 || height <= 0) return 0;
+
+    t_kernel3x3 k[CONV_CHAIN_MAX_STAGES];
+    for (int s = 0; s < count; s++) {
+        if (!stages[s].kernel) return -1;
+        prepareKernel3x3(stages[s].kernel, &k[s]);
+    }
+
+    unsigned char* rings = NULL;
+    if (count > 1) {
+        rings = scratch ? (unsigned char*)scratch
+                        : (unsigned char*)instrument_malloc(conv_chainScratchSize(width, height, step, count));
+        if (!rings) {
+            printf("Erreur: Allocation mémoire échouée\n");
+            return -1;
+        }
+    }
+
+    t_chainJob job = {src, dst, pitch, width, height, step, count, chainTileWidth(width, step, count),
+                      chainRingPitch(width, step, count), stages, k, rings};
+    threadpool_run(height, width * count, chainBand, &job);
+
+    if (!scratch) free(rings);
+    return 0;
+}
+
+/*
+ * Filtre médian en temps constant
+ *
+ * Méthode de Perreault et Hébert : chaque bande de lignes garde un
+ * histogramme par colonne de l'image, couvrant les 2 * radius + 1 lignes de
+ * la fenêtre ; on le met à jour en ajoutant la ligne qui entre et en retirant
+ * celle qui sort. L'histogramme de la fenêtre glisse ensuite le long de la
+ * ligne en ajoutant une colonne et en retirant une autre.
+ *
+ * Chaque histogramme a deux niveaux : 16 cases grossières (4 bits de poids
+ * fort) et 256 cases fines. Seules les cases grossières de la fenêtre sont
+ * tenues à jour à chaque pixel ; les 16 cases fines du segment contenant la
+ * médiane sont rattrapées à la demande, depuis la dernière colonne où ce
+ * segment a servi, ou recalculées si elle est trop ancienne.
+ */
+
+// Taille des histogrammes d'une colonne : 16 cases grossières et 256 cases fines
+#define MEDIAN_HIST_SIZE (16 + 256)
+
+// Travail d'un pixel, relatif aux autres filtres, pour le découpage en bandes
+#define MEDIAN_ITEM_WORK 4
+
+// Paramètres du filtre médian, partagés par les bandes de lignes
+typedef struct {
+    const unsigned char* src;
+    unsigned char* dst;
+    int pitch;
+    int width;
+    int step;
+    int radius;
+    uint16_t* hist;  // width * MEDIAN_HIST_SIZE compteurs par bande
+} t_medianJob;
+
+/*
+ * Disposition des histogrammes de colonne d'une bande : d'abord les cases
+ * grossières, colonne par colonne (16 compteurs par colonne), puis les cases
+ * fines segment par segment (pour le segment b, 16 compteurs par colonne).
+ * Les colonnes voisines d'un même segment sont ainsi contiguës.
+ */
+
+/**
+ * @brief Ajoute (delta = 1) ou retire (delta = -1) une ligne des histogrammes de colonne
+ */
+static void medianColumnsUpdate(uint16_t* coarse, uint16_t* fine, const unsigned char* row, int width,
+                                int step, int delta) {
+    for (int x = 0; x < width; x++) {
+        int v = row[x * step];
+        coarse[x * 16 + (v >> 4)] += delta;
+        fine[((size_t)(v >> 4) * width + x) * 16 + (v & 15)] += delta;
+    }
+}
+
+/**
+ * @brief Calcule les médianes d'une ligne de l'intérieur à partir des histogrammes de colonne
+ */
+static void medianRow(const uint16_t* coarse, const uint16_t* fine, unsigned char* out, int width, int step,
+                      int radius) {
+    int k = 2 * radius + 1;
+    int half = (k * k + 1) / 2;
+    uint16_t window[16] = {0};       // Cases grossières de la fenêtre
+    uint16_t segments[16][16];       // Cases fines de la fenêtre, à jour pour la colonne lastX[b]
+    int lastX[16];
+
+    for (int b = 0; b < 16; b++) lastX[b] = -k - 1;
+    for (int x = 0; x < k; x++) {
+        for (int b = 0; b < 16; b++) window[b] += coarse[x * 16 + b];
+    }
+
+    for (int x = radius; x < width - radius; x++) {
+        if (x > radius) {
+            const uint16_t* added = coarse + (x + radius) * 16;
+            const uint16_t* removed = coarse + (x - radius - 1) * 16;
+            for (int b = 0; b < 16; b++) window[b] += added[b] - removed[b];
+        }
+
+        // Case grossière contenant la médiane
+        int b = 0;
+        int below = 0;
+        while (below + window[b] < half) below += window[b++];
+
+        // Rattrapage des cases fines de ce segment
+        uint16_t* seg = segments[b];
+        const uint16_t* columns = fine + (size_t)b * width * 16;
+        // Recalcul complet (k colonnes) ou rattrapage (deux colonnes par pas), le moins coûteux
+        if (2 * (x - lastX[b]) > k) {
+            for (int i = 0; i < 16; i++) seg[i] = 0;
+            for (int c = x - radius; c <= x + radius; c++) {
+                for (int i = 0; i < 16; i++) seg[i] += columns[c * 16 + i];
+            }
+        } else {
+            for (int c = lastX[b] + 1; c <= x; c++) {
+                const uint16_t* added = columns + (c + radius) * 16;
+                const uint16_t* removed = columns + (c - radius - 1) * 16;
+                for (int i = 0; i < 16; i++) seg[i] += added[i] - removed[i];
+            }
+        }
+        lastX[b] = x;
+
+        int i = 0;
+        while (below + seg[i] < half) below += seg[i++];
+        out[x * step] = (unsigned char)(b * 16 + i);
+    }
+}
+
+/**
+ * @brief Filtre médian des lignes intérieures [start + radius, end + radius), canal par canal
+ */
+static void medianBand(int start, int end, int band, void* arg) {
+    const t_medianJob* job = (const t_medianJob*)arg;
+    int radius = job->radius;
+    int width = job->width;
+    int step = job->step;
+    uint16_t* coarse = job->hist + (size_t)band * width * MEDIAN_HIST_SIZE;
+    uint16_t* fine = coarse + (size_t)width * 16;
+
+    for (int c = 0; c < step; c++) {
+        const unsigned char* src = job->src + c;
+        memset(coarse, 0, (size_t)width * MEDIAN_HIST_SIZE * sizeof(uint16_t));
+
+        // Fenêtre de la première ligne, sans sa dernière ligne (ajoutée dans la boucle)
+        for (int y = start; y < start + 2 * radius; y++) {
+            medianColumnsUpdate(coarse, fine, src + (size_t)y * job->pitch, width, step, 1);
+        }
+
+        for (int y = start + radius; y < end + radius; y++) {
+            medianColumnsUpdate(coarse, fine, src + (size_t)(y + radius) * job->pitch, width, step, 1);
+            if (y > start + radius) {
+                medianColumnsUpdate(coarse, fine, src + (size_t)(y - radius - 1) * job->pitch, width, step, -1);
+            }
+            medianRow(coarse, fine, job->dst + (size_t)y * job->pitch + c, width, step, radius);
+        }
+    }
+}
+
+/**
+ * @brief Taille de la zone de travail de conv_median
+ *
+ * Elle dépend du nombre de bandes, donc du nombre de threads au moment de
+ * l'appel (threadpool_setThreadCount).
+ *
+ * @param width Largeur en pixels
+ * @param height Hauteur en lignes
+ * @param step Écart en octets entre deux pixels d'un même canal
+ * @param radius Rayon du filtre
+ * @return Nombre d'octets (0 si aucun pixel n'est modifié)
+ */
+size_t conv_medianScratchSize(int width, int height, int step, int radius) {
+    int rows = height - 2 * radius;
+    int bands = threadpool_bandCount(rows, width * step * MEDIAN_ITEM_WORK);
+    if (bands <= 0) return 0;
+    return (size_t)bands * width * MEDIAN_HIST_SIZE * sizeof(uint16_t);
+}
+
+/**
+ * @brief Applique un filtre médian carré de src vers dst, en temps constant par pixel
+ *
+ * Chaque canal est filtré séparément ; le coût par pixel ne dépend pas du
+ * rayon. Chaque bande de lignes garde ses propres histogrammes de colonne
+ * (544 octets par colonne). Seul l'intérieur de l'image est écrit dans dst.
+ *
+ * @param src Première ligne du plan source
+ * @param dst Première ligne du plan destination (distinct de src)
+ * @param pitch Nombre d'octets entre deux lignes (source et destination)
+ * @param width Largeur en pixels
+ * @param height Hauteur en lignes
+ * @param step Écart en octets entre deux pixels d'un même canal
+ * @param radius Rayon du filtre (fenêtre de 2 * radius + 1 pixels de côté)
+ * @param scratch Zone de travail de conv_medianScratchSize octets, NULL pour l'allouer ici
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int conv_median(const unsigned char* src, unsigned char* dst, int pitch, int width, int height,
+                int step, int radius, void* scratch) {
+    if (!src || !dst) return -1;
+    if (radius < 0 || radius > CONV_MEDIAN_MAX_RADIUS) {
+        printf("Erreur: Rayon invalide (0 à %d)\n", CONV_MEDIAN_MAX_RADIUS);
+        return -1;
+    }
+
+    int k = 2 * radius + 1;
+    if (radius == 0 || width < k || height < k) return 0;
+
+    int rows = height - 2 * radius;
+    int itemWork = width * step * MEDIAN_ITEM_WORK;
+
+    uint16_t* hist = scratch ? (uint16_t*)scratch
+                             : (uint16_t*)instrument_malloc(conv_medianScratchSize(width, height, step, radius));
+    if (!hist) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        return -1;
+    }
+
+    t_medianJob job = {src, dst, pitch, width, step, radius, hist};
+    threadpool_run(rows, itemWork, medianBand, &job);
+
+    if (!scratch) free(hist);
+    return 0;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file convolution.h
+ * @author Projet TI202
+ * @brief Moteurs de convolution partagés par les images 8 et 24 bits
+ * @date 2025
+ *
+ * Ces fonctions travaillent sur un plan d'octets : pitch est le nombre
+ * d'octets entre deux lignes et step l'écart entre deux pixels voisins d'un
+ * même canal (1 pour une image 8 bits, 3 pour des pixels RGB entrelacés).
+ * Comme les filtres de bmp8.c et bmp24.c, seuls les pixels dont tout le
+ * voisinage est dans l'image sont modifiés.
+ *
+ * Les chemins SSE2/AVX2 sont choisis à l'exécution ; la variable
+ * d'environnement BMP_NO_SIMD force les versions scalaires. Les filtres de
+ * src vers dst, ainsi que les filtres en place (conv_separable,
+ * conv_boxBlur), répartissent les lignes entre les threads de threadpool.h.
+ *
+ * Les moteurs qui ont besoin de tampons intermédiaires acceptent une zone de
+ * travail fournie par l'appelant (scratch) ; avec NULL, ils l'allouent et la
+ * libèrent eux-mêmes.
+ */
+
+#ifndef CONVOLUTION_H
+#define CONVOLUTION_H
+
+#include "filters.h"
+#include "lut.h"
+#include <stddef.h>
+
+// Rayon maximal du flou par sommes glissantes (les sommes tiennent sur 32 bits)
+#define CONV_BOX_MAX_RADIUS 2000
+
+// Rayon maximal du filtre médian (les comptes de la fenêtre tiennent sur 16 bits)
+#define CONV_MEDIAN_MAX_RADIUS 127
+
+// Nombre maximal d'étapes d'une suite de filtres 3x3
+#define CONV_CHAIN_MAX_STAGES 16
+
+// Octets visés pour les lignes de travail d'une tuile (cache L2), modifiable à la compilation
+#ifndef CONV_CHAIN_TILE_BYTES
+#define CONV_CHAIN_TILE_BYTES (128 * 1024)
+#endif
+
+// Largeur minimale d'une tuile en pixels, pour limiter le recalcul des colonnes de marge
+#define CONV_CHAIN_MIN_TILE 64
+
+// Étape d'une suite de filtres 3x3 : noyau, puis table ponctuelle facultative
+typedef struct {
+    float** kernel;
+    const t_lut* lut;  // Appliquée à la sortie de l'étape, NULL si aucune
+} t_convStage;
+
+int conv_separable(unsigned char* pixels, int pitch, int width, int height, int step,
+                   const t_separableKernel* kernel, void* scratch);
+int conv_filter3x3(const unsigned char* src, unsigned char* dst, int pitch, int width, int height,
+                   int step, float** kernel);
+int conv_filterInt(const unsigned char* src, unsigned char* dst, int pitch, int width, int height,
+                   int step, const t_intKernel* kernel);
+int conv_filter3x3Chain(const unsigned char* src, unsigned char* dst, int pitch, int width, int height,
+                        int step, const t_convStage* stages, int count, void* scratch);
+int conv_boxBlur(unsigned char* pixels, int pitch, int width, int height, int step, int radius,
+                 void* scratch);
+int conv_median(const unsigned char* src, unsigned char* dst, int pitch, int width, int height,
+                int step, int radius, void* scratch);
+
+// Taille des zones de travail, pour les appels sans allocation (voir context.h)
+size_t conv_separableScratchSize(int width, int height, int step, int size);
+size_t conv_boxBlurScratchSize(int width, int height, int step, int radius);
+size_t conv_medianScratchSize(int width, int height, int step, int radius);
+size_t conv_chainScratchSize(int width, int height, int step, int count);
+
+#endif // CONVOLUTION_H
@@ -7,6 +7,7 @@
 
 #include "filters.h"
 #include <stdlib.h>
+#include <math.h>
 
 /**
  * @brief Crée le noyau pour le filtre box blur
@@ -106,3 +107,226 @@ void freeFilterKernel(float** kernel, int size) {
         free(kernel);
     }
 }
+
+/**
+ * @brief Alloue un noyau séparable
+ * @param size Taille du noyau
+ * @return Noyau alloué (coefficients non initialisés), NULL en cas d'erreur
+ */
+static t_separableKernel* allocateSeparableKernel(int size) {
+    if (size <= 0 || size % 2 == 0) return NULL;
+
+    t_separableKernel* kernel = (t_separableKernel*)malloc(sizeof(t_separableKernel));
+    if (!kernel) return NULL;
+
+    kernel->size = size;
+    kernel->horizontal = (float*)malloc(size * sizeof(float));
+    kernel->vertical = (float*)malloc(size * sizeof(float));
+    if (!kernel->horizontal || !kernel->vertical) {
+        freeSeparableKernel(kernel);
+        return NULL;
+    }
+    return kernel;
+}
+
+/**
+ * @brief Crée un noyau séparable de flou simple de taille quelconque
+ * @param size Taille du noyau (impaire)
+ * @return Noyau size x size de coefficients 1 / size², NULL en cas d'erreur
+ */
+t_separableKernel* createSeparableBoxBlurKernel(int size) {
+    t_separableKernel* kernel = allocateSeparableKernel(size);
+    if (!kernel) return NULL;
+
+    for (int i = 0; i < size; i++) {
+        kernel->horizontal[i] = 1.0f / size;
+        kernel->vertical[i] = 1.0f / size;
+    }
+    return kernel;
+}
+
+/**
+ * @brief Crée un noyau gaussien séparable à partir de son écart-type
+ * @param sigma Écart-type en pixels (le rayon vaut ceil(3 * sigma))
+ * @return Noyau normalisé de taille 2 * rayon + 1, NULL en cas d'erreur
+ */
+t_separableKernel* createSeparableGaussianKernel(float sigma) {
+    if (sigma <= 0) return NULL;
+
+    int radius = (int)ceil(3.0 * sigma);
+    t_separableKernel* kernel = allocateSeparableKernel(2 * radius + 1);
+    if (!kernel) return NULL;
+
+    double sum = 0;
+    for (int i = -radius; i <= radius; i++) {
+        sum += exp(-(double)(i * i) / (2.0 * sigma * sigma));
+    }
+    for (int i = -radius; i <= radius; i++) {
+        float w = (float)(exp(-(double)(i * i) / (2.0 * sigma * sigma)) / sum);
+        kernel->horizontal[i + radius] = w;
+        kernel->vertical[i + radius] = w;
+    }
+    return kernel;
+}
+
+/**
+ * @brief Décompose un noyau carré en produit de deux noyaux 1D, si possible
+ *
+ * Le noyau est séparable s'il est de rang 1 : toutes ses lignes sont
+ * proportionnelles à celle qui contient son plus grand coefficient.
+ *
+ * @param kernel Noyau size x size
+ * @param size Taille du noyau (impaire)
+ * @return Noyau séparable équivalent, NULL si le noyau n'est pas séparable
+ */
+t_separableKernel* createSeparableKernel(float** kernel, int size) {
+    if (!kernel) return NULL;
+
+    // Chercher le coefficient de plus grande valeur absolue (pivot)
+    int p = 0, q = 0;
+    float maxAbs = 0;
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            if (fabsf(kernel[i][j]) > maxAbs) {
+                maxAbs = fabsf(kernel[i][j]);
+                p = i;
+                q = j;
+            }
+        }
+    }
+    if (maxAbs == 0) return NULL;
+
+    t_separableKernel* separable = allocateSeparableKernel(size);
+    if (!separable) return NULL;
+
+    for (int i = 0; i < size; i++) {
+        separable->vertical[i] = kernel[i][q];
+        separable->horizontal[i] = kernel[p][i] / kernel[p][q];
+    }
+
+    // Vérifier que le produit redonne bien le noyau
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            float product = separable->vertical[i] * separable->horizontal[j];
+            if (fabsf(product - kernel[i][j]) > 1e-5f * maxAbs) {
+                freeSeparableKernel(separable);
+                return NULL;
+            }
+        }
+    }
+
+    return separable;
+}
+
+/**
+ * @brief Libère un noyau séparable
+ * @param kernel Noyau à libérer
+ */
+void freeSeparableKernel(t_separableKernel* kernel) {
+    if (kernel) {
+        free(kernel->horizontal);
+        free(kernel->vertical);
+        free(kernel);
+    }
+}
+
+/**
+ * @brief Crée un noyau entier à partir de ses coefficients
+ * @param weights size x size coefficients, ligne par ligne
+ * @param size Taille du noyau (impaire)
+ * @param divisor Diviseur appliqué à la somme (> 0)
+ * @return Noyau alloué, NULL en cas d'erreur
+ */
+t_intKernel* createIntKernel(const int16_t* weights, int size, int divisor) {
+    if (!weights || size <= 0 || size % 2 == 0 || divisor <= 0) return NULL;
+
+    t_intKernel* kernel = (t_intKernel*)malloc(sizeof(t_intKernel));
+    if (!kernel) return NULL;
+
+    kernel->weights = (int16_t*)malloc(size * size * sizeof(int16_t));
+    if (!kernel->weights) {
+        free(kernel);
+        return NULL;
+    }
+    for (int i = 0; i < size * size; i++) {
+        kernel->weights[i] = weights[i];
+    }
+
+    kernel->size = size;
+    kernel->divisor = divisor;
+    kernel->shift = -1;
+    for (int s = 0; s < 31; s++) {
+        if ((1 << s) == divisor) {
+            kernel->shift = s;
+            break;
+        }
+    }
+
+    return kernel;
+}
+
+/**
+ * @brief Crée le noyau entier du flou simple (somme / 9)
+ * @return Noyau 3x3 pour box blur
+ */
+t_intKernel* createBoxBlurIntKernel(void) {
+    const int16_t w[9] = {1, 1, 1,
+                          1, 1, 1,
+                          1, 1, 1};
+    return createIntKernel(w, 3, 9);
+}
+
+/**
+ * @brief Crée le noyau entier du flou gaussien (somme >> 4)
+ * @return Noyau 3x3 pour flou gaussien
+ */
+t_intKernel* createGaussianBlurIntKernel(void) {
+    const int16_t w[9] = {1, 2, 1,
+                          2, 4, 2,
+                          1, 2, 1};
+    return createIntKernel(w, 3, 16);
+}
+
+/**
+ * @brief Crée le noyau entier de détection de contours
+ * @return Noyau 3x3 pour détection de contours
+ */
+t_intKernel* createOutlineIntKernel(void) {
+    const int16_t w[9] = {-1, -1, -1,
+                          -1,  8, -1,
+                          -1, -1, -1};
+    return createIntKernel(w, 3, 1);
+}
+
+/**
+ * @brief Crée le noyau entier de relief
+ * @return Noyau 3x3 pour effet de relief
+ */
+t_intKernel* createEmbossIntKernel(void) {
+    const int16_t w[9] = {-2, -1, 0,
+                          -1,  1, 1,
+                           0,  1, 2};
+    return createIntKernel(w, 3, 1);
+}
+
+/**
+ * @brief Crée le noyau entier de netteté
+ * @return Noyau 3x3 pour accentuation de la netteté
+ */
+t_intKernel* createSharpenIntKernel(void) {
+    const int16_t w[9] = { 0, -1,  0,
+                          -1,  5, -1,
+                           0, -1,  0};
+    return createIntKernel(w, 3, 1);
+}
+
+/**
+ * @brief Libère un noyau entier
+ * @param kernel Noyau à libérer
+ */
+void freeIntKernel(t_intKernel* kernel) {
+    if (kernel) {
+        free(kernel->weights);
+        free(kernel);
+    }
+}
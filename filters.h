@@ -5,6 +5,24 @@
 #ifndef FILTERS_H
 #define FILTERS_H
 
+#include <stdint.h>
+
+// Noyau séparable : noyau[i][j] = vertical[i] * horizontal[j]
+typedef struct {
+    int size;            // Taille du noyau (impaire)
+    float* horizontal;   // Coefficients appliqués le long des lignes
+    float* vertical;     // Coefficients appliqués le long des colonnes
+} t_separableKernel;
+
+// Noyau entier : pixel = somme(weights * pixels voisins) / divisor, limité à 0-255
+// Un diviseur puissance de deux est appliqué par décalage (shift >= 0)
+typedef struct {
+    int size;            // Taille du noyau (impaire)
+    int16_t* weights;    // size x size coefficients, ligne par ligne
+    int divisor;         // Diviseur appliqué à la somme (> 0)
+    int shift;           // log2(divisor) si divisor est une puissance de deux, -1 sinon
+} t_intKernel;
+
 // Fonctions pour créer les différents noyaux de filtres
 float** createBoxBlurKernel(void);
 float** createGaussianBlurKernel(void);
@@ -15,4 +33,19 @@ float** createSharpenKernel(void);
 // Fonction pour libérer un noyau
 void freeFilterKernel(float** kernel, int size);
 
+// Fonctions pour les noyaux séparables
+t_separableKernel* createSeparableBoxBlurKernel(int size);
+t_separableKernel* createSeparableGaussianKernel(float sigma);
+t_separableKernel* createSeparableKernel(float** kernel, int size);
+void freeSeparableKernel(t_separableKernel* kernel);
+
+// Fonctions pour les noyaux entiers
+t_intKernel* createIntKernel(const int16_t* weights, int size, int divisor);
+t_intKernel* createBoxBlurIntKernel(void);
+t_intKernel* createGaussianBlurIntKernel(void);
+t_intKernel* createOutlineIntKernel(void);
+t_intKernel* createEmbossIntKernel(void);
+t_intKernel* createSharpenIntKernel(void);
+void freeIntKernel(t_intKernel* kernel);
+
 #endif // FILTERS_H
\ No newline at end of file
@@ -0,0 +1,291 @@
+/**
+ * @file instrument.c
+ * @author Projet TI202
+ * @brief Implémentation de la mesure des fonctions de traitement
+ * @date 2025
+ */
+
+#ifndef _WIN32
+    #define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "instrument.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef _WIN32
+    #include <pthread.h>
+#endif
+
+// Les compteurs sont propres à chaque thread : les appels simultanés (traitement par lots) ne se mélangent pas
+#if defined(__GNUC__)
+    #define INSTRUMENT_THREAD_LOCAL __thread
+#else
+    #define INSTRUMENT_THREAD_LOCAL
+#endif
+
+static INSTRUMENT_THREAD_LOCAL t_instrumentCounters counters;
+
+// Totaux d'une fonction
+typedef struct {
+    const char* name;
+    unsigned long long calls;
+    double seconds;
+    t_instrumentCounters totals;
+} t_instrumentEntry;
+
+// Mesure active : -1 avant la lecture de la configuration, puis 0 ou 1.
+// Lu sans verrou par instrument_begin : un appel inactif ne prend pas lock.
+static volatile int enabledFlag = -1;
+
+// Totaux de toutes les fonctions, protégés par lock
+static struct {
+    const char* output;   // Fichier écrit à la fin du programme, NULL si aucun
+    int count;
+    t_instrumentEntry entries[INSTRUMENT_MAX_ENTRIES];
+} state;
+
+#ifndef _WIN32
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t once = PTHREAD_ONCE_INIT;
+#define INSTRUMENT_LOCK() pthread_mutex_lock(&lock)
+#define INSTRUMENT_UNLOCK() pthread_mutex_unlock(&lock)
+#else
+#define INSTRUMENT_LOCK()
+#define INSTRUMENT_UNLOCK()
+#endif
+
+/**
+ * @brief Horloge en secondes
+ */
+static double instrument_now(void) {
+#ifndef _WIN32
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#else
+    return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+/**
+ * @brief Écrit les totaux à la fin du programme
+ */
+static void instrument_atExit(void) {
+    const char* output;
+    INSTRUMENT_LOCK();
+    output = state.output;
+    INSTRUMENT_UNLOCK();
+
+    if (strcmp(output, "-") == 0) {
+        instrument_writeJSON(stdout);
+    } else {
+        instrument_saveJSON(output);
+    }
+}
+
+/**
+ * @brief Lit la configuration (compilation et variable BMP_INSTRUMENT), une seule fois
+ */
+static void instrument_init(void) {
+    const char* env = getenv("BMP_INSTRUMENT");
+    const char* output = env && *env ? env : NULL;
+#ifdef BMP_INSTRUMENT
+    if (!output) output = INSTRUMENT_DEFAULT_FILE;
+#endif
+    if (!output) {
+        enabledFlag = 0;
+        return;
+    }
+
+    INSTRUMENT_LOCK();
+    state.output = output;
+    INSTRUMENT_UNLOCK();
+    atexit(instrument_atExit);
+    enabledFlag = 1;
+}
+
+/**
+ * @brief Lit la configuration au premier appel
+ */
+static void instrument_initOnce(void) {
+#ifndef _WIN32
+    pthread_once(&once, instrument_init);
+#else
+    static int initialized = 0;
+    if (!initialized) {
+        initialized = 1;
+        instrument_init();
+    }
+#endif
+}
+
+/**
+ * @brief Active ou désactive la mesure
+ * @param enabled 1 pour activer, 0 pour désactiver
+ */
+void instrument_setEnabled(int enabled) {
+    instrument_initOnce();
+    enabledFlag = enabled != 0;
+}
+
+/**
+ * @brief Indique si la mesure est active
+ * @return 1 si active, 0 sinon
+ */
+int instrument_isEnabled(void) {
+    int enabled = enabledFlag;
+    if (enabled < 0) {
+        // Premier appel : la configuration est lue une seule fois
+        instrument_initOnce();
+        enabled = enabledFlag;
+    }
+    return enabled;
+}
+
+/**
+ * @brief Remet tous les totaux à zéro
+ */
+void instrument_reset(void) {
+    INSTRUMENT_LOCK();
+    state.count = 0;
+    memset(state.entries, 0, sizeof(state.entries));
+    INSTRUMENT_UNLOCK();
+}
+
+/**
+ * @brief Début d'un appel : mémorise l'heure et les compteurs du thread
+ * @param scope Appel en cours (variable locale de la fonction mesurée)
+ * @param name Nom de la fonction (chaîne constante)
+ */
+void instrument_begin(t_instrumentScope* scope, const char* name) {
+    scope->name = name;
+    scope->active = instrument_isEnabled();
+    if (!scope->active) return;
+
+    scope->before = counters;
+    scope->start = instrument_now();
+}
+
+/**
+ * @brief Fin d'un appel : ajoute sa durée et ses compteurs aux totaux de la fonction
+ * @param scope Appel commencé par instrument_begin
+ */
+void instrument_end(t_instrumentScope* scope) {
+    if (!scope->active) return;
+
+    double seconds = instrument_now() - scope->start;
+
+    INSTRUMENT_LOCK();
+    t_instrumentEntry* entry = NULL;
+    for (int i = 0; i < state.count; i++) {
+        if (strcmp(state.entries[i].name, scope->name) == 0) {
+            entry = &state.entries[i];
+            break;
+        }
+    }
+    if (!entry && state.count < INSTRUMENT_MAX_ENTRIES) {
+        entry = &state.entries[state.count++];
+        entry->name = scope->name;
+    }
+
+    if (entry) {
+        entry->calls++;
+        entry->seconds += seconds;
+        entry->totals.bytesRead += counters.bytesRead - scope->before.bytesRead;
+        entry->totals.bytesWritten += counters.bytesWritten - scope->before.bytesWritten;
+        entry->totals.allocations += counters.allocations - scope->before.allocations;
+        entry->totals.allocatedBytes += counters.allocatedBytes - scope->before.allocatedBytes;
+    }
+    INSTRUMENT_UNLOCK();
+}
+
+/**
+ * @brief Compteurs cumulés du thread appelant (lectures, écritures, allocations)
+ * @return Copie des compteurs, à comparer à une copie antérieure
+ */
+t_instrumentCounters instrument_getCounters(void) {
+    return counters;
+}
+
+/**
+ * @brief Compte des octets lus dans un fichier
+ * @param bytes Nombre d'octets
+ */
+void instrument_addRead(size_t bytes) {
+    counters.bytesRead += bytes;
+}
+
+/**
+ * @brief Compte des octets écrits dans un fichier
+ * @param bytes Nombre d'octets
+ */
+void instrument_addWritten(size_t bytes) {
+    counters.bytesWritten += bytes;
+}
+
+/**
+ * @brief malloc comptabilisé
+ */
+void* instrument_malloc(size_t size) {
+    counters.allocations++;
+    counters.allocatedBytes += size;
+    return malloc(size);
+}
+
+/**
+ * @brief calloc comptabilisé
+ */
+void* instrument_calloc(size_t count, size_t size) {
+    counters.allocations++;
+    counters.allocatedBytes += count * size;
+    return calloc(count, size);
+}
+
+/**
+ * @brief realloc comptabilisé (la nouvelle taille compte comme une allocation)
+ */
+void* instrument_realloc(void* ptr, size_t size) {
+    counters.allocations++;
+    counters.allocatedBytes += size;
+    return realloc(ptr, size);
+}
+
+/**
+ * @brief Écrit les totaux au format JSON
+ * @param file Flux de sortie
+ */
+void instrument_writeJSON(FILE* file) {
+    if (!file) return;
+
+    INSTRUMENT_LOCK();
+    fprintf(file, "{\n  \"functions\": [");
+    for (int i = 0; i < state.count; i++) {
+        const t_instrumentEntry* entry = &state.entries[i];
+        fprintf(file, "%s\n    {\"name\": \"%s\", \"calls\": %llu, \"seconds\": %.9f, "
+                "\"bytesRead\": %llu, \"bytesWritten\": %llu, \"allocations\": %llu, \"allocatedBytes\": %llu}",
+                i > 0 ? "," : "", entry->name, entry->calls, entry->seconds,
+                entry->totals.bytesRead, entry->totals.bytesWritten,
+                entry->totals.allocations, entry->totals.allocatedBytes);
+    }
+    fprintf(file, "%s]\n}\n", state.count > 0 ? "\n  " : "");
+    INSTRUMENT_UNLOCK();
+}
+
+/**
+ * @brief Écrit les totaux dans un fichier JSON
+ * @param filename Nom du fichier
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int instrument_saveJSON(const char* filename) {
+    FILE* file = fopen(filename, "w");
+    if (!file) {
+        printf("Erreur: Impossible d'ouvrir le fichier %s en écriture\n", filename);
+        return -1;
+    }
+
+    instrument_writeJSON(file);
+    fclose(file);
+    return 0;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file instrument.h
+ * @author Projet TI202
+ * @brief Mesure du temps, des entrées/sorties et des allocations de chaque fonction de traitement
+ * @date 2025
+ *
+ * Les fonctions publiques de bmp8, bmp24, bmpview et bmpstream, ainsi que
+ * les chaînes d'opérations (pipeline, lazy, batch) sont encadrées par
+ * INSTRUMENT_BEGIN / INSTRUMENT_END. Lorsque la mesure est
+ * active, chaque appel ajoute au total de la fonction sa durée, les octets
+ * lus et écrits dans les fichiers ainsi que le nombre et la taille des
+ * allocations faites par le thread appelant. Les totaux sont inclusifs :
+ * bmp24_gaussianBlur compte aussi le bmp24_applyFilter qu'elle appelle.
+ *
+ * La mesure est active :
+ *     - si le programme est compilé avec -DBMP_INSTRUMENT ;
+ *     - si la variable d'environnement BMP_INSTRUMENT est définie : sa
+ *       valeur est le fichier JSON écrit à la fin du programme ("-" pour la
+ *       sortie standard) ;
+ *     - après instrument_setEnabled(1).
+ * Inactive, elle se limite à un test par appel.
+ */
+
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+// Nombre maximal de fonctions suivies
+#define INSTRUMENT_MAX_ENTRIES 64
+
+// Fichier écrit à la fin du programme quand la mesure est activée à la compilation
+#define INSTRUMENT_DEFAULT_FILE "instrument.json"
+
+// Compteurs d'un thread
+typedef struct {
+    unsigned long long bytesRead;
+    unsigned long long bytesWritten;
+    unsigned long long allocations;
+    unsigned long long allocatedBytes;
+} t_instrumentCounters;
+
+// Appel en cours de mesure
+typedef struct {
+    const char* name;
+    int active;
+    double start;
+    t_instrumentCounters before;
+} t_instrumentScope;
+
+#define INSTRUMENT_BEGIN(name) \
+    t_instrumentScope instrumentScope; \
+    instrument_begin(&instrumentScope, name)
+#define INSTRUMENT_END() instrument_end(&instrumentScope)
+
+void instrument_setEnabled(int enabled);
+int instrument_isEnabled(void);
+void instrument_reset(void);
+void instrument_begin(t_instrumentScope* scope, const char* name);
+void instrument_end(t_instrumentScope* scope);
+t_instrumentCounters instrument_getCounters(void);
+
+void instrument_addRead(size_t bytes);
+void instrument_addWritten(size_t bytes);
+void* instrument_malloc(size_t size);
+void* instrument_calloc(size_t count, size_t size);
+void* instrument_realloc(void* ptr, size_t size);
+
+void instrument_writeJSON(FILE* file);
+int instrument_saveJSON(const char* filename);
+
+#endif // INSTRUMENT_H
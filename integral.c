@@ -0,0 +1,135 @@
+/**
+ * @file integral.c
+ * @author Projet TI202
+ * @brief Implémentation des images intégrales
+ * @date 2025
+ */
+
+#include "integral.h"
+#include "instrument.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @brief Construit l'image intégrale d'un plan 8 bits
+ * @param pixels Première ligne du plan
+ * @param pitch Nombre d'octets entre deux lignes
+ * @param width Largeur en pixels
+ * @param height Hauteur en lignes
+ * @return Image intégrale, NULL en cas d'erreur
+ */
+t_integralImage* integral_create(const unsigned char* pixels, int pitch, int width, int height) {
+    if (!pixels || width <= 0 || height <= 0) return NULL;
+
+    t_integralImage* integral = (t_integralImage*)instrument_malloc(sizeof(t_integralImage));
+    if (!integral) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        return NULL;
+    }
+
+    size_t cols = (size_t)width + 1;
+    integral->width = width;
+    integral->height = height;
+    integral->sum = (uint64_t*)instrument_malloc(cols * (height + 1) * sizeof(uint64_t));
+    integral->sumSq = (uint64_t*)instrument_malloc(cols * (height + 1) * sizeof(uint64_t));
+    if (!integral->sum || !integral->sumSq) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        integral_free(integral);
+        return NULL;
+    }
+
+    // Première ligne et première colonne à zéro
+    for (size_t x = 0; x < cols; x++) {
+        integral->sum[x] = 0;
+        integral->sumSq[x] = 0;
+    }
+
+    for (int y = 0; y < height; y++) {
+        const unsigned char* row = pixels + (size_t)y * pitch;
+        const uint64_t* above = integral->sum + (size_t)y * cols;
+        const uint64_t* aboveSq = integral->sumSq + (size_t)y * cols;
+        uint64_t* cur = integral->sum + (size_t)(y + 1) * cols;
+        uint64_t* curSq = integral->sumSq + (size_t)(y + 1) * cols;
+
+        uint64_t rowSum = 0, rowSumSq = 0;
+        cur[0] = 0;
+        curSq[0] = 0;
+        for (int x = 0; x < width; x++) {
+            rowSum += row[x];
+            rowSumSq += (uint64_t)row[x] * row[x];
+            cur[x + 1] = above[x + 1] + rowSum;
+            curSq[x + 1] = aboveSq[x + 1] + rowSumSq;
+        }
+    }
+
+    return integral;
+}
+
+/**
+ * @brief Libère une image intégrale
+ * @param integral Image intégrale à libérer
+ */
+void integral_free(t_integralImage* integral) {
+    if (integral) {
+        free(integral->sum);
+        free(integral->sumSq);
+        free(integral);
+    }
+}
+
+/**
+ * @brief Somme des pixels d'un rectangle en temps constant
+ * @param integral Image intégrale
+ * @param x0 Colonne de gauche (incluse)
+ * @param y0 Ligne du haut (incluse)
+ * @param x1 Colonne de droite (incluse)
+ * @param y1 Ligne du bas (incluse)
+ * @return Somme des pixels du rectangle (coordonnées ramenées dans l'image)
+ */
+uint64_t integral_sum(const t_integralImage* integral, int x0, int y0, int x1, int y1) {
+    if (x0 < 0) x0 = 0;
+    if (y0 < 0) y0 = 0;
+    if (x1 >= integral->width) x1 = integral->width - 1;
+    if (y1 >= integral->height) y1 = integral->height - 1;
+    if (x0 > x1 || y0 > y1) return 0;
+
+    size_t cols = (size_t)integral->width + 1;
+    const uint64_t* s = integral->sum;
+    return s[(y1 + 1) * cols + x1 + 1] - s[y0 * cols + x1 + 1]
+         - s[(y1 + 1) * cols + x0] + s[y0 * cols + x0];
+}
+
+/**
+ * @brief Moyenne et variance d'une fenêtre carrée en temps constant
+ *
+ * La fenêtre de 2 * radius + 1 pixels de côté est tronquée aux bords de
+ * l'image.
+ *
+ * @param integral Image intégrale
+ * @param x Colonne du centre
+ * @param y Ligne du centre
+ * @param radius Rayon de la fenêtre
+ * @param mean Moyenne calculée (peut être NULL)
+ * @param variance Variance calculée (peut être NULL)
+ */
+void integral_localStats(const t_integralImage* integral, int x, int y, int radius,
+                         float* mean, float* variance) {
+    int x0 = x - radius < 0 ? 0 : x - radius;
+    int y0 = y - radius < 0 ? 0 : y - radius;
+    int x1 = x + radius >= integral->width ? integral->width - 1 : x + radius;
+    int y1 = y + radius >= integral->height ? integral->height - 1 : y + radius;
+
+    size_t cols = (size_t)integral->width + 1;
+    const uint64_t* s = integral->sum;
+    const uint64_t* q = integral->sumSq;
+    size_t a = (size_t)y0 * cols + x0, b = (size_t)y0 * cols + x1 + 1;
+    size_t c = (size_t)(y1 + 1) * cols + x0, d = (size_t)(y1 + 1) * cols + x1 + 1;
+
+    double count = (double)(x1 - x0 + 1) * (y1 - y0 + 1);
+    double m = (double)(s[d] - s[b] - s[c] + s[a]) / count;
+    if (mean) *mean = (float)m;
+    if (variance) {
+        double v = (double)(q[d] - q[b] - q[c] + q[a]) / count - m * m;
+        *variance = (float)(v > 0 ? v : 0);
+    }
+}
@@ -0,0 +1,27 @@
+/**
+ * @file integral.h
+ * @author Projet TI202
+ * @brief Images intégrales (tables de sommes cumulées) pour les statistiques locales
+ * @date 2025
+ */
+
+#ifndef INTEGRAL_H
+#define INTEGRAL_H
+
+#include <stdint.h>
+
+// Table de sommes cumulées : sum[y][x] = somme des pixels [0, x) x [0, y)
+typedef struct {
+    int width;           // Largeur de l'image d'origine
+    int height;          // Hauteur de l'image d'origine
+    uint64_t* sum;       // (width + 1) x (height + 1) sommes des valeurs
+    uint64_t* sumSq;     // (width + 1) x (height + 1) sommes des carrés
+} t_integralImage;
+
+t_integralImage* integral_create(const unsigned char* pixels, int pitch, int width, int height);
+void integral_free(t_integralImage* integral);
+uint64_t integral_sum(const t_integralImage* integral, int x0, int y0, int x1, int y1);
+void integral_localStats(const t_integralImage* integral, int x, int y, int radius,
+                         float* mean, float* variance);
+
+#endif // INTEGRAL_H
@@ -0,0 +1,223 @@
+/**
+ * @file lazy.c
+ * @author Projet TI202
+ * @brief Implémentation des traitements différés
+ * @date 2025
+ */
+
+#include "lazy.h"
+#include "instrument.h"
+
+/**
+ * @brief Associe une image chargée à une chaîne vide
+ * @return Image différée, NULL en cas d'erreur (les images ne sont pas libérées)
+ */
+static t_lazyImage* lazy_create(t_bmp8* img8, t_bmp24* img24) {
+    t_lazyImage* img = (t_lazyImage*)calloc(1, sizeof(t_lazyImage));
+    t_pipeline* pending = (t_pipeline*)calloc(1, sizeof(t_pipeline));
+    if (!img || !pending) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        free(img);
+        free(pending);
+        return NULL;
+    }
+
+    img->img8 = img8;
+    img->img24 = img24;
+    img->pending = pending;
+    return img;
+}
+
+/**
+ * @brief Charge une image 8 ou 24 bits sans lui appliquer d'opération
+ * @param filename Fichier BMP
+ * @return Image différée, NULL en cas d'erreur
+ */
+t_lazyImage* lazy_load(const char* filename) {
+    if (!filename) return NULL;
+
+    int depth = pipeline_readColorDepth(filename);
+    if (depth == 8) {
+        return lazy_wrap8(bmp8_loadImage(filename));
+    }
+    if (depth == 24) {
+        return lazy_wrap24(bmp24_loadImage(filename));
+    }
+
+    if (depth > 0) {
+        printf("Erreur: Profondeur de couleur non supportée (%d bits) pour %s\n", depth, filename);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Prend en charge une image 8 bits, libérée avec l'image différée
+ * @param img Image 8 bits
+ * @return Image différée, NULL en cas d'erreur
+ */
+t_lazyImage* lazy_wrap8(t_bmp8* img) {
+    if (!img) return NULL;
+
+    t_lazyImage* lazy = lazy_create(img, NULL);
+    if (!lazy) bmp8_free(img);
+    return lazy;
+}
+
+/**
+ * @brief Prend en charge une image 24 bits, libérée avec l'image différée
+ * @param img Image 24 bits
+ * @return Image différée, NULL en cas d'erreur
+ */
+t_lazyImage* lazy_wrap24(t_bmp24* img) {
+    if (!img) return NULL;
+
+    t_lazyImage* lazy = lazy_create(NULL, img);
+    if (!lazy) bmp24_free(img);
+    return lazy;
+}
+
+/**
+ * @brief Libère l'image et les opérations qui n'ont pas été appliquées
+ * @param img Image différée
+ */
+void lazy_free(t_lazyImage* img) {
+    if (!img) return;
+
+    bmp8_free(img->img8);
+    bmp24_free(img->img24);
+    pipeline_free(img->pending);
+    free(img);
+}
+
+/**
+ * @brief Enregistre des opérations décrites comme pour --ops (voir pipeline.h)
+ * @param img Image différée
+ * @param spec Opérations séparées par des virgules, par exemple "gauss,negative"
+ * @return 0 en cas de succès, -1 si une opération est invalide
+ */
+int lazy_ops(t_lazyImage* img, const char* spec) {
+    if (!img || !spec) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+    return pipeline_append(img->pending, spec);
+}
+
+/**
+ * @brief Enregistre un négatif
+ */
+int lazy_negative(t_lazyImage* img) {
+    return lazy_ops(img, "negative");
+}
+
+/**
+ * @brief Enregistre un ajustement de luminosité
+ * @param value Valeur d'ajustement (peut être négative)
+ */
+int lazy_brightness(t_lazyImage* img, int value) {
+    char spec[32];
+    snprintf(spec, sizeof(spec), "brightness=%d", value);
+    return lazy_ops(img, spec);
+}
+
+/**
+ * @brief Enregistre un seuillage binaire (canal par canal en 24 bits)
+ * @param threshold Valeur de seuil
+ */
+int lazy_threshold(t_lazyImage* img, int threshold) {
+    char spec[32];
+    snprintf(spec, sizeof(spec), "threshold=%d", threshold);
+    return lazy_ops(img, spec);
+}
+
+/**
+ * @brief Enregistre un flou simple 3x3
+ */
+int lazy_blur(t_lazyImage* img) {
+    return lazy_ops(img, "blur");
+}
+
+/**
+ * @brief Enregistre un flou gaussien 3x3
+ */
+int lazy_gaussianBlur(t_lazyImage* img) {
+    return lazy_ops(img, "gauss");
+}
+
+/**
+ * @brief Enregistre un filtre de netteté
+ */
+int lazy_sharpen(t_lazyImage* img) {
+    return lazy_ops(img, "sharpen");
+}
+
+/**
+ * @brief Enregistre une détection de contours
+ */
+int lazy_outline(t_lazyImage* img) {
+    return lazy_ops(img, "outline");
+}
+
+/**
+ * @brief Enregistre un effet de relief
+ */
+int lazy_emboss(t_lazyImage* img) {
+    return lazy_ops(img, "emboss");
+}
+
+/**
+ * @brief Applique les opérations en attente, puis vide la chaîne
+ *
+ * Après une opération gray8, l'image 24 bits est remplacée par une image
+ * 8 bits (voir pipeline_apply).
+ *
+ * @param img Image différée
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int lazy_materialize(t_lazyImage* img) {
+    if (!img) return -1;
+    if (img->pending->count == 0) return 0;
+
+    INSTRUMENT_BEGIN("lazy_materialize");
+    int result = pipeline_apply(img->pending, &img->img8, &img->img24);
+    pipeline_clear(img->pending);
+    INSTRUMENT_END();
+    return result;
+}
+
+/**
+ * @brief Donne accès aux pixels de l'image 8 bits, après application des opérations en attente
+ * @return Image 8 bits, NULL si l'image est en couleur ou en cas d'erreur
+ */
+t_bmp8* lazy_bmp8(t_lazyImage* img) {
+    if (lazy_materialize(img) != 0) return NULL;
+    return img->img8;
+}
+
+/**
+ * @brief Donne accès aux pixels de l'image 24 bits, après application des opérations en attente
+ * @return Image 24 bits, NULL si l'image est en niveaux de gris ou en cas d'erreur
+ */
+t_bmp24* lazy_bmp24(t_lazyImage* img) {
+    if (lazy_materialize(img) != 0) return NULL;
+    return img->img24;
+}
+
+/**
+ * @brief Applique les opérations en attente et sauvegarde l'image
+ * @param img Image différée
+ * @param filename Fichier destination
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int lazy_save(t_lazyImage* img, const char* filename) {
+    if (!img || !filename) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+    if (lazy_materialize(img) != 0) return -1;
+
+    if (img->img8) {
+        return bmp8_saveImage(filename, img->img8);
+    }
+    return bmp24_saveImage(img->img24, filename);
+}
@@ -0,0 +1,69 @@
+/**
+ * @file lazy.h
+ * @author Projet TI202
+ * @brief Traitements différés : les opérations sont enregistrées puis appliquées d'un bloc
+ * @date 2025
+ *
+ * Les fonctions lazy_* ne modifient pas l'image : elles ajoutent
+ * l'opération à une chaîne en attente (pipeline.h). La chaîne n'est
+ * appliquée qu'au moment où le résultat est nécessaire, c'est-à-dire à la
+ * sauvegarde (lazy_save) ou à l'accès aux pixels (lazy_bmp8, lazy_bmp24,
+ * lazy_materialize). Elle est alors optimisée dans son ensemble :
+ *
+ *     - les opérations ponctuelles consécutives (négatif, luminosité,
+ *       seuillage) ne forment qu'une table ;
+ *     - cette table est appliquée à chaque ligne dès la sortie du noyau
+ *       3x3 qui la précède, sans parcours supplémentaire ;
+ *     - les noyaux 3x3 consécutifs sont calculés en un seul parcours de
+ *       l'image, les résultats intermédiaires ne dépassant pas quelques
+ *       lignes (conv_filter3x3Chain).
+ *
+ * Le résultat est identique à celui des fonctions bmp8_* et bmp24_*
+ * appelées dans le même ordre.
+ *
+ *     t_lazyImage* img = lazy_load("entree.bmp");
+ *     lazy_gaussianBlur(img);
+ *     lazy_sharpen(img);
+ *     lazy_negative(img);
+ *     lazy_save(img, "sortie.bmp");  // Un seul parcours pour les trois
+ *     lazy_free(img);
+ */
+
+#ifndef LAZY_H
+#define LAZY_H
+
+#include "bmp8.h"
+#include "bmp24.h"
+#include "pipeline.h"
+
+// Image et opérations en attente
+typedef struct {
+    t_bmp8* img8;         // Image 8 bits, ou NULL
+    t_bmp24* img24;       // Image 24 bits, ou NULL
+    t_pipeline* pending;  // Opérations enregistrées, pas encore appliquées
+} t_lazyImage;
+
+// Création et libération
+t_lazyImage* lazy_load(const char* filename);
+t_lazyImage* lazy_wrap8(t_bmp8* img);
+t_lazyImage* lazy_wrap24(t_bmp24* img);
+void lazy_free(t_lazyImage* img);
+
+// Opérations enregistrées
+int lazy_negative(t_lazyImage* img);
+int lazy_brightness(t_lazyImage* img, int value);
+int lazy_threshold(t_lazyImage* img, int threshold);
+int lazy_blur(t_lazyImage* img);
+int lazy_gaussianBlur(t_lazyImage* img);
+int lazy_sharpen(t_lazyImage* img);
+int lazy_outline(t_lazyImage* img);
+int lazy_emboss(t_lazyImage* img);
+int lazy_ops(t_lazyImage* img, const char* spec);
+
+// Application des opérations en attente
+int lazy_materialize(t_lazyImage* img);
+t_bmp8* lazy_bmp8(t_lazyImage* img);
+t_bmp24* lazy_bmp24(t_lazyImage* img);
+int lazy_save(t_lazyImage* img, const char* filename);
+
+#endif // LAZY_H
@@ -0,0 +1,168 @@
+/**
+ * @file lut.c
+ * @author Projet TI202
+ * @brief Implémentation des tables de correspondance
+ * @date 2025
+ */
+
+#include "lut.h"
+#include <string.h>
+
+/**
+ * @brief Remplace les valeurs d'un ou des trois canaux par f(valeur, param)
+ */
+static void lut_map(t_lut* lut, int channel, int (*f)(int, int), int param) {
+    for (int c = 0; c < 3; c++) {
+        if (channel != LUT_ALL && channel != c) continue;
+        for (int i = 0; i < 256; i++) {
+            int v = f(lut->table[c][i], param);
+            if (v < 0) v = 0;
+            if (v > 255) v = 255;
+            lut->table[c][i] = (unsigned char)v;
+        }
+    }
+}
+
+static int op_negative(int v, int param) { (void)param; return 255 - v; }
+static int op_brightness(int v, int value) { return v + value; }
+static int op_threshold(int v, int threshold) { return (v >= threshold) ? 255 : 0; }
+
+/**
+ * @brief Initialise une table qui ne modifie aucune valeur
+ * @param lut Table à initialiser
+ */
+void lut_identity(t_lut* lut) {
+    for (int c = 0; c < 3; c++) {
+        for (int i = 0; i < 256; i++) {
+            lut->table[c][i] = (unsigned char)i;
+        }
+    }
+}
+
+/**
+ * @brief Ajoute un négatif à la chaîne
+ * @param lut Table à compléter
+ * @param channel Canal (LUT_RED, LUT_GREEN, LUT_BLUE) ou LUT_ALL
+ */
+void lut_negative(t_lut* lut, int channel) {
+    lut_map(lut, channel, op_negative, 0);
+}
+
+/**
+ * @brief Ajoute un ajustement de luminosité à la chaîne (résultat limité à 0-255)
+ * @param lut Table à compléter
+ * @param channel Canal ou LUT_ALL
+ * @param value Valeur d'ajustement (peut être négative)
+ */
+void lut_brightness(t_lut* lut, int channel, int value) {
+    lut_map(lut, channel, op_brightness, value);
+}
+
+/**
+ * @brief Ajoute un seuillage binaire à la chaîne
+ * @param lut Table à compléter
+ * @param channel Canal ou LUT_ALL
+ * @param threshold Valeur de seuil
+ */
+void lut_threshold(t_lut* lut, int channel, int threshold) {
+    lut_map(lut, channel, op_threshold, threshold);
+}
+
+/**
+ * @brief Ajoute une table de 256 valeurs quelconque à la chaîne
+ *
+ * Sert par exemple à enchaîner l'égalisation avec la table renvoyée par
+ * bmp8_computeCDF.
+ *
+ * @param lut Table à compléter
+ * @param channel Canal ou LUT_ALL
+ * @param map Nouvelle valeur de chaque niveau (limitée à 255)
+ */
+void lut_remap(t_lut* lut, int channel, const unsigned int* map) {
+    for (int c = 0; c < 3; c++) {
+        if (channel != LUT_ALL && channel != c) continue;
+        for (int i = 0; i < 256; i++) {
+            unsigned int v = map[lut->table[c][i]];
+            lut->table[c][i] = (unsigned char)(v > 255 ? 255 : v);
+        }
+    }
+}
+
+/**
+ * @brief Compose deux tables : lut devient « lut puis next »
+ * @param lut Table à compléter
+ * @param next Table appliquée après lut
+ */
+void lut_compose(t_lut* lut, const t_lut* next) {
+    for (int c = 0; c < 3; c++) {
+        for (int i = 0; i < 256; i++) {
+            lut->table[c][i] = next->table[c][lut->table[c][i]];
+        }
+    }
+}
+
+/**
+ * @brief Indique si les trois canaux utilisent la même table
+ * @param lut Table
+ * @return 1 si les tables sont identiques, 0 sinon
+ */
+int lut_isUniform(const t_lut* lut) {
+    return memcmp(lut->table[0], lut->table[1], 256) == 0
+        && memcmp(lut->table[0], lut->table[2], 256) == 0;
+}
+
+/**
+ * @brief Remplace chaque octet v de data par table[v]
+ *
+ * Une recherche dans une table de 256 octets n'a pas d'équivalent
+ * vectoriel rapide en SSE/AVX2 (pshufb ne couvre que 16 entrées) : la
+ * boucle lit quatre octets avant d'en écrire aucun, ce qui laisse les
+ * quatre recherches se dérouler en parallèle.
+ *
+ * @param table Table de 256 valeurs
+ * @param data Octets à transformer
+ * @param count Nombre d'octets
+ */
+void lut_applyBytes(const unsigned char* table, unsigned char* data, size_t count) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        unsigned char a = table[data[i]];
+        unsigned char b = table[data[i + 1]];
+        unsigned char c = table[data[i + 2]];
+        unsigned char d = table[data[i + 3]];
+        data[i] = a;
+        data[i + 1] = b;
+        data[i + 2] = c;
+        data[i + 3] = d;
+    }
+    for (; i < count; i++) {
+        data[i] = table[data[i]];
+    }
+}
+
+/**
+ * @brief Applique une table par canal à des pixels RGB entrelacés
+ *
+ * Si les trois tables sont identiques, les pixels sont traités comme une
+ * simple suite d'octets. Sinon, les trois canaux sont transformés dans le
+ * même parcours, un pixel à la fois.
+ *
+ * @param lut Table par canal
+ * @param rgb Pixels (rouge, vert, bleu)
+ * @param count Nombre de pixels
+ */
+void lut_applyPixels(const t_lut* lut, unsigned char* rgb, size_t count) {
+    if (lut_isUniform(lut)) {
+        lut_applyBytes(lut->table[0], rgb, count * 3);
+        return;
+    }
+
+    const unsigned char* r = lut->table[LUT_RED];
+    const unsigned char* g = lut->table[LUT_GREEN];
+    const unsigned char* b = lut->table[LUT_BLUE];
+    for (size_t i = 0; i < count; i++, rgb += 3) {
+        rgb[0] = r[rgb[0]];
+        rgb[1] = g[rgb[1]];
+        rgb[2] = b[rgb[2]];
+    }
+}
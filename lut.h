@@ -0,0 +1,53 @@
+/**
+ * @file lut.h
+ * @author Projet TI202
+ * @brief Tables de correspondance pour enchaîner des opérations ponctuelles en une seule passe
+ * @date 2025
+ *
+ * Une opération ponctuelle (négatif, luminosité, seuillage, égalisation...)
+ * ne dépend que de la valeur du pixel : elle se résume à une table de 256
+ * valeurs. Chaque fonction lut_xxx compose son opération avec celles déjà
+ * présentes dans la table, si bien qu'une chaîne quelconque d'opérations
+ * s'applique ensuite en un seul parcours de l'image (bmp8_applyLUT,
+ * bmp24_applyLUT).
+ *
+ * Exemple : luminosité +40, puis négatif, puis seuillage à 128
+ *     t_lut lut;
+ *     lut_identity(&lut);
+ *     lut_brightness(&lut, LUT_ALL, 40);
+ *     lut_negative(&lut, LUT_ALL);
+ *     lut_threshold(&lut, LUT_ALL, 128);
+ *     bmp24_applyLUT(img, &lut);
+ */
+
+#ifndef LUT_H
+#define LUT_H
+
+#include <stddef.h>
+
+// Canaux d'une table (ordre des composantes de t_pixel)
+#define LUT_RED   0
+#define LUT_GREEN 1
+#define LUT_BLUE  2
+#define LUT_GRAY  0   // Table utilisée pour les images 8 bits
+#define LUT_ALL   -1  // Les trois canaux
+
+// Une table de 256 valeurs par canal
+typedef struct {
+    unsigned char table[3][256];
+} t_lut;
+
+// Construction et composition
+void lut_identity(t_lut* lut);
+void lut_negative(t_lut* lut, int channel);
+void lut_brightness(t_lut* lut, int channel, int value);
+void lut_threshold(t_lut* lut, int channel, int threshold);
+void lut_remap(t_lut* lut, int channel, const unsigned int* map);
+void lut_compose(t_lut* lut, const t_lut* next);
+int lut_isUniform(const t_lut* lut);
+
+// Application sur des octets ou des pixels RGB entrelacés
+void lut_applyBytes(const unsigned char* table, unsigned char* data, size_t count);
+void lut_applyPixels(const t_lut* lut, unsigned char* rgb, size_t count);
+
+#endif // LUT_H
@@ -11,6 +11,9 @@
 #include "bmp8.h"
 #include "bmp24.h"
 #include "filters.h"
+#include "pipeline.h"
+#include "batch.h"
+#include "threadpool.h"
 
 // Variables globales pour stocker les images courantes
 t_bmp8* currentImage8 = NULL;
@@ -473,13 +476,183 @@ void launchAutomaticTests(void) {
     printf("- tests_24bits/\n");
 }
 
+/**
+ * @brief Affiche l'aide du mode ligne de commande
+ * @param program Nom du programme
+ */
+void printUsage(const char* program) {
+    printf("Utilisation :\n");
+    printf("  %s   (menu interactif)\n", program);
+    printf("  %s -i entree.bmp -o sortie.bmp --ops \"gauss,sharpen,equalize\"\n", program);
+    printf("  %s -o dossier --ops \"...\" image1.bmp image2.bmp ...\n", program);
+    printf("\nOptions :\n");
+    printf("  -i FICHIER       Image d'entrée (option répétable, ou fichiers en fin de ligne)\n");
+    printf("  -o CHEMIN        Image de sortie, ou dossier existant si plusieurs entrées\n");
+    printf("  --ops LISTE      Opérations séparées par des virgules :\n");
+    printf("                   negative, brightness=N, threshold=N, grayscale, gray8, blur,\n");
+    printf("                   blur=R, median=R, gauss, gauss=SIGMA, sharpen, outline, emboss,\n");
+    printf("                   equalize, clahe, clahe=LIMITE\n");
+    printf("  --threads N      Nombre de threads (par défaut : nombre de processeurs)\n");
+    printf("  --workers N      Images traitées en même temps dans un lot (par défaut : %d)\n", BATCH_DEFAULT_WORKERS);
+    printf("  -h, --help       Affiche cette aide\n");
+}
+
+/**
+ * @brief Construit le chemin de sortie d'une image dans un dossier
+ *
+ * Seul le nom du fichier d'entrée est conservé : deux entrées de même nom
+ * dans des dossiers différents donnent le même chemin (voir runBatch).
+ *
+ * @param dir Dossier de sortie
+ * @param input Chemin de l'image d'entrée
+ * @param output Tampon recevant le chemin
+ * @param size Taille du tampon
+ * @return 0 en cas de succès, -1 si le chemin ne tient pas dans le tampon
+ */
+int buildOutputPath(const char* dir, const char* input, char* output, size_t size) {
+    const char* name = input;
+    for (const char* p = input; *p; p++) {
+        if (*p == '/' || *p == '\\') name = p + 1;
+    }
+
+    int length = snprintf(output, size, "%s/%s", dir, name);
+    if (length < 0 || (size_t)length >= size) {
+        printf("Erreur : Chemin de sortie trop long pour %s\n", input);
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Mode ligne de commande : applique une chaîne d'opérations à une ou plusieurs images
+ *
+ * La chaîne est analysée et ses noyaux construits une seule fois pour tout
+ * le lot. Avec plusieurs images, la lecture, les calculs et l'écriture se
+ * recouvrent (batch_run) et le débit est affiché à la fin.
+ *
+ * @param argc Nombre d'arguments
+ * @param argv Arguments
+ * @return 0 si toutes les images ont été traitées, 1 sinon
+ */
+int runBatch(int argc, char* argv[]) {
+    const char** inputs = (const char**)malloc(argc * sizeof(const char*));
+    if (!inputs) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        return 1;
+    }
+
+    int inputCount = 0;
+    const char* output = NULL;
+    const char* ops = NULL;
+    int workers = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        int hasValue = i + 1 < argc;
+
+        if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) {
+            printUsage(argv[0]);
+            free(inputs);
+            return 0;
+        } else if (strcmp(arg, "-i") == 0 && hasValue) {
+            inputs[inputCount++] = argv[++i];
+        } else if (strcmp(arg, "-o") == 0 && hasValue) {
+            output = argv[++i];
+        } else if (strcmp(arg, "--ops") == 0 && hasValue) {
+            ops = argv[++i];
+        } else if (strcmp(arg, "--workers") == 0 && hasValue) {
+            workers = atoi(argv[++i]);
+        } else if (strcmp(arg, "--threads") == 0 && hasValue) {
+            threadpool_setThreadCount(atoi(argv[++i]));
+        } else if (arg[0] == '-') {
+            printf("Erreur : Option invalide ou incomplète '%s'\n\n", arg);
+            printUsage(argv[0]);
+            free(inputs);
+            return 1;
+        } else {
+            inputs[inputCount++] = arg;
+        }
+    }
+
+    if (inputCount == 0 || !output || !ops) {
+        printf("Erreur : -o, --ops et au moins une image d'entrée sont nécessaires\n\n");
+        printUsage(argv[0]);
+        free(inputs);
+        return 1;
+    }
+
+    t_pipeline* pipeline = pipeline_parse(ops);
+    if (!pipeline) {
+        free(inputs);
+        return 1;
+    }
+
+    int failures = 0;
+    if (inputCount == 1) {
+        if (pipeline_processFile(pipeline, inputs[0], output) != 0) {
+            printf("Erreur : Échec du traitement de %s\n", inputs[0]);
+            failures = 1;
+        }
+    } else {
+        // Chemins de sortie dans le dossier indiqué
+        char* paths = (char*)malloc((size_t)inputCount * 1024);
+        const char** outputs = (const char**)malloc(inputCount * sizeof(const char*));
+        if (!paths || !outputs) {
+            printf("Erreur: Allocation mémoire échouée\n");
+            failures = inputCount;
+        } else {
+            int valid = 1;
+            for (int i = 0; i < inputCount && valid; i++) {
+                outputs[i] = paths + (size_t)i * 1024;
+                if (buildOutputPath(output, inputs[i], paths + (size_t)i * 1024, 1024) != 0) {
+                    valid = 0;
+                }
+
+                // Deux images de même nom s'écraseraient dans le dossier de sortie
+                for (int j = 0; j < i && valid; j++) {
+                    if (strcmp(outputs[j], outputs[i]) == 0) {
+                        printf("Erreur : %s et %s seraient écrites dans le même fichier %s\n",
+                               inputs[j], inputs[i], outputs[i]);
+                        valid = 0;
+                    }
+                }
+            }
+
+            if (!valid) {
+                failures = inputCount;
+            } else {
+                t_batchStats stats;
+                failures = batch_run(pipeline, inputs, outputs, inputCount, workers, &stats);
+                if (failures >= 0) {
+                    batch_printStats(&stats);
+                } else {
+                    failures = inputCount;
+                }
+            }
+        }
+        free(paths);
+        free(outputs);
+    }
+
+    pipeline_free(pipeline);
+    free(inputs);
+    return failures == 0 ? 0 : 1;
+}
+
 /**
  * @brief Fonction principale
+ *
+ * Sans argument, le programme affiche le menu interactif ; avec des
+ * arguments, il traite les images indiquées sans interaction (runBatch).
  */
-int main(void) {
+int main(int argc, char* argv[]) {
     int choice;
     int running = 1;
 
+    if (argc > 1) {
+        return runBatch(argc, argv);
+    }
+
     printf("=================================================\n");
     printf("   PROGRAMME DE TRAITEMENT D'IMAGES BMP\n");
     printf("   Projet TI202 - Algorithmique et Structures\n");
@@ -0,0 +1,515 @@
+/**
+ * @file pipeline.c
+ * @author Projet TI202
+ * @brief Implémentation des chaînes d'opérations
+ * @date 2025
+ */
+
+#include "pipeline.h"
+#include "convolution.h"
+#include "instrument.h"
+#include <ctype.h>
+
+/**
+ * @brief Ajoute une opération vide à la chaîne
+ * @return Pointeur vers la nouvelle opération, NULL en cas d'erreur
+ */
+static t_pipeOp* pipeline_add(t_pipeline* pipeline, t_pipeOpType type) {
+    t_pipeOp* ops = (t_pipeOp*)realloc(pipeline->ops, (pipeline->count + 1) * sizeof(t_pipeOp));
+    if (!ops) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        return NULL;
+    }
+    pipeline->ops = ops;
+
+    t_pipeOp* op = &ops[pipeline->count++];
+    memset(op, 0, sizeof(*op));
+    op->type = type;
+    return op;
+}
+
+/**
+ * @brief Renvoie la table où ajouter une opération ponctuelle
+ *
+ * La table de l'opération précédente est réutilisée si c'en est une, ce
+ * qui fusionne les opérations ponctuelles consécutives.
+ */
+static t_lut* pipeline_lut(t_pipeline* pipeline) {
+    if (pipeline->count > 0 && pipeline->ops[pipeline->count - 1].type == PIPE_LUT) {
+        return &pipeline->ops[pipeline->count - 1].lut;
+    }
+
+    t_pipeOp* op = pipeline_add(pipeline, PIPE_LUT);
+    if (!op) return NULL;
+    lut_identity(&op->lut);
+    return &op->lut;
+}
+
+/**
+ * @brief Ajoute une opération à noyau 3x3
+ */
+static int pipeline_addKernel(t_pipeline* pipeline, float** kernel) {
+    if (!kernel) return -1;
+
+    t_pipeOp* op = pipeline_add(pipeline, PIPE_KERNEL);
+    if (!op) {
+        freeFilterKernel(kernel, 3);
+        return -1;
+    }
+    op->kernel = kernel;
+    return 0;
+}
+
+/**
+ * @brief Analyse une opération « nom » ou « nom=valeur » et l'ajoute à la chaîne
+ * @return 0 en cas de succès, -1 si l'opération est inconnue ou invalide
+ */
+static int pipeline_addOp(t_pipeline* pipeline, char* token) {
+    char* arg = strchr(token, '=');
+    if (arg) *arg++ = '\0';
+
+    char* end = NULL;
+    long value = arg ? strtol(arg, &end, 10) : 0;
+    int isInt = arg && *arg && *end == '\0';
+
+    t_lut* lut;
+    t_pipeOp* op;
+
+    if (strcmp(token, "negative") == 0 && !arg) {
+        if (!(lut = pipeline_lut(pipeline))) return -1;
+        lut_negative(lut, LUT_ALL);
+    } else if (strcmp(token, "brightness") == 0 && isInt && value >= -255 && value <= 255) {
+        if (!(lut = pipeline_lut(pipeline))) return -1;
+        lut_brightness(lut, LUT_ALL, (int)value);
+    } else if (strcmp(token, "threshold") == 0 && isInt && value >= 0 && value <= 255) {
+        if (!(lut = pipeline_lut(pipeline))) return -1;
+        lut_threshold(lut, LUT_ALL, (int)value);
+    } else if (strcmp(token, "grayscale") == 0 && !arg) {
+        if (!pipeline_add(pipeline, PIPE_GRAYSCALE)) return -1;
+    } else if (strcmp(token, "gray8") == 0 && !arg) {
+        if (!pipeline_add(pipeline, PIPE_GRAY8)) return -1;
+    } else if (strcmp(token, "blur") == 0 && !arg) {
+        return pipeline_addKernel(pipeline, createBoxBlurKernel());
+    } else if (strcmp(token, "blur") == 0 && isInt && value > 0 && value <= CONV_BOX_MAX_RADIUS) {
+        if (!(op = pipeline_add(pipeline, PIPE_BOX_RADIUS))) return -1;
+        op->radius = (int)value;
+    } else if (strcmp(token, "median") == 0 && isInt && value > 0 && value <= CONV_MEDIAN_MAX_RADIUS) {
+        if (!(op = pipeline_add(pipeline, PIPE_MEDIAN))) return -1;
+        op->radius = (int)value;
+    } else if (strcmp(token, "gauss") == 0 && !arg) {
+        return pipeline_addKernel(pipeline, createGaussianBlurKernel());
+    } else if (strcmp(token, "gauss") == 0 && arg) {
+        float sigma = strtof(arg, &end);
+        if (*end != '\0' || sigma <= 0) return -1;
+        t_separableKernel* separable = createSeparableGaussianKernel(sigma);
+        if (!separable) return -1;
+        if (!(op = pipeline_add(pipeline, PIPE_SEPARABLE))) {
+            freeSeparableKernel(separable);
+            return -1;
+        }
+        op->separable = separable;
+    } else if (strcmp(token, "sharpen") == 0 && !arg) {
+        return pipeline_addKernel(pipeline, createSharpenKernel());
+    } else if (strcmp(token, "outline") == 0 && !arg) {
+        return pipeline_addKernel(pipeline, createOutlineKernel());
+    } else if (strcmp(token, "emboss") == 0 && !arg) {
+        return pipeline_addKernel(pipeline, createEmbossKernel());
+    } else if (strcmp(token, "equalize") == 0 && !arg) {
+        if (!pipeline_add(pipeline, PIPE_EQUALIZE)) return -1;
+    } else if (strcmp(token, "clahe") == 0) {
+        float clipLimit = CLAHE_DEFAULT_CLIP;
+        if (arg) {
+            clipLimit = strtof(arg, &end);
+            if (*end != '\0' || clipLimit < 0) return -1;
+        }
+        if (!(op = pipeline_add(pipeline, PIPE_CLAHE))) return -1;
+        op->clipLimit = clipLimit;
+    } else {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Ajoute à une chaîne les opérations d'une liste séparée par des virgules
+ *
+ * Une opération ponctuelle ajoutée juste après une autre est fusionnée
+ * dans sa table. En cas d'erreur, les opérations déjà ajoutées par cet
+ * appel restent dans la chaîne.
+ *
+ * @param pipeline Chaîne à compléter
+ * @param spec Chaîne telle que "gauss,sharpen,equalize" (voir pipeline.h)
+ * @return 0 en cas de succès, -1 si une opération est inconnue ou invalide
+ */
+int pipeline_append(t_pipeline* pipeline, const char* spec) {
+    if (!pipeline || !spec) return -1;
+
+    char* copy = (char*)malloc(strlen(spec) + 1);
+    if (!copy) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        return -1;
+    }
+    strcpy(copy, spec);
+
+    for (char* token = strtok(copy, ","); token; token = strtok(NULL, ",")) {
+        // Ignorer les espaces autour du nom
+        while (isspace((unsigned char)*token)) token++;
+        char* last = token + strlen(token);
+        while (last > token && isspace((unsigned char)last[-1])) *--last = '\0';
+        if (*token == '\0') continue;
+
+        char name[64];
+        snprintf(name, sizeof(name), "%s", token);
+        if (pipeline_addOp(pipeline, token) != 0) {
+            printf("Erreur: Opération invalide '%s'\n", name);
+            free(copy);
+            return -1;
+        }
+    }
+
+    free(copy);
+    return 0;
+}
+
+/**
+ * @brief Analyse une chaîne d'opérations séparées par des virgules
+ * @param spec Chaîne telle que "gauss,sharpen,equalize" (voir pipeline.h)
+ * @return Chaîne préparée, NULL si une opération est inconnue ou invalide
+ */
+t_pipeline* pipeline_parse(const char* spec) {
+    if (!spec) return NULL;
+
+    t_pipeline* pipeline = (t_pipeline*)calloc(1, sizeof(t_pipeline));
+    if (!pipeline) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        return NULL;
+    }
+
+    if (pipeline_append(pipeline, spec) != 0) {
+        pipeline_free(pipeline);
+        return NULL;
+    }
+    return pipeline;
+}
+
+/**
+ * @brief Retire toutes les opérations d'une chaîne, qui reste utilisable
+ * @param pipeline Chaîne à vider
+ */
+void pipeline_clear(t_pipeline* pipeline) {
+    if (!pipeline) return;
+
+    for (int i = 0; i < pipeline->count; i++) {
+        if (pipeline->ops[i].kernel) freeFilterKernel(pipeline->ops[i].kernel, 3);
+        if (pipeline->ops[i].separable) freeSeparableKernel(pipeline->ops[i].separable);
+    }
+    free(pipeline->ops);
+    pipeline->ops = NULL;
+    pipeline->count = 0;
+}
+
+/**
+ * @brief Libère une chaîne et ses noyaux
+ * @param pipeline Chaîne à libérer
+ */
+void pipeline_free(t_pipeline* pipeline) {
+    if (!pipeline) return;
+
+    pipeline_clear(pipeline);
+    free(pipeline);
+}
+
+/**
+ * @brief Rassemble la suite de noyaux 3x3 qui commence à l'opération first
+ *
+ * Chaque noyau reçoit la table ponctuelle qui le suit éventuellement : elle
+ * est appliquée à chaque ligne dès sa sortie du filtre, au lieu d'un
+ * parcours de plus sur toute l'image.
+ *
+ * @param stages Étapes remplies (CONV_CHAIN_MAX_STAGES au plus)
+ * @param count Nombre d'étapes
+ * @return Indice de la dernière opération absorbée
+ */
+static int pipeline_collectKernels(const t_pipeline* pipeline, int first, t_convStage* stages, int* count) {
+    int i = first;
+    int n = 0;
+    while (i < pipeline->count && pipeline->ops[i].type == PIPE_KERNEL && n < CONV_CHAIN_MAX_STAGES) {
+        stages[n].kernel = pipeline->ops[i].kernel;
+        stages[n].lut = NULL;
+        if (i + 1 < pipeline->count && pipeline->ops[i + 1].type == PIPE_LUT) {
+            stages[n].lut = &pipeline->ops[++i].lut;
+        }
+        n++;
+        i++;
+    }
+    *count = n;
+    return i - 1;
+}
+
+/**
+ * @brief Applique la suite de noyaux 3x3 (et de tables) qui commence à l'opération first
+ *
+ * Toute la suite est calculée en un seul parcours (conv_filter3x3Chain),
+ * de spare vers img : les pixels de img restent à leur adresse.
+ *
+ * @param index Indice de la première opération, remplacé par celui de la dernière appliquée
+ * @param spare Image de travail, dont le tampon est réservé au premier appel
+ * @return 0 en cas de succès, -1 en cas d'erreur d'allocation
+ */
+static int pipeline_applyKernels8(const t_pipeline* pipeline, int* index, t_bmp8* img, t_bmp8* spare) {
+    t_convStage stages[CONV_CHAIN_MAX_STAGES];
+    int count;
+    *index = pipeline_collectKernels(pipeline, *index, stages, &count);
+
+    INSTRUMENT_BEGIN("pipeline_applyKernels8");
+
+    if (!spare->data) {
+        spare->data = (unsigned char*)instrument_malloc(img->dataSize);
+        if (!spare->data) {
+            printf("Erreur: Allocation mémoire échouée\n");
+            INSTRUMENT_END();
+            return -1;
+        }
+    }
+
+    memcpy(spare->data, img->data, img->dataSize);
+    int result = conv_filter3x3Chain(spare->data, img->data, img->width, img->width, img->height, 1,
+                                     stages, count, NULL);
+    INSTRUMENT_END();
+    return result;
+}
+
+/**
+ * @brief Applique la suite de noyaux 3x3 (et de tables) qui commence à l'opération first
+ *
+ * Le résultat est calculé dans une image de travail dont les pixels sont
+ * ensuite échangés avec ceux de img.
+ *
+ * @param index Indice de la première opération, remplacé par celui de la dernière appliquée
+ * @param spare Image de travail, allouée au premier appel
+ * @return 0 en cas de succès, -1 en cas d'erreur d'allocation
+ */
+static int pipeline_applyKernels24(const t_pipeline* pipeline, int* index, t_bmp24* img, t_bmp24** spare) {
+    t_convStage stages[CONV_CHAIN_MAX_STAGES];
+    int count;
+    *index = pipeline_collectKernels(pipeline, *index, stages, &count);
+
+    INSTRUMENT_BEGIN("pipeline_applyKernels24");
+
+    if (!*spare) {
+        *spare = bmp24_allocate(img->width, img->height, img->colorDepth);
+        if (!*spare) {
+            INSTRUMENT_END();
+            return -1;
+        }
+    }
+
+    int result = conv_filter3x3Chain((unsigned char*)img->data[0], (unsigned char*)(*spare)->data[0],
+                                     img->stride, img->width, img->height, 3, stages, count, NULL);
+    if (result == 0) {
+        bmp24_swapPixels(img, *spare);
+    }
+    INSTRUMENT_END();
+    return result;
+}
+
+/**
+ * @brief Applique à une image 8 bits les opérations à partir de first
+ * @return 0 en cas de succès, -1 si une opération a échoué (les suivantes ne sont pas appliquées)
+ */
+static int pipeline_run8(const t_pipeline* pipeline, int first, t_bmp8* img) {
+    t_bmp8 spare = *img;
+    spare.data = NULL;
+
+    int result = 0;
+    for (int i = first; i < pipeline->count && result == 0; i++) {
+        const t_pipeOp* op = &pipeline->ops[i];
+        switch (op->type) {
+            case PIPE_LUT:        bmp8_applyLUT(img, &op->lut); break;
+            case PIPE_GRAYSCALE:  break; // Déjà en niveaux de gris
+            case PIPE_GRAY8:      break;
+            case PIPE_KERNEL:     result = pipeline_applyKernels8(pipeline, &i, img, &spare); break;
+            case PIPE_SEPARABLE:  result = bmp8_applySeparableFilter(img, op->separable); break;
+            case PIPE_BOX_RADIUS: result = bmp8_boxBlurRadius(img, op->radius); break;
+            case PIPE_MEDIAN:     result = bmp8_medianFilter(img, op->radius); break;
+            case PIPE_EQUALIZE:   result = bmp8_equalize(img); break;
+            case PIPE_CLAHE:
+                result = bmp8_clahe(img, CLAHE_DEFAULT_TILES, CLAHE_DEFAULT_TILES, op->clipLimit);
+                break;
+        }
+    }
+    free(spare.data);
+    return result;
+}
+
+/**
+ * @brief Applique toutes les opérations d'une chaîne à une image 8 bits
+ * @param pipeline Chaîne préparée
+ * @param img Image à transformer
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int pipeline_apply8(const t_pipeline* pipeline, t_bmp8* img) {
+    if (!pipeline || !img) return -1;
+
+    INSTRUMENT_BEGIN("pipeline_apply8");
+    int result = pipeline_run8(pipeline, 0, img);
+    INSTRUMENT_END();
+    return result;
+}
+
+/**
+ * @brief Applique à une image 24 bits les opérations à partir de first
+ * @param stopAtGray8 Non nul pour s'arrêter à la première conversion en 8 bits
+ * @return Indice de la conversion rencontrée, pipeline->count sinon, -1 si une opération a échoué
+ */
+static int pipeline_run24(const t_pipeline* pipeline, int first, t_bmp24* img, int stopAtGray8) {
+    t_bmp24* spare = NULL;
+
+    int result = 0;
+    int i = first;
+    for (; i < pipeline->count && result == 0; i++) {
+        const t_pipeOp* op = &pipeline->ops[i];
+        if (op->type == PIPE_GRAY8 && stopAtGray8) break;
+        switch (op->type) {
+            case PIPE_LUT:        bmp24_applyLUT(img, &op->lut); break;
+            case PIPE_GRAYSCALE:  bmp24_grayscale(img); break;
+            case PIPE_GRAY8:      break;
+            case PIPE_KERNEL:     result = pipeline_applyKernels24(pipeline, &i, img, &spare); break;
+            case PIPE_SEPARABLE:  result = bmp24_applySeparableFilter(img, op->separable); break;
+            case PIPE_BOX_RADIUS: result = bmp24_boxBlurRadius(img, op->radius); break;
+            case PIPE_MEDIAN:     result = bmp24_medianFilter(img, op->radius); break;
+            case PIPE_EQUALIZE:   result = bmp24_equalize(img); break;
+            case PIPE_CLAHE:
+                result = bmp24_clahe(img, CLAHE_DEFAULT_TILES, CLAHE_DEFAULT_TILES, op->clipLimit);
+                break;
+        }
+    }
+    bmp24_free(spare);
+    return result == 0 ? i : -1;
+}
+
+/**
+ * @brief Applique toutes les opérations d'une chaîne à une image 24 bits
+ *
+ * L'image reste en 24 bits : les conversions gray8 sont ignorées (voir
+ * pipeline_apply).
+ *
+ * @param pipeline Chaîne préparée
+ * @param img Image à transformer
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int pipeline_apply24(const t_pipeline* pipeline, t_bmp24* img) {
+    if (!pipeline || !img) return -1;
+
+    INSTRUMENT_BEGIN("pipeline_apply24");
+    int result = pipeline_run24(pipeline, 0, img, 0) < 0 ? -1 : 0;
+    INSTRUMENT_END();
+    return result;
+}
+
+/**
+ * @brief Applique une chaîne à l'image 8 ou 24 bits, conversion gray8 comprise (voir pipeline_apply)
+ * @return 0 en cas de succès, -1 si une opération ou la conversion a échoué
+ */
+static int pipeline_runAny(const t_pipeline* pipeline, t_bmp8** img8, t_bmp24** img24) {
+    if (*img8) {
+        return pipeline_run8(pipeline, 0, *img8);
+    }
+    if (!*img24) return -1;
+
+    int i = pipeline_run24(pipeline, 0, *img24, 1);
+    if (i < 0) return -1;
+    if (i == pipeline->count) return 0;
+
+    t_bmp8* gray = bmp24_toBmp8(*img24);
+    if (!gray) return -1;
+    bmp24_free(*img24);
+    *img24 = NULL;
+    *img8 = gray;
+    return pipeline_run8(pipeline, i + 1, gray);
+}
+
+/**
+ * @brief Applique une chaîne à l'image chargée, 8 ou 24 bits
+ *
+ * À la première opération gray8, l'image 24 bits est remplacée par sa
+ * luminance en 8 bits (*img24 est libérée et mise à NULL, *img8 reçoit la
+ * nouvelle image) et la suite de la chaîne est appliquée à celle-ci.
+ *
+ * @param pipeline Chaîne préparée
+ * @param img8 Image 8 bits, ou pointeur vers NULL
+ * @param img24 Image 24 bits, ou pointeur vers NULL
+ * @return 0 en cas de succès, -1 si une opération ou la conversion a échoué
+ */
+int pipeline_apply(const t_pipeline* pipeline, t_bmp8** img8, t_bmp24** img24) {
+    if (!pipeline || !img8 || !img24) return -1;
+
+    INSTRUMENT_BEGIN("pipeline_apply");
+    int result = pipeline_runAny(pipeline, img8, img24);
+    INSTRUMENT_END();
+    return result;
+}
+
+/**
+ * @brief Lit la profondeur de couleur d'un fichier BMP sans le charger
+ * @param filename Nom du fichier
+ * @return Profondeur en bits, -1 si le fichier n'est pas un BMP lisible
+ */
+int pipeline_readColorDepth(const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    if (!file) {
+        printf("Erreur: Impossible d'ouvrir le fichier %s\n", filename);
+        return -1;
+    }
+
+    unsigned char header[30];
+    size_t n = fread(header, 1, sizeof(header), file);
+    fclose(file);
+
+    if (n != sizeof(header) || header[0] != 'B' || header[1] != 'M') {
+        printf("Erreur: %s n'est pas un fichier BMP\n", filename);
+        return -1;
+    }
+    return header[28] | (header[29] << 8);
+}
+
+/**
+ * @brief Charge une image, lui applique la chaîne et la sauvegarde
+ * @param pipeline Chaîne préparée
+ * @param input Fichier source (8 ou 24 bits)
+ * @param output Fichier destination
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int pipeline_processFile(const t_pipeline* pipeline, const char* input, const char* output) {
+    INSTRUMENT_BEGIN("pipeline_processFile");
+
+    int result = -1;
+    int depth = pipeline_readColorDepth(input);
+    if (depth == 8) {
+        t_bmp8* img = bmp8_loadImage(input);
+        if (img) {
+            result = pipeline_apply8(pipeline, img);
+            if (result == 0) result = bmp8_saveImage(output, img);
+            bmp8_free(img);
+        }
+    } else if (depth == 24) {
+        t_bmp8* img8 = NULL;
+        t_bmp24* img24 = bmp24_loadImage(input);
+        if (img24) {
+            result = pipeline_apply(pipeline, &img8, &img24);
+        }
+        if (img8) {
+            if (result == 0 && bmp8_saveImage(output, img8) != 0) result = -1;
+            bmp8_free(img8);
+        }
+        if (img24) {
+            if (result == 0 && bmp24_saveImage(img24, output) != 0) result = -1;
+            bmp24_free(img24);
+        }
+    } else if (depth > 0) {
+        printf("Erreur: Profondeur de couleur non supportée (%d bits) pour %s\n", depth, input);
+    }
+
+    INSTRUMENT_END();
+    return result;
+}
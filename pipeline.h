@@ -0,0 +1,83 @@
+/**
+ * @file pipeline.h
+ * @author Projet TI202
+ * @brief Chaînes d'opérations décrites par une chaîne de caractères, pour le mode ligne de commande
+ * @date 2025
+ *
+ * Une chaîne telle que "gauss,sharpen,equalize" est analysée une seule
+ * fois : les noyaux sont construits à ce moment-là et les opérations
+ * ponctuelles consécutives sont fusionnées en une seule table (lut.h). La
+ * même chaîne est ensuite appliquée à autant d'images que nécessaire.
+ * Les noyaux 3x3 consécutifs, et les opérations ponctuelles qui les
+ * suivent, sont appliqués en un seul parcours de l'image
+ * (conv_filter3x3Chain).
+ *
+ * Opérations reconnues :
+ *     negative          négatif
+ *     brightness=N      luminosité (N de -255 à 255)
+ *     threshold=N       binarisation de seuil N (0 à 255, canal par canal en 24 bits)
+ *     grayscale         niveaux de gris (sans effet en 8 bits)
+ *     gray8             conversion en image 8 bits (luminance BT.601) : la
+ *                       suite de la chaîne traite un octet par pixel
+ *     blur              flou simple 3x3
+ *     blur=R            flou simple de rayon R (1 à CONV_BOX_MAX_RADIUS, sommes glissantes)
+ *     median=R          filtre médian de rayon R (1 à CONV_MEDIAN_MAX_RADIUS)
+ *     gauss             flou gaussien 3x3
+ *     gauss=S           flou gaussien séparable d'écart type S
+ *     sharpen           netteté
+ *     outline           contours
+ *     emboss            relief
+ *     equalize          égalisation d'histogramme
+ *     clahe             égalisation adaptative (tuiles 8x8, limite 2)
+ *     clahe=C           égalisation adaptative de limite de contraste C
+ */
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "bmp8.h"
+#include "bmp24.h"
+#include "filters.h"
+#include "lut.h"
+#include "clahe.h"
+
+// Types d'opérations d'une chaîne
+typedef enum {
+    PIPE_LUT,          // Opérations ponctuelles fusionnées
+    PIPE_GRAYSCALE,
+    PIPE_GRAY8,        // Conversion en 8 bits
+    PIPE_KERNEL,       // Noyau 3x3
+    PIPE_SEPARABLE,    // Noyau séparable
+    PIPE_BOX_RADIUS,   // Flou simple de rayon quelconque
+    PIPE_MEDIAN,       // Filtre médian de rayon quelconque
+    PIPE_EQUALIZE,
+    PIPE_CLAHE         // Égalisation adaptative
+} t_pipeOpType;
+
+// Une opération, avec ses paramètres préparés
+typedef struct {
+    t_pipeOpType type;
+    t_lut lut;                     // PIPE_LUT
+    float** kernel;                // PIPE_KERNEL
+    t_separableKernel* separable;  // PIPE_SEPARABLE
+    int radius;                    // PIPE_BOX_RADIUS, PIPE_MEDIAN
+    float clipLimit;               // PIPE_CLAHE
+} t_pipeOp;
+
+// Chaîne d'opérations
+typedef struct {
+    int count;
+    t_pipeOp* ops;
+} t_pipeline;
+
+t_pipeline* pipeline_parse(const char* spec);
+int pipeline_append(t_pipeline* pipeline, const char* spec);
+void pipeline_clear(t_pipeline* pipeline);
+void pipeline_free(t_pipeline* pipeline);
+int pipeline_apply8(const t_pipeline* pipeline, t_bmp8* img);
+int pipeline_apply24(const t_pipeline* pipeline, t_bmp24* img);
+int pipeline_apply(const t_pipeline* pipeline, t_bmp8** img8, t_bmp24** img24);
+int pipeline_readColorDepth(const char* filename);
+int pipeline_processFile(const t_pipeline* pipeline, const char* input, const char* output);
+
+#endif // PIPELINE_H
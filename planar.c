@@ -0,0 +1,551 @@
+/**
+ * @file planar.c
+ * @author Projet TI202
+ * @brief Images couleur en plans séparés : conversions et traitements plan par plan
+ * @date 2025
+ */
+
+#include "planar.h"
+#include "simd.h"
+#include "threadpool.h"
+#include "instrument.h"
+
+// Paramètres d'un traitement réparti en bandes entre les threads du pool
+typedef struct {
+    t_planar* img;
+    t_bmp24* rgb;              // Image entrelacée des conversions
+    const t_lut* lut;
+    unsigned int (*hist)[256]; // Un histogramme partiel par bande
+    const unsigned int* map;   // Table d'égalisation de la luminance
+} t_planarJob;
+
+/**
+ * @brief Alloue une image en plans séparés
+ *
+ * Les trois plans sont réservés en une seule allocation, chacun commençant
+ * sur une frontière de PLANAR_ALIGNMENT octets.
+ *
+ * @param width Largeur de l'image
+ * @param height Hauteur de l'image
+ * @return Image allouée (pixels non initialisés), NULL en cas d'erreur
+ */
+t_planar* planar_allocate(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        printf("Erreur: Dimensions invalides\n");
+        return NULL;
+    }
+
+    t_planar* img = (t_planar*)instrument_malloc(sizeof(t_planar));
+    if (!img) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        return NULL;
+    }
+
+    size_t planeSize = ((size_t)width * height + PLANAR_ALIGNMENT - 1) & ~(size_t)(PLANAR_ALIGNMENT - 1);
+    img->block = (unsigned char*)instrument_malloc(3 * planeSize + PLANAR_ALIGNMENT);
+    if (!img->block) {
+        printf("Erreur: Allocation mémoire échouée\n");
+        free(img);
+        return NULL;
+    }
+
+    uintptr_t start = ((uintptr_t)img->block + PLANAR_ALIGNMENT - 1) & ~(uintptr_t)(PLANAR_ALIGNMENT - 1);
+    for (int c = 0; c < 3; c++) {
+        img->planes[c] = (unsigned char*)start + c * planeSize;
+    }
+    img->width = width;
+    img->height = height;
+    return img;
+}
+
+/**
+ * @brief Libère une image en plans séparés
+ * @param img Image à libérer
+ */
+void planar_free(t_planar* img) {
+    if (img) {
+        free(img->block);
+        free(img);
+    }
+}
+
+/**
+ * @brief Échange les plans de deux images de mêmes dimensions, sans copie
+ * @param a Première image
+ * @param b Seconde image
+ */
+void planar_swapPlanes(t_planar* a, t_planar* b) {
+    if (!a || !b) return;
+    if (a->width != b->width || a->height != b->height) {
+        printf("Erreur: Dimensions incompatibles\n");
+        return;
+    }
+
+    t_planar tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+/**
+ * @brief Présente un plan comme une image 8 bits, sans copier les pixels
+ *
+ * plane->data pointe dans img : plane ne doit pas être passé à bmp8_free.
+ * L'en-tête déclare des lignes de haut en bas et une palette de gris, si
+ * bien que bmp8_saveImage écrit le plan dans le bon sens.
+ *
+ * @param img Image en plans séparés
+ * @param channel Plan (LUT_RED, LUT_GREEN ou LUT_BLUE)
+ * @param plane Image à remplir
+ */
+void planar_planeAsBmp8(t_planar* img, int channel, t_bmp8* plane) {
+    memset(plane->header, 0, sizeof(plane->header));
+    *(uint16_t*)&plane->header[0] = BMP_TYPE;
+    *(uint32_t*)&plane->header[10] = 54 + 1024;
+    *(uint32_t*)&plane->header[14] = INFO_SIZE;
+    *(int32_t*)&plane->header[18] = img->width;
+    *(int32_t*)&plane->header[22] = -img->height;
+    *(uint16_t*)&plane->header[26] = 1;
+    *(uint16_t*)&plane->header[28] = 8;
+    for (int i = 0; i < 256; i++) {
+        plane->colorTable[i * 4] = (unsigned char)i;
+        plane->colorTable[i * 4 + 1] = (unsigned char)i;
+        plane->colorTable[i * 4 + 2] = (unsigned char)i;
+        plane->colorTable[i * 4 + 3] = 0;
+    }
+
+    plane->data = img->planes[channel];
+    plane->width = img->width;
+    plane->height = img->height;
+    plane->colorDepth = 8;
+    plane->dataSize = plane->width * plane->height;
+}
+
+#if SIMD_X86
+/**
+ * @brief Sépare 16 pixels RGB à la fois (48 octets vers 3 x 16 octets)
+ * @return Nombre de pixels traités
+ */
+SIMD_TARGET("ssse3")
+static int deinterleaveRow_ssse3(const unsigned char* rgb, unsigned char* r, unsigned char* g,
+                                 unsigned char* b, int width) {
+    const __m128i r0 = _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i r1 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1);
+    const __m128i r2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13);
+    const __m128i g0 = _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i g1 = _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1);
+    const __m128i g2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14);
+    const __m128i b0 = _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i b1 = _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1);
+    const __m128i b2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15);
+
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const unsigned char* p = rgb + x * 3;
+        __m128i v0 = _mm_loadu_si128((const __m128i*)p);
+        __m128i v1 = _mm_loadu_si128((const __m128i*)(p + 16));
+        __m128i v2 = _mm_loadu_si128((const __m128i*)(p + 32));
+        _mm_storeu_si128((__m128i*)(r + x), _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(v0, r0),
+                         _mm_shuffle_epi8(v1, r1)), _mm_shuffle_epi8(v2, r2)));
+        _mm_storeu_si128((__m128i*)(g + x), _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(v0, g0),
+                         _mm_shuffle_epi8(v1, g1)), _mm_shuffle_epi8(v2, g2)));
+        _mm_storeu_si128((__m128i*)(b + x), _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(v0, b0),
+                         _mm_shuffle_epi8(v1, b1)), _mm_shuffle_epi8(v2, b2)));
+    }
+    return x;
+}
+
+/**
+ * @brief Entrelace 16 pixels à la fois (3 x 16 octets vers 48 octets RGB)
+ * @return Nombre de pixels traités
+ */
+SIMD_TARGET("ssse3")
+static int interleaveRow_ssse3(const unsigned char* r, const unsigned char* g, const unsigned char* b,
+                               unsigned char* rgb, int width) {
+    const __m128i r0 = _mm_setr_epi8(0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5);
+    const __m128i g0 = _mm_setr_epi8(-1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1);
+    const __m128i b0 = _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1);
+    const __m128i r1 = _mm_setr_epi8(-1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1);
+    const __m128i g1 = _mm_setr_epi8(5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10);
+    const __m128i b1 = _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1);
+    const __m128i r2 = _mm_setr_epi8(-1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1);
+    const __m128i g2 = _mm_setr_epi8(-1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1);
+    const __m128i b2 = _mm_setr_epi8(10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15);
+
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        unsigned char* p = rgb + x * 3;
+        __m128i vr = _mm_loadu_si128((const __m128i*)(r + x));
+        __m128i vg = _mm_loadu_si128((const __m128i*)(g + x));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + x));
+        _mm_storeu_si128((__m128i*)p, _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(vr, r0),
+                         _mm_shuffle_epi8(vg, g0)), _mm_shuffle_epi8(vb, b0)));
+        _mm_storeu_si128((__m128i*)(p + 16), _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(vr, r1),
+                         _mm_shuffle_epi8(vg, g1)), _mm_shuffle_epi8(vb, b1)));
+        _mm_storeu_si128((__m128i*)(p + 32), _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(vr, r2),
+                         _mm_shuffle_epi8(vg, g2)), _mm_shuffle_epi8(vb, b2)));
+    }
+    return x;
+}
+#endif
+
+/**
+ * @brief Sépare les canaux des lignes [start, end)
+ */
+static void deinterleaveBand(int start, int end, int band, void* arg) {
+    t_planarJob* job = (t_planarJob*)arg;
+    t_planar* img = job->img;
+    int useSimd = simd_level() >= SIMD_LEVEL_SSSE3;
+    (void)band;
+
+    for (int y = start; y < end; y++) {
+        const unsigned char* rgb = (const unsigned char*)job->rgb->data[y];
+        size_t offset = (size_t)y * img->width;
+        unsigned char* r = img->planes[LUT_RED] + offset;
+        unsigned char* g = img->planes[LUT_GREEN] + offset;
+        unsigned char* b = img->planes[LUT_BLUE] + offset;
+        int x = 0;
+#if SIMD_X86
+        if (useSimd) x = deinterleaveRow_ssse3(rgb, r, g, b, img->width);
+#else
+        (void)useSimd;
+#endif
+        for (; x < img->width; x++) {
+            r[x] = rgb[x * 3];
+            g[x] = rgb[x * 3 + 1];
+            b[x] = rgb[x * 3 + 2];
+        }
+    }
+}
+
+/**
+ * @brief Entrelace les canaux des lignes [start, end)
+ */
+static void interleaveBand(int start, int end, int band, void* arg) {
+    t_planarJob* job = (t_planarJob*)arg;
+    t_planar* img = job->img;
+    int useSimd = simd_level() >= SIMD_LEVEL_SSSE3;
+    (void)band;
+
+    for (int y = start; y < end; y++) {
+        unsigned char* rgb = (unsigned char*)job->rgb->data[y];
+        size_t offset = (size_t)y * img->width;
+        const unsigned char* r = img->planes[LUT_RED] + offset;
+        const unsigned char* g = img->planes[LUT_GREEN] + offset;
+        const unsigned char* b = img->planes[LUT_BLUE] + offset;
+        int x = 0;
+#if SIMD_X86
+        if (useSimd) x = interleaveRow_ssse3(r, g, b, rgb, img->width);
+#else
+        (void)useSimd;
+#endif
+        for (; x < img->width; x++) {
+            rgb[x * 3] = r[x];
+            rgb[x * 3 + 1] = g[x];
+            rgb[x * 3 + 2] = b[x];
+        }
+    }
+}
+
+/**
+ * @brief Sépare les canaux d'une image 24 bits dans une image en plans de mêmes dimensions
+ * @param src Image entrelacée
+ * @param dst Image en plans séparés
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int planar_deinterleave(t_bmp24* src, t_planar* dst) {
+    if (!src || !src->data || !dst) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+    if (src->width != dst->width || src->height != dst->height) {
+        printf("Erreur: Dimensions incompatibles\n");
+        return -1;
+    }
+
+    INSTRUMENT_BEGIN("planar_deinterleave");
+
+    t_planarJob job = {.img = dst, .rgb = src};
+    threadpool_run(dst->height, dst->width, deinterleaveBand, &job);
+    INSTRUMENT_END();
+    return 0;
+}
+
+/**
+ * @brief Entrelace les plans dans une image 24 bits de mêmes dimensions
+ * @param src Image en plans séparés
+ * @param dst Image entrelacée
+ * @return 0 en cas de succès, -1 en cas d'erreur
+ */
+int planar_interleave(t_planar* src, t_bmp24* dst) {
+    if (!src || !dst || !dst->data) {
+        printf("Erreur: Paramètres invalides\n");
+        return -1;
+    }
+    if (src->width != dst->width || src->height != dst->height) {
+        printf("Erreur: Dimensions incompatibles\n");
+        return -1;
+    }
+
+    INSTRUMENT_BEGIN("planar_interleave");
+
+    t_planarJob job = {.img = src, .rgb = dst};
+    threadpool_run(src->height, src->width, interleaveBand, &job);
+    INSTRUMENT_END();
+    return 0;
+}
+
+/**
+ * @brief Crée une image en plans séparés à partir d'une image 24 bits
+ * @param img Image entrelacée
+ * @return Nouvelle image (à libérer avec planar_free), NULL en cas d'erreur
+ */
+t_planar* planar_fromBmp24(t_bmp24* img) {
+    if (!img || !img->data) {
+        printf("Erreur: Image invalide\n");
+        return NULL;
+    }
+
+    t_planar* planar = planar_allocate(img->width, img->height);
+    if (!planar) return NULL;
+    planar_deinterleave(img, planar);
+    return planar;
+}
+
+/**
+ * @brief Applique la table de chaque canal à son plan, lignes [start, end)
+ */
+static void applyLUTBand(int start, int end, int band, void* arg) {
+    t_planarJob* job = (t_planarJob*)arg;
+    t_planar* img = job->img;
+    (void)band;
+
+    size_t offset = (size_t)start * img->width;
+    size_t count = (size_t)(end - start) * img->width;
+    for (int c = 0; c < 3; c++) {
+        lut_applyBytes(job->lut->table[c], img->planes[c] + offset, count);
+    }
+}
+
+/**
+ * @brief Applique une chaîne d'opérations ponctuelles, une table par plan
+ *
+ * Chaque plan est un tableau d'octets contigu : même avec trois tables
+ * différentes, l'application est celle, vectorisée, des images 8 bits.
+ *
+ * @param img Image en plans séparés
+ * @param lut Tables à appliquer (une par canal)
+ */
+void planar_applyLUT(t_planar* img, const t_lut* lut) {
+    if (!img || !lut) {
+        printf("Erreur: Paramètres invalides\n");
+        return;
+    }
+
+    INSTRUMENT_BEGIN("planar_applyLUT");
+
+    t_planarJob job = {.img = img, .lut = lut};
+    threadpool_run(img->height, img->width * 3, applyLUTBand, &job);
+    INSTRUMENT_END();
+}
+
+/**
+ * @brief Applique un effet négatif
+ * @param img Image en plans séparés
+ */
+void planar_negative(t_planar* img) {
+    t_lut lut;
+    lut_identity(&lut);
+    lut_negative(&lut, LUT_ALL);
+    planar_applyLUT(img, &lut);
+}
+
+/**
+ * @brief Ajuste la luminosité
+ * @param img Image en plans séparés
+ * @param value Valeur d'ajustement
+ */
+void planar_brightness(t_planar* img, int value) {
+    t_lut lut;
+    lut_identity(&lut);
+    lut_brightness(&lut, LUT_ALL, value);
+    planar_applyLUT(img, &lut);
+}
+
+/**
+ * @brief Applique un filtre de convolution de src vers dst, plan par plan
+ *
+ * Tous les pixels de dst sont écrits (la bordure est recopiée de src),
+ * comme avec bmp8_applyFilterTo.
+ *
+ * @param src Image source
+ * @param dst Image destination, distincte de src et de mêmes dimensions
+ * @param kernel Noyau de convolution
+ * @param kernelSize Taille du noyau (doit être impaire)
+ */
+void planar_applyFilterTo(t_planar* src, t_planar* dst, float** kernel, int kernelSize) {
+    if (!src || !dst || !kernel || src == dst) {
+        printf("Erreur: Paramètres invalides\n");
+        return;
+    }
+    if (dst->width != src->width || dst->height != src->height) {
+        printf("Erreur: Dimensions incompatibles\n");
+        return;
+    }
+
+    INSTRUMENT_BEGIN("planar_applyFilterTo");
+
+    t_bmp8 in, out;
+    for (int c = 0; c < 3; c++) {
+        planar_planeAsBmp8(src, c, &in);
+        planar_planeAsBmp8(dst, c, &out);
+        bmp8_applyFilterTo(&in, &out, kernel, kernelSize);
+    }
+    INSTRUMENT_END();
+}
+
+/**
+ * @brief Applique un filtre de convolution sur toute l'image
+ *
+ * Le résultat est calculé dans une image temporaire dont les plans sont
+ * ensuite échangés avec ceux de img, sans recopie.
+ *
+ * @param img Image en plans séparés
+ * @param kernel Noyau de convolution
+ * @param kernelSize Taille du noyau (doit être impaire)
+ */
+void planar_applyFilter(t_planar* img, float** kernel, int kernelSize) {
+    if (!img || !kernel) {
+        printf("Erreur: Paramètres invalides\n");
+        return;
+    }
+
+    t_planar* temp = planar_allocate(img->width, img->height);
+    if (!temp) return;
+
+    planar_applyFilterTo(img, temp, kernel, kernelSize);
+    planar_swapPlanes(img, temp);
+    planar_free(temp);
+}
+
+/**
+ * @brief Applique un noyau séparable, plan par plan
+ * @param img Image en plans séparés
+ * @param kernel Noyau séparable
+ */
+void planar_applySeparableFilter(t_planar* img, const t_separableKernel* kernel) {
+    if (!img || !kernel) {
+        printf("Erreur: Paramètres invalides\n");
+        return;
+    }
+
+    t_bmp8 plane;
+    for (int c = 0; c < 3; c++) {
+        planar_planeAsBmp8(img, c, &plane);
+        bmp8_applySeparableFilter(&plane, kernel);
+    }
+}
+
+/**
+ * @brief Flou simple de rayon quelconque, plan par plan
+ * @param img Image en plans séparés
+ * @param radius Rayon du flou
+ */
+void planar_boxBlurRadius(t_planar* img, int radius) {
+    if (!img) {
+        printf("Erreur: Image invalide\n");
+        return;
+    }
+
+    t_bmp8 plane;
+    for (int c = 0; c < 3; c++) {
+        planar_planeAsBmp8(img, c, &plane);
+        bmp8_boxBlurRadius(&plane, radius);
+    }
+}
+
+/**
+ * @brief Filtre médian, plan par plan
+ * @param img Image en plans séparés
+ * @param radius Rayon de la fenêtre
+ */
+void planar_medianFilter(t_planar* img, int radius) {
+    if (!img) {
+        printf("Erreur: Image invalide\n");
+        return;
+    }
+
+    t_bmp8 plane;
+    for (int c = 0; c < 3; c++) {
+        planar_planeAsBmp8(img, c, &plane);
+        bmp8_medianFilter(&plane, radius);
+    }
+}
+
+/**
+ * @brief Histogramme partiel de luminance des lignes [start, end), dans job->hist[band]
+ */
+static void lumaHistogramBand(int start, int end, int band, void* arg) {
+    t_planarJob* job = (t_planarJob*)arg;
+    t_planar* img = job->img;
+    unsigned int* hist = job->hist[band];
+
+    size_t first = (size_t)start * img->width;
+    size_t last = (size_t)end * img->width;
+    const unsigned char* r = img->planes[LUT_RED];
+    const unsigned char* g = img->planes[LUT_GREEN];
+    const unsigned char* b = img->planes[LUT_BLUE];
+    for (size_t i = first; i < last; i++) {
+        hist[bmp24_lumaIndex(r[i], g[i], b[i])]++;
+    }
+}
+
+/**
+ * @brief Égalisation des lignes [start, end) via job->map (voir bmp24_equalizePixel)
+ */
+static void equalizeBand(int start, int end, int band, void* arg) {
+    t_planarJob* job = (t_planarJob*)arg;
+    t_planar* img = job->img;
+    (void)band;
+
+    size_t first = (size_t)start * img->width;
+    size_t last = (size_t)end * img->width;
+    unsigned char* r = img->planes[LUT_RED];
+    unsigned char* g = img->planes[LUT_GREEN];
+    unsigned char* b = img->planes[LUT_BLUE];
+    for (size_t i = first; i < last; i++) {
+        bmp24_equalizePixel(&r[i], &g[i], &b[i], job->map);
+    }
+}
+
+/**
+ * @brief Égalisation d'histogramme de la luminance, identique à bmp24_equalize
+ * @param img Image en plans séparés
+ */
+void planar_equalize(t_planar* img) {
+    if (!img) {
+        printf("Erreur: Image invalide\n");
+        return;
+    }
+
+    INSTRUMENT_BEGIN("planar_equalize");
+
+    unsigned int partial[THREADPOOL_MAX_THREADS][256];
+    memset(partial, 0, sizeof(partial));
+
+    t_planarJob job = {.img = img, .hist = partial};
+    int bands = threadpool_run(img->height, img->width, lumaHistogramBand, &job);
+
+    unsigned int hist[256] = {0};
+    for (int b = 0; b < bands; b++) {
+        for (int i = 0; i < 256; i++) {
+            hist[i] += partial[b][i];
+        }
+    }
+
+    unsigned int map[256];
+    bmp24_computeEqualizationMap(hist, img->width * img->height, map);
+
+    job.map = map;
+    threadpool_run(img->height, img->width, equalizeBand, &job);
+    INSTRUMENT_END();
+}
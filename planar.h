@@ -0,0 +1,60 @@
+/**
+ * @file planar.h
+ * @author Projet TI202
+ * @brief Images couleur en plans séparés (R, G, B) pour les traitements vectorisés
+ * @date 2025
+ *
+ * Dans un t_bmp24, les canaux sont entrelacés (RGBRGB...) : les noyaux
+ * vectorisés doivent soit réordonner les octets, soit traiter des voisins
+ * distants de 3 octets. Un t_planar range chaque canal dans son propre
+ * plan de width * height octets, aligné sur PLANAR_ALIGNMENT, lignes de
+ * haut en bas comme dans t_bmp24. Chaque plan se présente comme une image
+ * 8 bits (planar_planeAsBmp8) : les traitements ci-dessous réutilisent
+ * directement les fonctions de bmp8.h, plan par plan.
+ *
+ * Une chaîne de plusieurs traitements couleur sépare les canaux une fois
+ * (planar_fromBmp24), les traite en plans puis les réentrelace
+ * (planar_interleave). Les résultats sont identiques à ceux des fonctions
+ * bmp24_* correspondantes.
+ */
+
+#ifndef PLANAR_H
+#define PLANAR_H
+
+#include "bmp8.h"
+#include "bmp24.h"
+#include "filters.h"
+#include "lut.h"
+
+// Alignement (en octets) du début de chaque plan
+#define PLANAR_ALIGNMENT 64
+
+// Image couleur en plans séparés
+typedef struct {
+    unsigned char* planes[3];  // Plans R, G et B (indices LUT_RED, LUT_GREEN, LUT_BLUE)
+    int width;
+    int height;
+    unsigned char* block;      // Allocation commune aux trois plans
+} t_planar;
+
+// Allocation et conversions
+t_planar* planar_allocate(int width, int height);
+void planar_free(t_planar* img);
+void planar_swapPlanes(t_planar* a, t_planar* b);
+void planar_planeAsBmp8(t_planar* img, int channel, t_bmp8* plane);
+t_planar* planar_fromBmp24(t_bmp24* img);
+int planar_deinterleave(t_bmp24* src, t_planar* dst);
+int planar_interleave(t_planar* src, t_bmp24* dst);
+
+// Traitements, plan par plan
+void planar_applyLUT(t_planar* img, const t_lut* lut);
+void planar_negative(t_planar* img);
+void planar_brightness(t_planar* img, int value);
+void planar_applyFilterTo(t_planar* src, t_planar* dst, float** kernel, int kernelSize);
+void planar_applyFilter(t_planar* img, float** kernel, int kernelSize);
+void planar_applySeparableFilter(t_planar* img, const t_separableKernel* kernel);
+void planar_boxBlurRadius(t_planar* img, int radius);
+void planar_medianFilter(t_planar* img, int radius);
+void planar_equalize(t_planar* img);
+
+#endif // PLANAR_H
@@ -0,0 +1,70 @@
+/**
+ * @file simd.c
+ * @author Projet TI202
+ * @brief Choix du jeu d'instructions SIMD, une fois pour tout le programme
+ * @date 2025
+ */
+
+#ifndef _WIN32
+    #define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "simd.h"
+#include <stdlib.h>
+
+#ifndef _WIN32
+    #include <pthread.h>
+static pthread_once_t once = PTHREAD_ONCE_INIT;
+#endif
+
+static int level = SIMD_LEVEL_NONE;
+static volatile int maxLevel = SIMD_LEVEL_AVX2;
+
+/**
+ * @brief Détecte le processeur et lit BMP_NO_SIMD
+ */
+static void simd_init(void) {
+    if (getenv("BMP_NO_SIMD")) {
+        level = SIMD_LEVEL_NONE;
+    } else if (simd_hasAVX2()) {
+        level = SIMD_LEVEL_AVX2;
+    } else if (simd_hasSSSE3()) {
+        level = SIMD_LEVEL_SSSE3;
+    } else if (simd_hasSSE2()) {
+        level = SIMD_LEVEL_SSE2;
+    }
+}
+
+/**
+ * @brief Jeu d'instructions à utiliser par les versions vectorisées
+ *
+ * La détection n'a lieu qu'au premier appel ; les appels suivants, depuis
+ * n'importe quel thread, ne font que lire le résultat.
+ *
+ * @return SIMD_LEVEL_NONE, SIMD_LEVEL_SSE2, SIMD_LEVEL_SSSE3 ou SIMD_LEVEL_AVX2
+ */
+int simd_level(void) {
+#ifndef _WIN32
+    pthread_once(&once, simd_init);
+#else
+    static int initialized = 0;
+    if (!initialized) {
+        initialized = 1;
+        simd_init();
+    }
+#endif
+    return level < maxLevel ? level : maxLevel;
+}
+
+/**
+ * @brief Limite le jeu d'instructions renvoyé par simd_level
+ *
+ * Réservé aux tests : SIMD_LEVEL_NONE force les versions scalaires,
+ * SIMD_LEVEL_AVX2 rend le niveau détecté. À n'appeler que lorsqu'aucun
+ * traitement n'est en cours.
+ *
+ * @param max Niveau maximal (SIMD_LEVEL_NONE à SIMD_LEVEL_AVX2)
+ */
+void simd_setMaxLevel(int max) {
+    maxLevel = max;
+}
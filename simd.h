@@ -0,0 +1,47 @@
+/**
+ * @file simd.h
+ * @author Projet TI202
+ * @brief Détection des jeux d'instructions SIMD disponibles à l'exécution
+ * @date 2025
+ *
+ * Les chemins vectorisés sont compilés avec les attributs target de GCC/Clang
+ * et choisis à l'exécution : le programme reste compilable avec les options
+ * par défaut et fonctionne sur toute machine grâce aux versions scalaires.
+ *
+ * simd_level() donne le jeu d'instructions à utiliser. Il est déterminé
+ * une seule fois, au premier appel : la variable d'environnement
+ * BMP_NO_SIMD force alors les versions scalaires. simd_setMaxLevel le
+ * limite ensuite (tests des versions scalaires contre les versions
+ * vectorisées).
+ */
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define SIMD_X86 1
+    #include <immintrin.h>
+    #define SIMD_TARGET(isa) __attribute__((target(isa)))
+
+    static inline int simd_hasSSE2(void) { return __builtin_cpu_supports("sse2"); }
+    static inline int simd_hasSSSE3(void) { return __builtin_cpu_supports("ssse3"); }
+    static inline int simd_hasAVX2(void) { return __builtin_cpu_supports("avx2"); }
+#else
+    #define SIMD_X86 0
+    #define SIMD_TARGET(isa)
+
+    static inline int simd_hasSSE2(void) { return 0; }
+    static inline int simd_hasSSSE3(void) { return 0; }
+    static inline int simd_hasAVX2(void) { return 0; }
+#endif
+
+// Niveaux renvoyés par simd_level, chacun incluant les précédents
+#define SIMD_LEVEL_NONE  0
+#define SIMD_LEVEL_SSE2  1
+#define SIMD_LEVEL_SSSE3 2
+#define SIMD_LEVEL_AVX2  3
+
+int simd_level(void);
+void simd_setMaxLevel(int max);
+
+#endif // SIMD_H
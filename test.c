@@ -13,6 +13,16 @@
 #include "bmp8.h"
 #include "bmp24.h"
 #include "filters.h"
+#include "bmpview.h"
+#include "bmpstream.h"
+#include "threadpool.h"
+#include "pipeline.h"
+#include "batch.h"
+#include "instrument.h"
+#include "context.h"
+#include "planar.h"
+#include "lazy.h"
+#include "simd.h"
 
 // Pour la création de dossiers
 #ifdef _WIN32
@@ -20,6 +30,9 @@
     #define mkdir(dir, mode) _mkdir(dir)
 #endif
 
+// Nombre de tests dont la vérification a échoué
+static int testFailures = 0;
+
 /**
  * @brief Crée un dossier s'il n'existe pas
  * @param path Chemin du dossier
@@ -32,6 +45,149 @@ void createDirectory(const char* path) {
     }
 }
 
+/**
+ * @brief Copie une image 8 bits (en-tête, palette et pixels)
+ * @param src Image à copier
+ * @return Nouvelle image, à libérer avec bmp8_free
+ */
+static t_bmp8* copyBmp8(const t_bmp8* src) {
+    t_bmp8* copy = (t_bmp8*)malloc(sizeof(t_bmp8));
+    *copy = *src;
+    copy->data = (unsigned char*)malloc(src->dataSize);
+    memcpy(copy->data, src->data, src->dataSize);
+    return copy;
+}
+
+/**
+ * @brief Copie une image 24 bits (en-têtes et pixels)
+ * @param src Image à copier
+ * @return Nouvelle image, à libérer avec bmp24_free
+ */
+static t_bmp24* copyBmp24(t_bmp24* src) {
+    t_bmp24* copy = bmp24_allocate(src->width, src->height, src->colorDepth);
+    copy->header = src->header;
+    copy->header_info = src->header_info;
+    bmp24_copyPixels(copy, src);
+    return copy;
+}
+
+/**
+ * @brief Recadre une image 8 bits sur ses width x height premiers pixels
+ * @return Nouvelle image, à libérer avec bmp8_free
+ */
+static t_bmp8* cropBmp8(const t_bmp8* src, unsigned int width, unsigned int height) {
+    t_bmp8* crop = (t_bmp8*)malloc(sizeof(t_bmp8));
+    *crop = *src;
+    crop->width = width;
+    crop->height = height;
+    crop->dataSize = width * height;
+    crop->data = (unsigned char*)malloc(crop->dataSize);
+    for (unsigned int y = 0; y < height; y++) {
+        memcpy(crop->data + y * width, src->data + y * src->width, width);
+    }
+    return crop;
+}
+
+/**
+ * @brief Recadre une image 24 bits sur ses width x height premiers pixels
+ * @return Nouvelle image, à libérer avec bmp24_free
+ */
+static t_bmp24* cropBmp24(t_bmp24* src, int width, int height) {
+    t_bmp24* crop = bmp24_allocate(width, height, src->colorDepth);
+    crop->header = src->header;
+    crop->header_info = src->header_info;
+    for (int y = 0; y < height; y++) {
+        memcpy(crop->data[y], src->data[y], (size_t)width * sizeof(t_pixel));
+    }
+    return crop;
+}
+
+// Dimensions des recadrages des tests de suites de filtres : largeurs impaires, hauteurs < 3
+static const int chainSizes[][2] = {{301, 203}, {97, 2}, {64, 1}, {1, 5}, {2, 2}, {3, 3}};
+#define CHAIN_SIZE_COUNT ((int)(sizeof(chainSizes) / sizeof(chainSizes[0])))
+
+// Nombre de noyaux de la suite la plus longue, au-delà de CONV_CHAIN_MAX_STAGES
+#define CHAIN_TEST_STAGES 19
+
+/**
+ * @brief Compare les dimensions et les pixels de deux images 8 bits
+ * @return 1 si elles sont identiques, 0 sinon
+ */
+static int sameBmp8(const t_bmp8* a, const t_bmp8* b) {
+    return a && b && a->width == b->width && a->height == b->height &&
+           memcmp(a->data, b->data, (size_t)a->width * a->height) == 0;
+}
+
+/**
+ * @brief Compare les dimensions et les pixels de deux images 24 bits (padding exclu)
+ * @return 1 si elles sont identiques, 0 sinon
+ */
+static int sameBmp24(t_bmp24* a, t_bmp24* b) {
+    if (!a || !b || a->width != b->width || a->height != b->height) return 0;
+    for (int y = 0; y < a->height; y++) {
+        if (memcmp(a->data[y], b->data[y], (size_t)a->width * sizeof(t_pixel)) != 0) return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief Applique une chaîne (ou un noyau 3x3) sur 1 thread puis sur threads threads
+ * @param src Image source (non modifiée)
+ * @param spec Chaîne d'opérations (voir pipeline.h), ignorée si kernel n'est pas NULL
+ * @param kernel Noyau 3x3 appliqué par bmp8_applyFilter, ou NULL
+ * @param threads Nombre de threads du second passage
+ * @return 1 si les deux résultats sont identiques, 0 sinon
+ */
+static int sameOnThreads8(const t_bmp8* src, const char* spec, float** kernel, int threads) {
+    t_pipeline* pipeline = kernel ? NULL : pipeline_parse(spec);
+    t_bmp8* results[2];
+    for (int i = 0; i < 2; i++) {
+        results[i] = copyBmp8(src);
+        threadpool_setThreadCount(i == 0 ? 1 : threads);
+        if (kernel) {
+            bmp8_applyFilter(results[i], kernel, 3);
+        } else {
+            pipeline_apply8(pipeline, results[i]);
+        }
+    }
+    threadpool_setThreadCount(0);
+    int same = sameBmp8(results[0], results[1]);
+    bmp8_free(results[0]);
+    bmp8_free(results[1]);
+    pipeline_free(pipeline);
+    return same;
+}
+
+/**
+ * @brief Équivalent 24 bits de sameOnThreads8 (noyau appliqué par bmp24_applyFilter)
+ */
+static int sameOnThreads24(t_bmp24* src, const char* spec, float** kernel, int threads) {
+    t_pipeline* pipeline = kernel ? NULL : pipeline_parse(spec);
+    t_bmp24* results[2];
+    for (int i = 0; i < 2; i++) {
+        results[i] = copyBmp24(src);
+        threadpool_setThreadCount(i == 0 ? 1 : threads);
+        if (kernel) {
+            bmp24_applyFilter(results[i], kernel, 3);
+        } else {
+            pipeline_apply24(pipeline, results[i]);
+        }
+    }
+    threadpool_setThreadCount(0);
+    int same = sameBmp24(results[0], results[1]);
+    bmp24_free(results[0]);
+    bmp24_free(results[1]);
+    pipeline_free(pipeline);
+    return same;
+}
+
+// Chaînes comparées sur 1 et plusieurs threads (Test 18) : filtres, tables, égalisations
+static const char* threadSpecs[] = {
+    "gauss,sharpen,outline", "emboss", "blur=5", "gauss=2", "median=2",
+    "brightness=40,negative", "threshold=100", "equalize", "clahe", "grayscale"
+};
+#define THREAD_SPEC_COUNT ((int)(sizeof(threadSpecs) / sizeof(threadSpecs[0])))
+
 /**
  * @brief Teste toutes les fonctionnalités pour les images 8 bits
  * @param inputFile Fichier d'entrée
@@ -192,10 +348,413 @@ void testBmp8Functions(const char* inputFile, const char* outputDir) {
         printf("OK\n");
     }
 
+    // Test 12 : Négatif sur une projection mémoire copy-on-write
+    {
+        printf("Test 12 : Négatif sur projection mmap... ");
+        t_bmp_view* view = bmp_viewOpen(inputFile, BMP_VIEW_PRIVATE);
+        t_bmp8 img;
+        if (view && bmp_viewAsBmp8(view, &img) == 0) {
+            bmp8_negative(&img);
+            char outputPath[256];
+            snprintf(outputPath, sizeof(outputPath), "%s/12_negatif_mmap.bmp", outputDir);
+            bmp8_saveImage(outputPath, &img);
+        }
+        bmp_viewClose(view);
+        printf("OK\n");
+    }
+
+    // Test 13 : Relief et égalisation en flux, par bandes de 16 lignes
+    {
+        printf("Test 13 : Relief et égalisation en flux... ");
+        float** kernel = createEmbossKernel();
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/13_relief_flux.bmp", outputDir);
+        bmp_streamFilter(inputFile, outputPath, kernel, 3, 16);
+        snprintf(outputPath, sizeof(outputPath), "%s/13_egalisation_flux.bmp", outputDir);
+        bmp_streamEqualize(inputFile, outputPath, 16);
+
+        // Copie de haut en bas de l'image source (lignes inversées en mémoire, voir bmp8.h)
+        char topDownPath[256];
+        snprintf(topDownPath, sizeof(topDownPath), "%s/13_haut_en_bas.bmp", outputDir);
+        t_bmp8* topDown = bmp8_loadImage(inputFile);
+        unsigned int width = topDown->width;
+        for (unsigned int y = 0; y < topDown->height / 2; y++) {
+            unsigned char* top = topDown->data + y * width;
+            unsigned char* bottom = topDown->data + (topDown->height - 1 - y) * width;
+            for (unsigned int x = 0; x < width; x++) {
+                unsigned char t = top[x];
+                top[x] = bottom[x];
+                bottom[x] = t;
+            }
+        }
+        *(int32_t*)&topDown->header[22] = -(int32_t)topDown->height;
+        bmp8_saveImage(topDownPath, topDown);
+        bmp8_free(topDown);
+
+        // Le relief en flux doit donner le même résultat que sur l'image chargée,
+        // que le fichier soit de bas en haut ou de haut en bas
+        const char* sources[2] = {inputFile, topDownPath};
+        int same = 1;
+        for (int i = 0; i < 2 && same; i++) {
+            snprintf(outputPath, sizeof(outputPath), "%s/13_relief_flux_%d.bmp", outputDir, i);
+            bmp_streamFilter(sources[i], outputPath, kernel, 3, 16);
+            t_bmp8* streamed = bmp8_loadImage(outputPath);
+            t_bmp8* expected = bmp8_loadImage(sources[i]);
+            bmp8_applyFilter(expected, kernel, 3);
+            same = streamed && expected && streamed->dataSize == expected->dataSize &&
+                   memcmp(streamed->data, expected->data, expected->dataSize) == 0;
+            bmp8_free(streamed);
+            bmp8_free(expected);
+        }
+        freeFilterKernel(kernel, 3);
+        if (!same) {
+            printf("ÉCHEC (relief en flux différent de bmp8_applyFilter)\n");
+            testFailures++;
+        } else {
+            printf("OK\n");
+        }
+    }
+
+    // Test 14 : Flou gaussien séparable de grand rayon
+    {
+        printf("Test 14 : Flou gaussien séparable (sigma 4)... ");
+        t_bmp8* img = bmp8_loadImage(inputFile);
+        t_separableKernel* kernel = createSeparableGaussianKernel(4.0f);
+        bmp8_applySeparableFilter(img, kernel);
+        freeSeparableKernel(kernel);
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/14_flou_gaussien_sigma4.bmp", outputDir);
+        bmp8_saveImage(outputPath, img);
+        bmp8_free(img);
+        printf("OK\n");
+    }
+
+    // Test 15 : Flou simple de rayon 25 par sommes glissantes
+    {
+        printf("Test 15 : Flou simple rayon 25... ");
+        t_bmp8* img = bmp8_loadImage(inputFile);
+        bmp8_boxBlurRadius(img, 25);
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/15_flou_rayon25.bmp", outputDir);
+        bmp8_saveImage(outputPath, img);
+        bmp8_free(img);
+        printf("OK\n");
+    }
+
+    // Test 16 : Seuillage adaptatif
+    {
+        printf("Test 16 : Seuillage adaptatif (rayon 15)... ");
+        t_bmp8* img = bmp8_loadImage(inputFile);
+        bmp8_adaptiveThreshold(img, 15, 5);
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/16_seuillage_adaptatif.bmp", outputDir);
+        bmp8_saveImage(outputPath, img);
+        bmp8_free(img);
+        printf("OK\n");
+    }
+
+    // Test 17 : Flou entier (noyau à coefficients entiers)
+    {
+        printf("Test 17 : Flou entier... ");
+        t_bmp8* img = bmp8_loadImage(inputFile);
+        t_intKernel* kernel = createBoxBlurIntKernel();
+        bmp8_applyIntFilter(img, kernel);
+        freeIntKernel(kernel);
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/17_flou_entier.bmp", outputDir);
+        bmp8_saveImage(outputPath, img);
+        bmp8_free(img);
+        printf("OK\n");
+    }
+
+    // Test 18 : Résultats identiques sur 1 thread et sur plusieurs
+    {
+        printf("Test 18 : Égalisation sur 4 threads, puis filtres et tables sur 1, 3 et 7 threads... ");
+        threadpool_setThreadCount(4);
+        t_bmp8* img = bmp8_loadImage(inputFile);
+        bmp8_equalize(img);
+        threadpool_setThreadCount(0);
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/18_egalisation_4threads.bmp", outputDir);
+        bmp8_saveImage(outputPath, img);
+        bmp8_free(img);
+
+        float** kernels[5] = {createBoxBlurKernel(), createGaussianBlurKernel(), createOutlineKernel(),
+                              createEmbossKernel(), createSharpenKernel()};
+        const char* failed = NULL;
+        for (int threads = 3; threads <= 7 && !failed; threads += 4) {
+            for (int i = 0; i < 5 && !failed; i++) {
+                if (!sameOnThreads8(original, NULL, kernels[i], threads)) failed = "noyau 3x3";
+            }
+            for (int i = 0; i < THREAD_SPEC_COUNT && !failed; i++) {
+                if (!sameOnThreads8(original, threadSpecs[i], NULL, threads)) failed = threadSpecs[i];
+            }
+        }
+        for (int i = 0; i < 5; i++) {
+            freeFilterKernel(kernels[i], 3);
+        }
+        if (failed) {
+            printf("ÉCHEC (%s)\n", failed);
+            testFailures++;
+        } else {
+            printf("OK\n");
+        }
+    }
+
+    // Test 19 : Luminosité, négatif et seuillage enchaînés en une seule table
+    {
+        printf("Test 19 : Chaîne d'opérations ponctuelles... ");
+        t_bmp8* img = bmp8_loadImage(inputFile);
+        t_lut lut;
+        lut_identity(&lut);
+        lut_brightness(&lut, LUT_ALL, 40);
+        lut_negative(&lut, LUT_ALL);
+        lut_threshold(&lut, LUT_ALL, 128);
+        bmp8_applyLUT(img, &lut);
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/19_chaine_ponctuelle.bmp", outputDir);
+        bmp8_saveImage(outputPath, img);
+        bmp8_free(img);
+        printf("OK\n");
+    }
+
+    // Test 20 : Chaîne d'opérations analysée comme l'option --ops
+    {
+        printf("Test 20 : Chaîne --ops \"gauss,sharpen,equalize\"... ");
+        t_pipeline* pipeline = pipeline_parse("gauss,sharpen,equalize");
+        t_bmp8* img = bmp8_loadImage(inputFile);
+        pipeline_apply8(pipeline, img);
+        pipeline_free(pipeline);
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/20_chaine_ops.bmp", outputDir);
+        bmp8_saveImage(outputPath, img);
+        bmp8_free(img);
+        printf("OK\n");
+    }
+
+    // Test 23 : Égalisation adaptative à contraste limité
+    {
+        printf("Test 23 : CLAHE 8x8, limite 3... ");
+        t_bmp8* img = bmp8_loadImage(inputFile);
+        bmp8_clahe(img, 8, 8, 3.0f);
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/23_clahe.bmp", outputDir);
+        bmp8_saveImage(outputPath, img);
+        bmp8_free(img);
+        printf("OK\n");
+    }
+
+    // Test 24 : Filtre médian
+    {
+        printf("Test 24 : Filtre médian de rayon 3... ");
+        t_bmp8* img = bmp8_loadImage(inputFile);
+        bmp8_medianFilter(img, 3);
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/24_median.bmp", outputDir);
+        bmp8_saveImage(outputPath, img);
+        bmp8_free(img);
+        printf("OK\n");
+    }
+
+    // Test 25 : Contexte de traitement réutilisable
+    {
+        printf("Test 25 : Netteté puis médian avec un contexte... ");
+        t_bmpContext* ctx = context_create();
+        char outputPath[256];
+        for (int pass = 0; pass < 2; pass++) {
+            t_bmp8* img = bmp8_loadImage(inputFile);
+            context_bmp8Filter(ctx, img, CONTEXT_SHARPEN);
+            context_bmp8MedianFilter(ctx, img, 2);
+            snprintf(outputPath, sizeof(outputPath), "%s/25_contexte.bmp", outputDir);
+            bmp8_saveImage(outputPath, img);
+            bmp8_free(img);
+        }
+        context_free(ctx);
+        printf("OK\n");
+    }
+
+    // Test 26 : Chaîne de filtres entre deux images, sans copie
+    {
+        printf("Test 26 : Flou, netteté et contours alternés entre deux images... ");
+        t_bmp8* img = bmp8_loadImage(inputFile);
+        t_bmp8* other = bmp8_loadImage(inputFile);
+        float** kernels[3] = {createBoxBlurKernel(), createSharpenKernel(), createOutlineKernel()};
+        bmp8_applyFilterTo(img, other, kernels[0], 3);
+        bmp8_applyFilterTo(other, img, kernels[1], 3);
+        bmp8_applyFilterTo(img, other, kernels[2], 3);
+        for (int i = 0; i < 3; i++) {
+            freeFilterKernel(kernels[i], 3);
+        }
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/26_alternance.bmp", outputDir);
+        bmp8_saveImage(outputPath, other);
+        bmp8_free(img);
+        bmp8_free(other);
+        printf("OK\n");
+    }
+
+    // Test 27 : Largeur non multiple de 4 et lignes de haut en bas
+    {
+        printf("Test 27 : Relecture d'un recadrage de largeur impaire enregistré de haut en bas... ");
+        t_bmp8 crop = *original;
+        crop.width = original->width < 301 ? original->width : 301;
+        crop.height = original->height < 203 ? original->height : 203;
+        crop.dataSize = crop.width * crop.height;
+        crop.data = (unsigned char*)malloc(crop.dataSize);
+        for (unsigned int y = 0; y < crop.height; y++) {
+            memcpy(crop.data + y * crop.width, original->data + y * original->width, crop.width);
+        }
+        // Lignes en ordre inverse, déclarées de haut en bas
+        for (unsigned int y = 0; y < crop.height / 2; y++) {
+            for (unsigned int x = 0; x < crop.width; x++) {
+                unsigned char t = crop.data[y * crop.width + x];
+                crop.data[y * crop.width + x] = crop.data[(crop.height - 1 - y) * crop.width + x];
+                crop.data[(crop.height - 1 - y) * crop.width + x] = t;
+            }
+        }
+        *(int32_t*)&crop.header[22] = -(int32_t)crop.height;
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/27_haut_en_bas.bmp", outputDir);
+        bmp8_saveImage(outputPath, &crop);
+
+        // Relue de bas en haut : la ligne y est la ligne height - 1 - y de crop
+        t_bmp8* img = bmp8_loadImage(outputPath);
+        int same = img && img->width == crop.width && img->height == crop.height;
+        for (unsigned int y = 0; same && y < crop.height; y++) {
+            same = memcmp(img->data + y * crop.width, crop.data + (crop.height - 1 - y) * crop.width,
+                          crop.width) == 0;
+        }
+        free(crop.data);
+        if (img) {
+            bmp8_negative(img);
+            snprintf(outputPath, sizeof(outputPath), "%s/27_relu.bmp", outputDir);
+            bmp8_saveImage(outputPath, img);
+            bmp8_free(img);
+        }
+        if (!same) {
+            printf("ÉCHEC (image relue différente)\n");
+            testFailures++;
+        } else {
+            printf("OK\n");
+        }
+    }
+
+    // Test 30 : Suite de filtres tuile par tuile, comparée aux appels successifs
+    {
+        printf("Test 30 : Suites de 3 et %d filtres tuile par tuile... ", CHAIN_TEST_STAGES);
+        float** base[5] = {createBoxBlurKernel(), createSharpenKernel(), createOutlineKernel(),
+                           createEmbossKernel(), createGaussianBlurKernel()};
+        float** kernels[CHAIN_TEST_STAGES];
+        for (int i = 0; i < CHAIN_TEST_STAGES; i++) {
+            kernels[i] = base[i % 5];
+        }
+
+        int same = 1;
+        for (int s = -1; s < CHAIN_SIZE_COUNT && same; s++) {
+            // s = -1 : image entière
+            unsigned int width = s < 0 ? original->width : (unsigned int)chainSizes[s][0];
+            unsigned int height = s < 0 ? original->height : (unsigned int)chainSizes[s][1];
+            if (width > original->width || height > original->height) continue;
+            for (int count = 3; count <= CHAIN_TEST_STAGES && same; count += CHAIN_TEST_STAGES - 3) {
+                t_bmp8* chained = cropBmp8(original, width, height);
+                t_bmp8* expected = cropBmp8(original, width, height);
+                bmp8_applyFilterChain(chained, kernels, count);
+                for (int i = 0; i < count; i++) {
+                    bmp8_applyFilter(expected, kernels[i], 3);
+                }
+                same = sameBmp8(chained, expected);
+                bmp8_free(chained);
+                bmp8_free(expected);
+            }
+        }
+        for (int i = 0; i < 5; i++) {
+            freeFilterKernel(base[i], 3);
+        }
+        if (!same) {
+            printf("ÉCHEC (différent de bmp8_applyFilter)\n");
+            testFailures++;
+        } else {
+            printf("OK\n");
+        }
+    }
+
     bmp8_free(original);
     printf("\nTous les tests 8 bits terminés avec succès !\n");
 }
 
+/**
+ * @brief Égalisation de référence : calcul flottant en YUV, pixel par pixel
+ *
+ * Reprend l'ancienne implémentation de bmp24_equalize (histogramme et
+ * reconversion en flottants), qui sert à borner l'écart du calcul entier.
+ *
+ * @param img Image à égaliser
+ */
+static void referenceEqualize24(t_bmp24* img) {
+    unsigned int hist[256] = {0};
+    unsigned int map[256];
+    for (int y = 0; y < img->height; y++) {
+        for (int x = 0; x < img->width; x++) {
+            t_pixel p = img->data[y][x];
+            int yValue = (int)round(0.299f * p.red + 0.587f * p.green + 0.114f * p.blue);
+            if (yValue < 0) yValue = 0;
+            if (yValue > 255) yValue = 255;
+            hist[yValue]++;
+        }
+    }
+    bmp24_computeEqualizationMap(hist, (unsigned int)(img->width * img->height), map);
+
+    for (int y = 0; y < img->height; y++) {
+        for (int x = 0; x < img->width; x++) {
+            t_pixel* p = &img->data[y][x];
+            float R = p->red;
+            float G = p->green;
+            float B = p->blue;
+            float yVal = 0.299f * R + 0.587f * G + 0.114f * B;
+            float uVal = -0.14713f * R - 0.28886f * G + 0.436f * B;
+            float vVal = 0.615f * R - 0.51499f * G - 0.10001f * B;
+            int yValue = (int)round(yVal);
+            if (yValue < 0) yValue = 0;
+            if (yValue > 255) yValue = 255;
+            yVal = (float)map[yValue];
+
+            float channels[3] = {
+                yVal + 1.13983f * vVal,
+                yVal - 0.39465f * uVal - 0.58060f * vVal,
+                yVal + 2.03211f * uVal
+            };
+            for (int c = 0; c < 3; c++) {
+                if (channels[c] < 0) channels[c] = 0;
+                if (channels[c] > 255) channels[c] = 255;
+            }
+            p->red = (uint8_t)round(channels[0]);
+            p->green = (uint8_t)round(channels[1]);
+            p->blue = (uint8_t)round(channels[2]);
+        }
+    }
+}
+
+/**
+ * @brief Plus grand écart entre deux images 24 bits de même taille, canal par canal
+ * @param a Première image
+ * @param b Seconde image
+ * @return Écart maximal (0 à 255)
+ */
+static int maxDifference24(t_bmp24* a, t_bmp24* b) {
+    int maxDiff = 0;
+    for (int y = 0; y < a->height; y++) {
+        for (int x = 0; x < a->width; x++) {
+            t_pixel p = a->data[y][x];
+            t_pixel q = b->data[y][x];
+            int diffs[3] = {abs(p.red - q.red), abs(p.green - q.green), abs(p.blue - q.blue)};
+            for (int c = 0; c < 3; c++) {
+                if (diffs[c] > maxDiff) maxDiff = diffs[c];
+            }
+        }
+    }
+    return maxDiff;
+}
+
 /**
  * @brief Teste toutes les fonctionnalités pour les images 24 bits
  * @param inputFile Fichier d'entrée
@@ -346,6 +905,514 @@ void testBmp24Functions(const char* inputFile, const char* outputDir) {
         printf("OK\n");
     }
 
+    // Test 12 : Statistiques et négatif sur une projection mémoire
+    {
+        printf("Test 12 : Négatif sur projection mmap... ");
+        t_bmp_view* view = bmp_viewOpen(inputFile, BMP_VIEW_PRIVATE);
+        if (view) {
+            t_bmp_stats stats;
+            bmp_viewComputeStats(view, BMP_CHANNEL_RED, &stats);
+            printf("(rouge : min %d, max %d, moyenne %.1f) ", stats.min, stats.max, stats.mean);
+            bmp_viewNegative(view);
+            char outputPath[256];
+            snprintf(outputPath, sizeof(outputPath), "%s/12_negatif_mmap.bmp", outputDir);
+            bmp_viewSave(view, outputPath);
+            bmp_viewClose(view);
+        }
+        printf("OK\n");
+    }
+
+    // Test 13 : Relief et égalisation en flux, par bandes de 16 lignes
+    {
+        printf("Test 13 : Relief et égalisation en flux... ");
+        float** kernel = createEmbossKernel();
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/13_relief_flux.bmp", outputDir);
+        bmp_streamFilter(inputFile, outputPath, kernel, 3, 16);
+        freeFilterKernel(kernel, 3);
+        snprintf(outputPath, sizeof(outputPath), "%s/13_egalisation_flux.bmp", outputDir);
+        bmp_streamEqualize(inputFile, outputPath, 16);
+        printf("OK\n");
+    }
+
+    // Test 14 : Flou gaussien séparable de grand rayon
+    {
+        printf("Test 14 : Flou gaussien séparable (sigma 4)... ");
+        t_bmp24* img = bmp24_loadImage(inputFile);
+        t_separableKernel* kernel = createSeparableGaussianKernel(4.0f);
+        bmp24_applySeparableFilter(img, kernel);
+        freeSeparableKernel(kernel);
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/14_flou_gaussien_sigma4.bmp", outputDir);
+        bmp24_saveImage(img, outputPath);
+        bmp24_free(img);
+        printf("OK\n");
+    }
+
+    // Test 15 : Flou simple de rayon 25 par sommes glissantes
+    {
+        printf("Test 15 : Flou simple rayon 25... ");
+        t_bmp24* img = bmp24_loadImage(inputFile);
+        bmp24_boxBlurRadius(img, 25);
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/15_flou_rayon25.bmp", outputDir);
+        bmp24_saveImage(img, outputPath);
+        bmp24_free(img);
+        printf("OK\n");
+    }
+
+    // Test 17 : Flou entier (noyau à coefficients entiers)
+    {
+        printf("Test 17 : Flou entier... ");
+        t_bmp24* img = bmp24_loadImage(inputFile);
+        t_intKernel* kernel = createBoxBlurIntKernel();
+        bmp24_applyIntFilter(img, kernel);
+        freeIntKernel(kernel);
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/17_flou_entier.bmp", outputDir);
+        bmp24_saveImage(img, outputPath);
+        bmp24_free(img);
+        printf("OK\n");
+    }
+
+    // Test 18 : Résultats identiques sur 1 thread et sur plusieurs
+    {
+        printf("Test 18 : Égalisation sur 4 threads, puis filtres et tables sur 1, 3 et 7 threads... ");
+        threadpool_setThreadCount(4);
+        t_bmp24* img = bmp24_loadImage(inputFile);
+        bmp24_equalize(img);
+        threadpool_setThreadCount(0);
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/18_egalisation_4threads.bmp", outputDir);
+        bmp24_saveImage(img, outputPath);
+        bmp24_free(img);
+
+        float** kernels[5] = {createBoxBlurKernel(), createGaussianBlurKernel(), createOutlineKernel(),
+                              createEmbossKernel(), createSharpenKernel()};
+        const char* failed = NULL;
+        for (int threads = 3; threads <= 7 && !failed; threads += 4) {
+            for (int i = 0; i < 5 && !failed; i++) {
+                if (!sameOnThreads24(original, NULL, kernels[i], threads)) failed = "noyau 3x3";
+            }
+            for (int i = 0; i < THREAD_SPEC_COUNT && !failed; i++) {
+                if (!sameOnThreads24(original, threadSpecs[i], NULL, threads)) failed = threadSpecs[i];
+            }
+        }
+        for (int i = 0; i < 5; i++) {
+            freeFilterKernel(kernels[i], 3);
+        }
+        if (failed) {
+            printf("ÉCHEC (%s)\n", failed);
+            testFailures++;
+        } else {
+            printf("OK\n");
+        }
+    }
+
+    // Test 19 : Opérations ponctuelles différentes par canal, en une seule table
+    {
+        printf("Test 19 : Chaîne d'opérations par canal... ");
+        t_bmp24* img = bmp24_loadImage(inputFile);
+        t_lut lut;
+        lut_identity(&lut);
+        lut_brightness(&lut, LUT_RED, 60);
+        lut_negative(&lut, LUT_BLUE);
+        lut_threshold(&lut, LUT_GREEN, 100);
+        bmp24_applyLUT(img, &lut);
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/19_chaine_par_canal.bmp", outputDir);
+        bmp24_saveImage(img, outputPath);
+        bmp24_free(img);
+        printf("OK\n");
+    }
+
+    // Test 20 : Chaîne d'opérations analysée comme l'option --ops
+    {
+        printf("Test 20 : Chaîne --ops \"gauss,sharpen,equalize\"... ");
+        t_pipeline* pipeline = pipeline_parse("gauss,sharpen,equalize");
+        t_bmp24* img = bmp24_loadImage(inputFile);
+        pipeline_apply24(pipeline, img);
+        pipeline_free(pipeline);
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/20_chaine_ops.bmp", outputDir);
+        bmp24_saveImage(img, outputPath);
+        bmp24_free(img);
+        printf("OK\n");
+    }
+
+    // Test 21 : Traitement par lot en pipeline (lecture, calcul, écriture)
+    {
+        printf("Test 21 : Lot en pipeline... ");
+        t_pipeline* pipeline = pipeline_parse("gauss,sharpen,equalize");
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/21_lot_pipeline.bmp", outputDir);
+        const char* inputs[1] = {inputFile};
+        const char* outputs[1] = {outputPath};
+        t_batchStats stats;
+        batch_run(pipeline, inputs, outputs, 1, 0, &stats);
+        pipeline_free(pipeline);
+        printf("OK (%d image(s))\n", stats.processed);
+    }
+
+    // Test 22 : Mesure du temps, des entrées/sorties et des allocations
+    {
+        printf("Test 22 : Mesures par fonction (JSON)... ");
+        int wasEnabled = instrument_isEnabled();
+        instrument_setEnabled(1);
+        instrument_reset();
+        t_bmp24* img = bmp24_loadImage(inputFile);
+        bmp24_gaussianBlur(img);
+        bmp24_equalize(img);
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/22_mesures.bmp", outputDir);
+        bmp24_saveImage(img, outputPath);
+        bmp24_free(img);
+        snprintf(outputPath, sizeof(outputPath), "%s/22_mesures.json", outputDir);
+        instrument_saveJSON(outputPath);
+        instrument_setEnabled(wasEnabled);
+        printf("OK\n");
+    }
+
+    // Test 23 : Égalisation adaptative à contraste limité
+    {
+        printf("Test 23 : CLAHE 8x8, limite 3... ");
+        t_bmp24* img = bmp24_loadImage(inputFile);
+        bmp24_clahe(img, 8, 8, 3.0f);
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/23_clahe.bmp", outputDir);
+        bmp24_saveImage(img, outputPath);
+        bmp24_free(img);
+        printf("OK\n");
+    }
+
+    // Test 24 : Filtre médian
+    {
+        printf("Test 24 : Filtre médian de rayon 3... ");
+        t_bmp24* img = bmp24_loadImage(inputFile);
+        bmp24_medianFilter(img, 3);
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/24_median.bmp", outputDir);
+        bmp24_saveImage(img, outputPath);
+        bmp24_free(img);
+        printf("OK\n");
+    }
+
+    // Test 25 : Contexte de traitement réutilisable (le second passage n'alloue rien)
+    {
+        printf("Test 25 : Flou gaussien, médian et flou de rayon 5 avec un contexte... ");
+        int wasEnabled = instrument_isEnabled();
+        instrument_setEnabled(1);
+        t_bmpContext* ctx = context_create();
+        t_bmp24* img = bmp24_loadImage(inputFile);
+        t_bmp24* work = bmp24_allocate(img->width, img->height, img->colorDepth);
+        work->header = img->header;
+        work->header_info = img->header_info;
+        unsigned long long secondPassAllocations = 0;
+        for (int pass = 0; pass < 2; pass++) {
+            instrument_reset();
+            t_instrumentCounters before = instrument_getCounters();
+            bmp24_copyPixels(work, img);
+            context_bmp24Filter(ctx, work, CONTEXT_GAUSSIAN_BLUR);
+            context_bmp24MedianFilter(ctx, work, 2);
+            context_bmp24BoxBlurRadius(ctx, work, 5);
+            secondPassAllocations = instrument_getCounters().allocations - before.allocations;
+        }
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/25_contexte.json", outputDir);
+        instrument_saveJSON(outputPath);
+        instrument_setEnabled(wasEnabled);
+        snprintf(outputPath, sizeof(outputPath), "%s/25_contexte.bmp", outputDir);
+        bmp24_saveImage(work, outputPath);
+        bmp24_free(work);
+        bmp24_free(img);
+        context_free(ctx);
+        if (secondPassAllocations > 0) {
+            printf("ÉCHEC (%llu allocation(s) au second passage)\n", secondPassAllocations);
+            testFailures++;
+        } else {
+            printf("OK\n");
+        }
+    }
+
+    // Test 26 : Chaîne de filtres entre deux images, sans copie
+    {
+        printf("Test 26 : Flou, netteté et contours alternés entre deux images... ");
+        t_bmp24* img = bmp24_loadImage(inputFile);
+        t_bmp24* other = bmp24_loadImage(inputFile);
+        float** kernels[3] = {createBoxBlurKernel(), createSharpenKernel(), createOutlineKernel()};
+        bmp24_applyFilterTo(img, other, kernels[0], 3);
+        bmp24_applyFilterTo(other, img, kernels[1], 3);
+        bmp24_applyFilterTo(img, other, kernels[2], 3);
+        for (int i = 0; i < 3; i++) {
+            freeFilterKernel(kernels[i], 3);
+        }
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/26_alternance.bmp", outputDir);
+        bmp24_saveImage(other, outputPath);
+        bmp24_free(img);
+        bmp24_free(other);
+        printf("OK\n");
+    }
+
+    // Test 27 : Conversion directe en image 8 bits
+    {
+        printf("Test 27 : Conversion en image 8 bits puis égalisation... ");
+        t_bmp24* img = bmp24_loadImage(inputFile);
+        t_bmp8* gray = bmp24_toBmp8(img);
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/27_gris_8bits.bmp", outputDir);
+        bmp8_saveImage(outputPath, gray);
+        bmp8_equalize(gray);
+        snprintf(outputPath, sizeof(outputPath), "%s/27_gris_8bits_egalise.bmp", outputDir);
+        bmp8_saveImage(outputPath, gray);
+        bmp8_free(gray);
+        bmp24_free(img);
+        printf("OK\n");
+    }
+
+    // Test 28 : Traitements en plans séparés
+    {
+        printf("Test 28 : Flou gaussien, médian et égalisation en plans séparés... ");
+        t_bmp24* img = bmp24_loadImage(inputFile);
+        t_planar* planar = planar_fromBmp24(img);
+        float** kernel = createGaussianBlurKernel();
+        planar_applyFilter(planar, kernel, 3);
+        freeFilterKernel(kernel, 3);
+        planar_medianFilter(planar, 2);
+        planar_equalize(planar);
+        char outputPath[256];
+        t_bmp8 plane;
+        planar_planeAsBmp8(planar, LUT_RED, &plane);
+        snprintf(outputPath, sizeof(outputPath), "%s/28_plan_rouge.bmp", outputDir);
+        bmp8_saveImage(outputPath, &plane);
+        planar_interleave(planar, img);
+        snprintf(outputPath, sizeof(outputPath), "%s/28_plans.bmp", outputDir);
+        bmp24_saveImage(img, outputPath);
+        planar_free(planar);
+        bmp24_free(img);
+        printf("OK\n");
+    }
+
+    // Test 29 : Opérations différées, appliquées en un seul parcours à la sauvegarde
+    {
+        printf("Test 29 : Flou gaussien, netteté, luminosité et négatif différés... ");
+        t_lazyImage* img = lazy_load(inputFile);
+        lazy_gaussianBlur(img);
+        lazy_sharpen(img);
+        lazy_brightness(img, 20);
+        lazy_negative(img);
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/29_differe.bmp", outputDir);
+        lazy_save(img, outputPath);
+        lazy_outline(img);
+        lazy_ops(img, "gray8,threshold=60");
+        snprintf(outputPath, sizeof(outputPath), "%s/29_differe_contours.bmp", outputDir);
+        lazy_save(img, outputPath);
+        lazy_free(img);
+
+        // Comparaison aux appels directs, avec des tables entre les noyaux (repliées
+        // dans la suite de filtres), puis après conversion en 8 bits
+        t_bmp24* eager = copyBmp24(original);
+        bmp24_gaussianBlur(eager);
+        bmp24_brightness(eager, 30);
+        bmp24_sharpen(eager);
+        bmp24_negative(eager);
+        bmp24_emboss(eager);
+        bmp24_boxBlur(eager);
+        bmp24_brightness(eager, -10);
+
+        img = lazy_wrap24(copyBmp24(original));
+        lazy_gaussianBlur(img);
+        lazy_brightness(img, 30);
+        lazy_sharpen(img);
+        lazy_negative(img);
+        lazy_emboss(img);
+        lazy_blur(img);
+        lazy_brightness(img, -10);
+        int same = sameBmp24(lazy_bmp24(img), eager);
+
+        bmp24_outline(eager);
+        t_bmp8* eager8 = bmp24_toBmp8(eager);
+        bmp8_threshold(eager8, 60);
+        lazy_outline(img);
+        lazy_ops(img, "gray8,threshold=60");
+        same = same && sameBmp8(lazy_bmp8(img), eager8);
+
+        lazy_free(img);
+        bmp8_free(eager8);
+        bmp24_free(eager);
+        if (!same) {
+            printf("ÉCHEC (différent des appels directs)\n");
+            testFailures++;
+        } else {
+            printf("OK\n");
+        }
+    }
+
+    // Test 30 : Suite de filtres appliquée tuile par tuile
+    {
+        printf("Test 30 : Flou, netteté et contours tuile par tuile... ");
+        t_bmp24* img = bmp24_loadImage(inputFile);
+        float** kernels[3] = {createBoxBlurKernel(), createSharpenKernel(), createOutlineKernel()};
+        bmp24_applyFilterChain(img, kernels, 3);
+        for (int i = 0; i < 3; i++) {
+            freeFilterKernel(kernels[i], 3);
+        }
+        char outputPath[256];
+        snprintf(outputPath, sizeof(outputPath), "%s/30_chaine_tuiles.bmp", outputDir);
+        bmp24_saveImage(img, outputPath);
+        bmp24_free(img);
+
+        // Comparaison aux appels successifs de bmp24_applyFilter : image entière,
+        // recadrages (largeurs impaires, hauteurs < 3), suites de 3 et 19 noyaux
+        float** base[5] = {createBoxBlurKernel(), createSharpenKernel(), createOutlineKernel(),
+                           createEmbossKernel(), createGaussianBlurKernel()};
+        float** chain[CHAIN_TEST_STAGES];
+        for (int i = 0; i < CHAIN_TEST_STAGES; i++) {
+            chain[i] = base[i % 5];
+        }
+
+        int same = 1;
+        for (int s = -1; s < CHAIN_SIZE_COUNT && same; s++) {
+            int width = s < 0 ? original->width : chainSizes[s][0];
+            int height = s < 0 ? original->height : chainSizes[s][1];
+            if (width > original->width || height > original->height) continue;
+            for (int count = 3; count <= CHAIN_TEST_STAGES && same; count += CHAIN_TEST_STAGES - 3) {
+                t_bmp24* chained = cropBmp24(original, width, height);
+                t_bmp24* expected = cropBmp24(original, width, height);
+                bmp24_applyFilterChain(chained, chain, count);
+                for (int i = 0; i < count; i++) {
+                    bmp24_applyFilter(expected, chain[i], 3);
+                }
+                same = sameBmp24(chained, expected);
+                bmp24_free(chained);
+                bmp24_free(expected);
+            }
+        }
+        for (int i = 0; i < 5; i++) {
+            freeFilterKernel(base[i], 3);
+        }
+        if (!same) {
+            printf("ÉCHEC (différent de bmp24_applyFilter)\n");
+            testFailures++;
+        } else {
+            printf("OK\n");
+        }
+    }
+
+    // Test 31 : Égalisation entière à ±1 près du calcul flottant en YUV
+    {
+        printf("Test 31 : Égalisation comparée au calcul flottant (écart max 1)... ");
+        // Image nette (beaucoup de luminances à mi-chemin) puis bruit pseudo-aléatoire
+        t_bmp24* sources[2];
+        sources[0] = bmp24_loadImage(inputFile);
+        bmp24_sharpen(sources[0]);
+        sources[1] = bmp24_allocate(512, 512, 24);
+        unsigned int seed = 12345;
+        for (int y = 0; y < 512; y++) {
+            for (int x = 0; x < 512; x++) {
+                seed = seed * 1103515245u + 12345u;
+                sources[1]->data[y][x].red = (uint8_t)(seed >> 24);
+                sources[1]->data[y][x].green = (uint8_t)(seed >> 16);
+                sources[1]->data[y][x].blue = (uint8_t)(seed >> 8);
+            }
+        }
+
+        int maxDiff = 0;
+        for (int i = 0; i < 2; i++) {
+            t_bmp24* src = sources[i];
+            t_bmp24* expected = bmp24_allocate(src->width, src->height, 24);
+            t_bmp24* actual = bmp24_allocate(src->width, src->height, 24);
+            bmp24_copyPixels(expected, src);
+            bmp24_copyPixels(actual, src);
+            referenceEqualize24(expected);
+
+            bmp24_equalize(actual);
+            int diff = maxDifference24(expected, actual);
+            if (diff > maxDiff) maxDiff = diff;
+
+            t_planar* planar = planar_fromBmp24(src);
+            planar_equalize(planar);
+            planar_interleave(planar, actual);
+            planar_free(planar);
+            diff = maxDifference24(expected, actual);
+            if (diff > maxDiff) maxDiff = diff;
+
+            bmp24_free(expected);
+            bmp24_free(actual);
+            bmp24_free(src);
+        }
+
+        if (maxDiff > 1) {
+            printf("ÉCHEC (écart de %d)\n", maxDiff);
+            testFailures++;
+        } else {
+            printf("OK\n");
+        }
+    }
+
+    // Test 32 : Versions vectorisées identiques aux versions scalaires
+    {
+        printf("Test 32 : Noyaux 3x3 et luminance en SSE2/AVX2 comparés au scalaire... ");
+        float** kernels[5] = {createBoxBlurKernel(), createGaussianBlurKernel(), createOutlineKernel(),
+                              createEmbossKernel(), createSharpenKernel()};
+        // Image entière et recadrage de largeur impaire (fins de ligne hors vecteur)
+        int cropWidth = original->width < 301 ? original->width : 301;
+        int cropHeight = original->height < 203 ? original->height : 203;
+        t_bmp24* sources[2] = {copyBmp24(original), cropBmp24(original, cropWidth, cropHeight)};
+
+        const char* failed = NULL;
+        for (int s = 0; s < 2 && !failed; s++) {
+            // Résultats de référence, en scalaire
+            simd_setMaxLevel(SIMD_LEVEL_NONE);
+            t_bmp24* expected24[5];
+            t_bmp8* expected8[5];
+            t_bmp8* expectedGray = bmp24_toBmp8(sources[s]);
+            for (int k = 0; k < 5; k++) {
+                expected24[k] = copyBmp24(sources[s]);
+                bmp24_applyFilter(expected24[k], kernels[k], 3);
+                expected8[k] = copyBmp8(expectedGray);
+                bmp8_applyFilter(expected8[k], kernels[k], 3);
+            }
+
+            for (int level = SIMD_LEVEL_SSE2; level <= SIMD_LEVEL_AVX2 && !failed; level++) {
+                simd_setMaxLevel(level);
+                t_bmp8* gray = bmp24_toBmp8(sources[s]);
+                if (!sameBmp8(gray, expectedGray)) failed = "bmp24_toBmp8";
+                for (int k = 0; k < 5 && !failed; k++) {
+                    t_bmp24* img24 = copyBmp24(sources[s]);
+                    bmp24_applyFilter(img24, kernels[k], 3);
+                    t_bmp8* img8 = copyBmp8(expectedGray);
+                    bmp8_applyFilter(img8, kernels[k], 3);
+                    if (!sameBmp24(img24, expected24[k])) failed = "bmp24_applyFilter";
+                    if (!sameBmp8(img8, expected8[k])) failed = "bmp8_applyFilter";
+                    bmp24_free(img24);
+                    bmp8_free(img8);
+                }
+                bmp8_free(gray);
+            }
+            simd_setMaxLevel(SIMD_LEVEL_AVX2);
+
+            for (int k = 0; k < 5; k++) {
+                bmp24_free(expected24[k]);
+                bmp8_free(expected8[k]);
+            }
+            bmp8_free(expectedGray);
+        }
+
+        for (int k = 0; k < 5; k++) {
+            freeFilterKernel(kernels[k], 3);
+        }
+        bmp24_free(sources[0]);
+        bmp24_free(sources[1]);
+        if (failed) {
+            printf("ÉCHEC (%s)\n", failed);
+            testFailures++;
+        } else {
+            printf("OK\n");
+        }
+    }
+
     bmp24_free(original);
     printf("\nTous les tests 24 bits terminés avec succès !\n");
 }
@@ -386,5 +1453,9 @@ int main(int argc, char* argv[]) {
     printf("- tests_24bits/\n");
     printf("=================================================\n");
 
+    if (testFailures > 0) {
+        printf("Erreur : %d test(s) en échec\n", testFailures);
+        return 1;
+    }
     return 0;
 }
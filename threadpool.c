@@ -0,0 +1,289 @@
+/**
+ * @file threadpool.c
+ * @author Projet TI202
+ * @brief Implémentation du pool de threads
+ * @date 2025
+ */
+
+#ifndef _WIN32
+    #define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "threadpool.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef _WIN32
+    #include <pthread.h>
+    #include <unistd.h>
+#endif
+
+/**
+ * @brief Nombre de threads à utiliser si aucun n'a été demandé
+ */
+static int defaultThreadCount(void) {
+    const char* env = getenv("BMP_THREADS");
+    int count = env ? atoi(env) : 0;
+#ifndef _WIN32
+    if (count <= 0) count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (count <= 0) count = 1;
+    if (count > THREADPOOL_MAX_THREADS) count = THREADPOOL_MAX_THREADS;
+    return count;
+}
+
+/**
+ * @brief Exécute les bandes d'un travail une par une dans le thread appelant
+ */
+static void runSerial(int count, int bands, t_bandFunc func, void* arg) {
+    for (int i = 0; i < bands; i++) {
+        int start = (int)((long long)count * i / bands);
+        int end = (int)((long long)count * (i + 1) / bands);
+        func(start, end, i, arg);
+    }
+}
+
+#ifndef _WIN32
+
+// État global du pool : les threads sont créés au premier travail
+static struct {
+    pthread_mutex_t lock;     // Protège tous les champs ci-dessous
+    pthread_cond_t wake;      // Un travail est disponible
+    pthread_cond_t done;      // Toutes les bandes sont terminées
+    pthread_mutex_t jobLock;  // Un seul travail à la fois
+
+    pthread_t threads[THREADPOOL_MAX_THREADS];
+    int started;              // Nombre de threads créés
+    int threadCount;          // Threads utilisés (appelant compris), 0 si pas encore fixé
+    int stop;                 // Demande d'arrêt des threads
+
+    // Travail en cours
+    t_bandFunc func;
+    void* arg;
+    int count;
+    int bands;
+    int next;                 // Prochaine bande à distribuer
+    int remaining;            // Bandes non terminées
+} pool = {
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER,
+    PTHREAD_MUTEX_INITIALIZER, {0}, 0, 0, 0, NULL, NULL, 0, 0, 0, 0
+};
+
+/**
+ * @brief Exécute des bandes du travail en cours tant qu'il en reste
+ *
+ * Appelée avec pool.lock verrouillé ; le verrou est relâché pendant le
+ * traitement de chaque bande.
+ */
+static void runBands(void) {
+    while (pool.func && pool.next < pool.bands) {
+        int i = pool.next++;
+        t_bandFunc func = pool.func;
+        void* arg = pool.arg;
+        int start = (int)((long long)pool.count * i / pool.bands);
+        int end = (int)((long long)pool.count * (i + 1) / pool.bands);
+
+        pthread_mutex_unlock(&pool.lock);
+        func(start, end, i, arg);
+        pthread_mutex_lock(&pool.lock);
+
+        if (--pool.remaining == 0) pthread_cond_signal(&pool.done);
+    }
+}
+
+/**
+ * @brief Boucle des threads du pool
+ */
+static void* workerMain(void* unused) {
+    (void)unused;
+    pthread_mutex_lock(&pool.lock);
+    for (;;) {
+        while (!pool.stop && (!pool.func || pool.next >= pool.bands)) {
+            pthread_cond_wait(&pool.wake, &pool.lock);
+        }
+        if (pool.stop) break;
+        runBands();
+    }
+    pthread_mutex_unlock(&pool.lock);
+    return NULL;
+}
+
+/**
+ * @brief Fixe le nombre de threads utilisés par les traitements
+ *
+ * Les threads existants sont arrêtés ; ils seront recréés au prochain
+ * travail.
+ *
+ * @param count Nombre de threads (thread appelant compris), 0 pour la valeur par défaut
+ */
+void threadpool_setThreadCount(int count) {
+    threadpool_shutdown();
+
+    if (count > THREADPOOL_MAX_THREADS) count = THREADPOOL_MAX_THREADS;
+    pthread_mutex_lock(&pool.lock);
+    pool.threadCount = (count > 0) ? count : defaultThreadCount();
+    pthread_mutex_unlock(&pool.lock);
+}
+
+/**
+ * @brief Renvoie le nombre de threads utilisés par les traitements
+ */
+int threadpool_getThreadCount(void) {
+    pthread_mutex_lock(&pool.lock);
+    if (pool.threadCount == 0) pool.threadCount = defaultThreadCount();
+    int count = pool.threadCount;
+    pthread_mutex_unlock(&pool.lock);
+    return count;
+}
+
+/**
+ * @brief Exécute func sur [0, count) découpé en threadpool_bandCount bandes
+ *
+ * Le thread appelant traite lui aussi des bandes et la fonction ne rend la
+ * main qu'une fois toutes les bandes terminées. Si un autre travail est
+ * déjà en cours (appel depuis une bande ou depuis un autre thread), les
+ * bandes sont exécutées dans le thread appelant, avec le même découpage.
+ *
+ * @param count Nombre d'éléments (de lignes le plus souvent)
+ * @param itemWork Travail approximatif d'un élément, en pixels
+ * @param func Fonction appelée pour chaque bande
+ * @param arg Argument transmis à func
+ * @return Nombre de bandes traitées (indices 0 à bands - 1)
+ */
+int threadpool_run(int count, int itemWork, t_bandFunc func, void* arg) {
+    return threadpool_runBands(count, threadpool_bandCount(count, itemWork), func, arg);
+}
+
+/**
+ * @brief Exécute func sur [0, count) découpé en un nombre de bandes choisi par l'appelant
+ *
+ * Deux appels avec les mêmes count et bands donnent le même découpage,
+ * quel que soit le nombre de threads entre les deux : un traitement en
+ * plusieurs passes peut ainsi garder un état par bande.
+ *
+ * @param count Nombre d'éléments
+ * @param bands Nombre de bandes (ramené entre 1 et min(count, THREADPOOL_MAX_THREADS))
+ * @param func Fonction appelée pour chaque bande
+ * @param arg Argument transmis à func
+ * @return Nombre de bandes traitées
+ */
+int threadpool_runBands(int count, int bands, t_bandFunc func, void* arg) {
+    if (count <= 0) return 0;
+    if (bands > count) bands = count;
+    if (bands > THREADPOOL_MAX_THREADS) bands = THREADPOOL_MAX_THREADS;
+    if (bands < 1) bands = 1;
+
+    if (bands == 1 || pthread_mutex_trylock(&pool.jobLock) != 0) {
+        runSerial(count, bands, func, arg);
+        return bands;
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    if (pool.threadCount == 0) pool.threadCount = defaultThreadCount();
+
+    // Créer les threads manquants (le thread appelant compte pour un)
+    while (pool.started < pool.threadCount - 1) {
+        if (pthread_create(&pool.threads[pool.started], NULL, workerMain, NULL) != 0) {
+            printf("Erreur: Création de thread échouée\n");
+            break;
+        }
+        pool.started++;
+    }
+
+    pool.func = func;
+    pool.arg = arg;
+    pool.count = count;
+    pool.bands = bands;
+    pool.next = 0;
+    pool.remaining = bands;
+    pthread_cond_broadcast(&pool.wake);
+
+    runBands();
+    while (pool.remaining > 0) {
+        pthread_cond_wait(&pool.done, &pool.lock);
+    }
+    pool.func = NULL;
+
+    pthread_mutex_unlock(&pool.lock);
+    pthread_mutex_unlock(&pool.jobLock);
+    return bands;
+}
+
+/**
+ * @brief Arrête les threads du pool (ils seront recréés si nécessaire)
+ */
+void threadpool_shutdown(void) {
+    pthread_mutex_lock(&pool.jobLock);
+    pthread_mutex_lock(&pool.lock);
+    pool.stop = 1;
+    pthread_cond_broadcast(&pool.wake);
+    pthread_mutex_unlock(&pool.lock);
+
+    for (int i = 0; i < pool.started; i++) {
+        pthread_join(pool.threads[i], NULL);
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    pool.started = 0;
+    pool.stop = 0;
+    pthread_mutex_unlock(&pool.lock);
+    pthread_mutex_unlock(&pool.jobLock);
+}
+
+#else
+
+// Sans pthread : les bandes sont exécutées dans le thread appelant
+static int threadCount = 0;
+
+void threadpool_setThreadCount(int count) {
+    threadCount = (count > 0) ? count : defaultThreadCount();
+}
+
+int threadpool_getThreadCount(void) {
+    if (threadCount == 0) threadCount = defaultThreadCount();
+    return threadCount;
+}
+
+int threadpool_run(int count, int itemWork, t_bandFunc func, void* arg) {
+    return threadpool_runBands(count, threadpool_bandCount(count, itemWork), func, arg);
+}
+
+int threadpool_runBands(int count, int bands, t_bandFunc func, void* arg) {
+    if (count <= 0) return 0;
+    if (bands > count) bands = count;
+    if (bands > THREADPOOL_MAX_THREADS) bands = THREADPOOL_MAX_THREADS;
+    if (bands < 1) bands = 1;
+    runSerial(count, bands, func, arg);
+    return bands;
+}
+
+void threadpool_shutdown(void) {
+}
+
+#endif
+
+/**
+ * @brief Nombre de bandes utilisées par threadpool_run pour ces paramètres
+ *
+ * Permet de réserver un résultat partiel par bande avant threadpool_run.
+ * Le découpage ne dépend que de count, itemWork et du nombre de threads ;
+ * si ce dernier peut changer entre les deux appels, utiliser plutôt le
+ * nombre de bandes renvoyé par threadpool_run.
+ *
+ * @param count Nombre d'éléments
+ * @param itemWork Travail approximatif d'un élément, en pixels
+ * @return Nombre de bandes (0 si count <= 0)
+ */
+int threadpool_bandCount(int count, int itemWork) {
+    if (count <= 0) return 0;
+    if (itemWork < 1) itemWork = 1;
+
+    long long total = (long long)count * itemWork;
+    long long bands = total / THREADPOOL_MIN_BAND_WORK;
+    int threads = threadpool_getThreadCount();
+
+    if (bands > threads) bands = threads;
+    if (bands > count) bands = count;
+    if (bands < 1) bands = 1;
+    return (int)bands;
+}
@@ -0,0 +1,40 @@
+/**
+ * @file threadpool.h
+ * @author Projet TI202
+ * @brief Pool de threads pour le traitement des images par bandes de lignes
+ * @date 2025
+ *
+ * Un travail est découpé en bandes contiguës (des lignes le plus souvent),
+ * toujours de la même façon pour un nombre de threads donné : la bande i
+ * couvre [count * i / bands, count * (i + 1) / bands). Les résultats
+ * partiels indexés par bande (histogrammes par exemple) peuvent donc être
+ * fusionnés dans un ordre fixe et les résultats ne dépendent pas de l'ordre
+ * d'exécution. threadpool_run renvoie le nombre de bandes effectivement
+ * utilisé : c'est lui qu'il faut fusionner, le nombre de threads pouvant
+ * changer entre threadpool_bandCount et threadpool_run.
+ *
+ * Le nombre de threads vaut par défaut le nombre de processeurs ; il peut
+ * être fixé par threadpool_setThreadCount ou par la variable
+ * d'environnement BMP_THREADS (1 pour tout exécuter dans le thread appelant).
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+// Nombre maximal de threads (thread appelant compris)
+#define THREADPOOL_MAX_THREADS 64
+
+// Travail minimal d'une bande (en pixels), en dessous le découpage coûte plus qu'il ne rapporte
+#define THREADPOOL_MIN_BAND_WORK 16384
+
+// Traitement d'une bande [start, end) ; band est l'indice de la bande
+typedef void (*t_bandFunc)(int start, int end, int band, void* arg);
+
+void threadpool_setThreadCount(int count);
+int threadpool_getThreadCount(void);
+int threadpool_bandCount(int count, int itemWork);
+int threadpool_run(int count, int itemWork, t_bandFunc func, void* arg);
+int threadpool_runBands(int count, int bands, t_bandFunc func, void* arg);
+void threadpool_shutdown(void);
+
+#endif // THREADPOOL_H